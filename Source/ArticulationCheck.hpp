@@ -0,0 +1,200 @@
+#pragma once
+
+#include "Bitboard.hpp"
+#include "Direction.hpp"
+#include "RoomBitboard.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Dead-end check shared by the solvers: a depth-first traversal over the open
+ * cells of a room, i.e. the cells that can still be walked through, that finds
+ * their articulation points.
+ *
+ * A non-ice cell becomes visited once the player walks through it, so the part of
+ * the room hanging off a non-ice articulation point can be entered but never left
+ * again. Such a part must then contain the goal, if it has any cells that must
+ * still be visited. The player's own cell is left only once, unless it is ice or
+ * not visited yet, so at most one of its branches may hold such cells.
+ */
+class ArticulationCheck
+{
+private:
+    /**
+     * Frame of the depth-first traversal over the open cells
+     */
+    struct TraversalFrame
+    {
+        /**
+         * Cell index
+         */
+        int32_t cellIndex;
+
+        /**
+         * Index of the next direction to explore from the cell
+         */
+        int32_t nextDirectionIndex;
+    };
+
+    /**
+     * Stack of the depth-first traversal
+     */
+    std::vector<TraversalFrame> m_traversalStack;
+
+    /**
+     * Order in which each cell was discovered by the traversal
+     */
+    std::vector<int32_t> m_discoveryTimes;
+
+    /**
+     * Earliest discovery time reachable from the traversal subtree of each cell
+     * through at most one back edge
+     */
+    std::vector<int32_t> m_lowLinks;
+
+    /**
+     * Number of cells that must still be visited in the traversal subtree of each cell
+     */
+    std::vector<int32_t> m_subtreeRequiredCounts;
+
+    /**
+     * Whether the traversal subtree of each cell contains the goal
+     */
+    std::vector<uint8_t> m_subtreeHasGoalFlags;
+
+public:
+    /**
+     * @brief Constructor
+     */
+    ArticulationCheck()
+        : m_traversalStack()
+        , m_discoveryTimes()
+        , m_lowLinks()
+        , m_subtreeRequiredCounts()
+        , m_subtreeHasGoalFlags()
+    {
+    }
+
+    /**
+     * @brief Sizes the traversal buffers for a room
+     * @param[in] numCells Number of cells in the room
+     */
+    void Resize(const int32_t& numCells)
+    {
+        m_traversalStack.reserve(numCells);
+        m_discoveryTimes.assign(numCells, 0);
+        m_lowLinks.assign(numCells, 0);
+        m_subtreeRequiredCounts.assign(numCells, 0);
+        m_subtreeHasGoalFlags.assign(numCells, 0);
+    }
+
+    /**
+     * @brief Checks whether every cell that must still be visited can be reached
+     * from the specified position, and no articulation point cuts off some of them
+     * from the goal
+     * @param[in] board Room bitboard
+     * @param[in] openMask Mask of the cells that can still be walked through, locked
+     * doors included
+     * @param[in] requiredMask Mask of the cells that must still be visited, the goal included
+     * @param[in] cellIndex Cell index of the player's position
+     * @return Returns true if the required cells might still be visited. Returns false
+     * if the current search branch is a dead end
+     */
+    template <size_t NumWords>
+    bool CanVisitRequiredCells(
+        const RoomBitboard<NumWords>& board,
+        const Bitboard<NumWords>& openMask,
+        const Bitboard<NumWords>& requiredMask,
+        const int32_t& cellIndex)
+    {
+        int32_t goalIndex = board.GetGoalIndex();
+        Bitboard<NumWords> discoveredMask;
+        discoveredMask.Set(cellIndex);
+        int32_t nextDiscoveryTime = 0;
+        m_discoveryTimes[cellIndex] = nextDiscoveryTime;
+        m_lowLinks[cellIndex] = nextDiscoveryTime;
+        m_subtreeRequiredCounts[cellIndex] = 0;
+        m_subtreeHasGoalFlags[cellIndex] = 0;
+        ++nextDiscoveryTime;
+
+        m_traversalStack.clear();
+        m_traversalStack.push_back({ cellIndex, 0 });
+
+        // Ice is never visited, and neither is a start that is not a floor until the
+        // player steps back on it, so the player can come back to such a cell
+        bool canReenterRoot = openMask.Test(cellIndex);
+        int32_t numRootBranches = 0;
+        while (!m_traversalStack.empty())
+        {
+            TraversalFrame &frame = m_traversalStack.back();
+            int32_t currentIndex = frame.cellIndex;
+            if (frame.nextDirectionIndex < static_cast<int32_t>(ALL_DIRECTIONS.size()))
+            {
+                Direction direction = ALL_DIRECTIONS[frame.nextDirectionIndex];
+                ++frame.nextDirectionIndex;
+                if (!board.HasNeighbor(currentIndex, direction))
+                {
+                    continue;
+                }
+
+                int32_t neighborIndex = board.GetNeighborIndex(currentIndex, direction);
+                if (discoveredMask.Test(neighborIndex))
+                {
+                    m_lowLinks[currentIndex] = std::min(m_lowLinks[currentIndex], m_discoveryTimes[neighborIndex]);
+                    continue;
+                }
+                if (!openMask.Test(neighborIndex))
+                {
+                    continue;
+                }
+
+                discoveredMask.Set(neighborIndex);
+                m_discoveryTimes[neighborIndex] = nextDiscoveryTime;
+                m_lowLinks[neighborIndex] = nextDiscoveryTime;
+                m_subtreeRequiredCounts[neighborIndex] = requiredMask.Test(neighborIndex) ? 1 : 0;
+                m_subtreeHasGoalFlags[neighborIndex] = (neighborIndex == goalIndex) ? 1 : 0;
+                ++nextDiscoveryTime;
+
+                m_traversalStack.push_back({ neighborIndex, 0 });
+                continue;
+            }
+
+            m_traversalStack.pop_back();
+            if (m_traversalStack.empty())
+            {
+                break;
+            }
+
+            int32_t parentIndex = m_traversalStack.back().cellIndex;
+            m_lowLinks[parentIndex] = std::min(m_lowLinks[parentIndex], m_lowLinks[currentIndex]);
+            m_subtreeRequiredCounts[parentIndex] += m_subtreeRequiredCounts[currentIndex];
+            m_subtreeHasGoalFlags[parentIndex] |= m_subtreeHasGoalFlags[currentIndex];
+
+            if ((m_subtreeRequiredCounts[currentIndex] == 0) || (m_lowLinks[currentIndex] < m_discoveryTimes[parentIndex]))
+            {
+                continue;
+            }
+
+            if (parentIndex == cellIndex)
+            {
+                // The player leaves a visited cell only once
+                ++numRootBranches;
+                if (!canReenterRoot && (numRootBranches > 1))
+                {
+                    return false;
+                }
+            }
+            else if (!board.GetIceMask().Test(parentIndex)
+                && (m_subtreeHasGoalFlags[currentIndex] == 0))
+            {
+                return false;
+            }
+        }
+
+        int32_t numRequiredCells = m_subtreeRequiredCounts[cellIndex] + (requiredMask.Test(cellIndex) ? 1 : 0);
+        return numRequiredCells == requiredMask.Count();
+    }
+};
@@ -0,0 +1,277 @@
+#include "BacktrackingRoomSolver.hpp"
+
+#include <algorithm>
+#include <array>
+
+/**
+ * @brief Constructor
+ */
+BacktrackingRoomSolver::BacktrackingRoomSolver()
+    : m_moves()
+    , m_iceStops()
+    , m_numNodesExpanded(0)
+    , m_numPrunedMoves(0)
+    , m_numConnectivityChecks(0)
+    , m_maxNodes(0)
+    , m_hasHitNodeLimit(false)
+    , m_transpositionTable()
+    , m_stateHash(0)
+{
+    m_transpositionTable.SetSize(TranspositionTable::DEFAULT_SIZE);
+}
+
+/**
+ * @brief Destructor
+ */
+BacktrackingRoomSolver::~BacktrackingRoomSolver()
+{
+}
+
+/**
+ * @brief Sets the maximum number of search nodes to expand before giving up
+ * @param[in] maxNodes Maximum number of search nodes. 0 means no limit
+ */
+void BacktrackingRoomSolver::SetMaxNodes(const uint64_t& maxNodes)
+{
+    m_maxNodes = maxNodes;
+}
+
+/**
+ * @brief Sets the memory budget of the transposition table, which remembers the
+ * room states proven to be dead ends so the search never explores them twice
+ * @param[in] numBytes Memory budget in bytes. 0 to disable the transposition table
+ */
+void BacktrackingRoomSolver::SetTranspositionTableSize(const size_t& numBytes)
+{
+    m_transpositionTable.SetSize(numBytes);
+}
+
+/**
+ * @brief Gets the transposition table, including its statistics for the last call to Solve()
+ * @return Transposition table
+ */
+const TranspositionTable& BacktrackingRoomSolver::GetTranspositionTable() const
+{
+    return m_transpositionTable;
+}
+
+/**
+ * @brief Searches for a sequence of moves that solves the specified room
+ * @param[in] roomData Room data
+ * @param[out] moves Sequence of moves that solves the room
+ * @return Returns true if a solution was found. Returns false otherwise
+ */
+bool BacktrackingRoomSolver::Solve(const RoomData& roomData, std::vector<Direction>& moves)
+{
+    moves.clear();
+    m_numNodesExpanded = 0;
+    m_numPrunedMoves = 0;
+    m_numConnectivityChecks = 0;
+    m_hasHitNodeLimit = false;
+    m_transpositionTable.Clear();
+
+    return DispatchToBitboard(roomData.cells.GetWidth(), roomData.cells.GetHeight(), [&](auto numWords)
+    {
+        return SolveWithBitboard<decltype(numWords)::value>(roomData, moves);
+    });
+}
+
+/**
+ * @brief Gets the number of search nodes expanded by the last call to Solve()
+ * @return Number of search nodes expanded
+ */
+uint64_t BacktrackingRoomSolver::GetNumNodesExpanded() const
+{
+    return m_numNodesExpanded;
+}
+
+/**
+ * @brief Gets the number of moves cut off by the connectivity tracker in the last call to Solve()
+ * @return Number of pruned moves
+ */
+uint64_t BacktrackingRoomSolver::GetNumPrunedMoves() const
+{
+    return m_numPrunedMoves;
+}
+
+/**
+ * @brief Gets the number of times connectivity had to be recomputed in the last call to Solve()
+ * @return Number of connectivity checks
+ */
+uint64_t BacktrackingRoomSolver::GetNumConnectivityChecks() const
+{
+    return m_numConnectivityChecks;
+}
+
+/**
+ * @brief Queries whether the last call to Solve() gave up due to the node limit
+ * @return Returns true if the search gave up before exhausting all possibilities
+ */
+bool BacktrackingRoomSolver::HasHitNodeLimit() const
+{
+    return m_hasHitNodeLimit;
+}
+
+/**
+ * @brief Searches for a solution using a bitboard with the specified number of words
+ * @param[in] roomData Room data
+ * @param[out] moves Sequence of moves that solves the room
+ * @return Returns true if a solution was found. Returns false otherwise
+ */
+template <size_t NumWords>
+bool BacktrackingRoomSolver::SolveWithBitboard(const RoomData& roomData, std::vector<Direction>& moves)
+{
+    RoomBitboard<NumWords> board;
+    if (!board.Build(roomData) || (board.GetGoalIndex() == -1))
+    {
+        return false;
+    }
+
+    m_stateHash = board.ComputeStateHash();
+
+    ConnectivityTracker<NumWords> tracker;
+    tracker.Build(board);
+    bool isSolved = false;
+    if (tracker.CanReachRequiredCells(board, board.GetStartIndex()))
+    {
+        m_moves.clear();
+        m_iceStops.clear();
+        if (board.GetIceMask().Test(board.GetStartIndex()))
+        {
+            m_iceStops.push_back(board.GetStartIndex());
+        }
+
+        isSolved = Search(board, tracker, board.GetStartIndex(), 0);
+        if (isSolved)
+        {
+            moves = m_moves;
+        }
+    }
+    m_numConnectivityChecks = tracker.GetNumConnectivityChecks();
+
+    return isSolved;
+}
+
+/**
+ * @brief Recursively searches for a solution from the specified position
+ * @param[in,out] board Room bitboard
+ * @param[in,out] tracker Connectivity tracker, in sync with the bitboard
+ * @param[in] cellIndex Cell index of the player's position
+ * @param[in] firstIceStopIndex Index of the first ice stop made since the room state last changed
+ * @return Returns true if a solution was found. Returns false otherwise
+ */
+template <size_t NumWords>
+bool BacktrackingRoomSolver::Search(
+    RoomBitboard<NumWords>& board,
+    ConnectivityTracker<NumWords>& tracker,
+    const int32_t& cellIndex,
+    const size_t& firstIceStopIndex)
+{
+    ++m_numNodesExpanded;
+    if ((m_maxNodes != 0) && (m_numNodesExpanded > m_maxNodes))
+    {
+        m_hasHitNodeLimit = true;
+        return false;
+    }
+
+    // Different move orders often lead to the same room state, which only needs to be searched once
+    uint64_t hash = m_stateHash ^ ZobristKeys::GetPositionKey(cellIndex);
+    if (m_transpositionTable.Contains(hash))
+    {
+        return false;
+    }
+
+    uint64_t firstNodeIndex = m_numNodesExpanded;
+
+    // Warnsdorff's rule: try the cells with the fewest ways out first
+    std::array<Direction, 4> directions = ALL_DIRECTIONS;
+    std::array<int32_t, 4> numOnwardSteps {};
+    for (Direction direction : ALL_DIRECTIONS)
+    {
+        int32_t newCellIndex = cellIndex;
+        RoomMoveRecord record;
+        size_t directionIndex = static_cast<size_t>(direction);
+        numOnwardSteps[directionIndex] = board.ApplyMove(newCellIndex, direction, record) ? board.CountOnwardSteps(newCellIndex) : 0;
+        board.UndoMove(record);
+    }
+    std::stable_sort(
+        directions.begin(),
+        directions.end(),
+        [&numOnwardSteps](const Direction& a, const Direction& b)
+        {
+            return numOnwardSteps[static_cast<size_t>(a)] < numOnwardSteps[static_cast<size_t>(b)];
+        });
+
+    for (Direction direction : directions)
+    {
+        int32_t newCellIndex = cellIndex;
+        RoomMoveRecord record;
+        if (!board.ApplyMove(newCellIndex, direction, record))
+        {
+            continue;
+        }
+
+        if (record.hasReachedGoal)
+        {
+            m_moves.push_back(direction);
+            board.UndoMove(record);
+            return true;
+        }
+
+        // Stopping on ice does not change the room state, unless it unlocks the goal,
+        // so each ice cell only needs to be searched from once until the state changes
+        bool isIceStop = !board.HasChangedRoomState(record);
+        if (isIceStop
+            && (std::find(m_iceStops.begin() + firstIceStopIndex, m_iceStops.end(), newCellIndex) != m_iceStops.end()))
+        {
+            board.UndoMove(record);
+            continue;
+        }
+
+        tracker.ApplyMove(board, record);
+        m_stateHash ^= GetMoveHashKey(record);
+
+        bool isSolved = false;
+        if (tracker.IsDeadEnd(board, cellIndex, newCellIndex, record))
+        {
+            ++m_numPrunedMoves;
+        }
+        else
+        {
+            size_t nextFirstIceStopIndex = m_iceStops.size();
+            if (isIceStop)
+            {
+                nextFirstIceStopIndex = firstIceStopIndex;
+                m_iceStops.push_back(newCellIndex);
+            }
+
+            m_moves.push_back(direction);
+            isSolved = Search(board, tracker, newCellIndex, nextFirstIceStopIndex);
+            if (!isSolved)
+            {
+                m_moves.pop_back();
+            }
+
+            if (!isIceStop)
+            {
+                m_iceStops.resize(nextFirstIceStopIndex);
+            }
+        }
+
+        m_stateHash ^= GetMoveHashKey(record);
+        tracker.UndoMove(board, record);
+        board.UndoMove(record);
+        if (isSolved || m_hasHitNodeLimit)
+        {
+            return isSolved;
+        }
+    }
+
+    // Only a fully searched room state is known to be a dead end. Ice cells skipped
+    // above are still being searched further up the current branch, so they do not
+    // make this room state any less dead.
+    m_transpositionTable.Store(hash, m_numNodesExpanded - firstNodeIndex);
+
+    return false;
+}
+
@@ -0,0 +1,169 @@
+#pragma once
+
+#include "ConnectivityTracker.hpp"
+#include "Direction.hpp"
+#include "LevelData.hpp"
+#include "RoomBitboard.hpp"
+#include "TranspositionTable.hpp"
+#include "ZobristKeys.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Headless solver that tries every move in turn, one move at a time, and backs
+ * out of a branch as soon as the connectivity tracker shows that the room can no
+ * longer be completed. Unlike RoomSolver, it does not group the ice slides that
+ * leave the room state unchanged together, so every single move is a search node.
+ * Room states proven to be dead ends are remembered in a transposition table, since
+ * different move orders often lead to the same room state.
+ */
+class BacktrackingRoomSolver
+{
+public:
+    /**
+     * Maximum number of cells in a room the solver can handle
+     */
+    static constexpr int32_t MAX_CELLS = RoomBitboard<16>::MAX_CELLS;
+
+    static_assert(MAX_CELLS <= ZobristKeys::MAX_CELLS, "Every cell must have its own Zobrist keys");
+
+private:
+    /**
+     * Moves made so far in the current search branch
+     */
+    std::vector<Direction> m_moves;
+
+    /**
+     * Ice cells stopped on since the room state last changed. Stopping on the same
+     * ice cell again without changing the room state would either loop forever or
+     * search the same room state twice.
+     */
+    std::vector<int32_t> m_iceStops;
+
+    /**
+     * Number of search nodes expanded by the last call to Solve()
+     */
+    uint64_t m_numNodesExpanded;
+
+    /**
+     * Number of moves cut off by the connectivity tracker in the last call to Solve()
+     */
+    uint64_t m_numPrunedMoves;
+
+    /**
+     * Number of times the connectivity tracker had to recompute connectivity in the last call to Solve()
+     */
+    uint64_t m_numConnectivityChecks;
+
+    /**
+     * Maximum number of search nodes to expand before giving up. 0 means no limit
+     */
+    uint64_t m_maxNodes;
+
+    /**
+     * Flag indicating whether the last search gave up due to the node limit
+     */
+    bool m_hasHitNodeLimit;
+
+    /**
+     * Room states proven to be dead ends
+     */
+    TranspositionTable m_transpositionTable;
+
+    /**
+     * Zobrist hash of the visited cells and unlocked doors in the current search branch
+     */
+    uint64_t m_stateHash;
+
+public:
+    /**
+     * @brief Constructor
+     */
+    BacktrackingRoomSolver();
+
+    /**
+     * @brief Destructor
+     */
+    ~BacktrackingRoomSolver();
+
+    /**
+     * @brief Sets the maximum number of search nodes to expand before giving up
+     * @param[in] maxNodes Maximum number of search nodes. 0 means no limit
+     */
+    void SetMaxNodes(const uint64_t& maxNodes);
+
+    /**
+     * @brief Sets the memory budget of the transposition table, which remembers the
+     * room states proven to be dead ends so the search never explores them twice
+     * @param[in] numBytes Memory budget in bytes. 0 to disable the transposition table
+     */
+    void SetTranspositionTableSize(const size_t& numBytes);
+
+    /**
+     * @brief Gets the transposition table, including its statistics for the last call to Solve()
+     * @return Transposition table
+     */
+    const TranspositionTable& GetTranspositionTable() const;
+
+    /**
+     * @brief Searches for a sequence of moves that solves the specified room
+     * @param[in] roomData Room data
+     * @param[out] moves Sequence of moves that solves the room
+     * @return Returns true if a solution was found. Returns false otherwise
+     */
+    bool Solve(const RoomData& roomData, std::vector<Direction>& moves);
+
+    /**
+     * @brief Gets the number of search nodes expanded by the last call to Solve()
+     * @return Number of search nodes expanded
+     */
+    uint64_t GetNumNodesExpanded() const;
+
+    /**
+     * @brief Gets the number of moves cut off by the connectivity tracker in the last call to Solve()
+     * @return Number of pruned moves
+     */
+    uint64_t GetNumPrunedMoves() const;
+
+    /**
+     * @brief Gets the number of times connectivity had to be recomputed in the last call to Solve()
+     * @return Number of connectivity checks
+     */
+    uint64_t GetNumConnectivityChecks() const;
+
+    /**
+     * @brief Queries whether the last call to Solve() gave up due to the node limit
+     * @return Returns true if the search gave up before exhausting all possibilities
+     */
+    bool HasHitNodeLimit() const;
+
+private:
+    /**
+     * @brief Searches for a solution using a bitboard with the specified number of words
+     * @param[in] roomData Room data
+     * @param[out] moves Sequence of moves that solves the room
+     * @return Returns true if a solution was found. Returns false otherwise
+     */
+    template <size_t NumWords>
+    bool SolveWithBitboard(const RoomData& roomData, std::vector<Direction>& moves);
+
+    /**
+     * @brief Recursively searches for a solution from the specified position
+     * @param[in,out] board Room bitboard
+     * @param[in,out] tracker Connectivity tracker, in sync with the bitboard
+     * @param[in] cellIndex Cell index of the player's position
+     * @param[in] firstIceStopIndex Index of the first ice stop made since the room state last changed
+     * @return Returns true if a solution was found. Returns false otherwise
+     */
+    template <size_t NumWords>
+    bool Search(
+        RoomBitboard<NumWords>& board,
+        ConnectivityTracker<NumWords>& tracker,
+        const int32_t& cellIndex,
+        const size_t& firstIceStopIndex);
+
+
+
+};
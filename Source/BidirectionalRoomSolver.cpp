@@ -0,0 +1,941 @@
+#include "BidirectionalRoomSolver.hpp"
+
+#include <algorithm>
+#include <array>
+#include <iterator>
+
+#define MAX_STORED_HALVES (1 << 16)
+#define FIRST_ROUND_NODES (1 << 16)
+
+/**
+ * @brief Constructor
+ */
+BidirectionalRoomSolver::BidirectionalRoomSolver()
+    : m_moves()
+    , m_closureEntries()
+    , m_successors()
+    , m_cellMarks()
+    , m_currentMark(0)
+    , m_iceStops()
+    , m_compatibleKeyIndices()
+    , m_predecessorOffsets()
+    , m_predecessors()
+    , m_doorSwitchIndices()
+    , m_numMeetingFloors(0)
+    , m_numFloors(0)
+    , m_isStateKnown(false)
+    , m_hasHitStoreLimit(false)
+    , m_numStoredHalves(0)
+    , m_numJoinsChecked(0)
+    , m_numNodesExpanded(0)
+    , m_maxNodes(0)
+    , m_hasHitNodeLimit(false)
+    , m_roundNodeLimit(0)
+    , m_hasHitRoundLimit(false)
+    , m_transpositionTable()
+    , m_stateHash(0)
+    , m_articulationCheck()
+{
+    m_transpositionTable.SetSize(TranspositionTable::DEFAULT_SIZE);
+}
+
+/**
+ * @brief Destructor
+ */
+BidirectionalRoomSolver::~BidirectionalRoomSolver()
+{
+}
+
+/**
+ * @brief Sets the maximum number of search nodes to expand before giving up
+ * @param[in] maxNodes Maximum number of search nodes. 0 means no limit
+ */
+void BidirectionalRoomSolver::SetMaxNodes(const uint64_t& maxNodes)
+{
+    m_maxNodes = maxNodes;
+}
+
+/**
+ * @brief Searches for a sequence of moves that solves the specified room. The
+ * search is exhaustive, so a room is unsolvable if no solution is found and the
+ * node limit was not hit.
+ * @param[in] roomData Room data
+ * @param[out] moves Sequence of moves that solves the room
+ * @return Returns true if a solution was found. Returns false otherwise
+ */
+bool BidirectionalRoomSolver::Solve(const RoomData& roomData, std::vector<Direction>& moves)
+{
+    moves.clear();
+    m_numMeetingFloors = 0;
+    m_numStoredHalves = 0;
+    m_numJoinsChecked = 0;
+    m_numNodesExpanded = 0;
+    m_hasHitNodeLimit = false;
+
+    return DispatchToBitboard(roomData.cells.GetWidth(), roomData.cells.GetHeight(), [&](auto numWords)
+    {
+        return SolveWithBitboard<decltype(numWords)::value>(roomData, moves);
+    });
+}
+
+/**
+ * @brief Gets the number of search nodes expanded by the last call to Solve()
+ * @return Number of search nodes expanded
+ */
+uint64_t BidirectionalRoomSolver::GetNumNodesExpanded() const
+{
+    return m_numNodesExpanded;
+}
+
+/**
+ * @brief Gets the number of floors the first half of a solution visits in the
+ * last round of the last call to Solve(), including the start and the meeting floor
+ * @return Number of floors. 0 if the forward search went all the way to the goal
+ */
+int32_t BidirectionalRoomSolver::GetNumMeetingFloors() const
+{
+    return m_numMeetingFloors;
+}
+
+/**
+ * @brief Gets the number of second halves the last round of the last call to
+ * Solve() was joined with
+ * @return Number of stored halves
+ */
+uint64_t BidirectionalRoomSolver::GetNumStoredHalves() const
+{
+    return m_numStoredHalves;
+}
+
+/**
+ * @brief Gets the number of joined solutions replayed by the last call to Solve()
+ * @return Number of joins checked
+ */
+uint64_t BidirectionalRoomSolver::GetNumJoinsChecked() const
+{
+    return m_numJoinsChecked;
+}
+
+/**
+ * @brief Queries whether the last call to Solve() gave up due to the node limit
+ * @return Returns true if the search gave up before exhausting all possibilities
+ */
+bool BidirectionalRoomSolver::HasHitNodeLimit() const
+{
+    return m_hasHitNodeLimit;
+}
+
+/**
+ * @brief Searches for a solution using a bitboard with the specified number of words
+ * @param[in] roomData Room data
+ * @param[out] moves Sequence of moves that solves the room
+ * @return Returns true if a solution was found. Returns false otherwise
+ */
+template <size_t NumWords>
+bool BidirectionalRoomSolver::SolveWithBitboard(const RoomData& roomData, std::vector<Direction>& moves)
+{
+    RoomBitboard<NumWords> board;
+    if (!board.Build(roomData) || (board.GetGoalIndex() == -1))
+    {
+        return false;
+    }
+
+    ConnectivityTracker<NumWords> tracker;
+    tracker.Build(board);
+    if (!tracker.CanReachRequiredCells(board, board.GetStartIndex()))
+    {
+        return false;
+    }
+
+    BuildPredecessors(roomData, board);
+    m_articulationCheck.Resize(board.GetNumCells());
+    m_cellMarks.assign(board.GetNumCells(), 0);
+    m_currentMark = 0;
+
+    m_numFloors = board.GetFloorMask().Count();
+    Bitboard<NumWords> emptyMask = board.GetRoomMask()
+        & ~(board.GetFloorMask() | board.GetWallMask() | board.GetIceMask() | board.GetSwitchMask() | board.GetDoorMask());
+    emptyMask.Reset(board.GetGoalIndex());
+    m_isStateKnown = emptyMask.IsEmpty() && board.GetSwitchMask().IsEmpty() && board.GetDoorMask().IsEmpty();
+
+    // Start with a plain forward search to the goal, which solves most rooms
+    // quickly. Each time a round of it runs out of its node budget, store the
+    // second halves one floor deeper within the same budget, moving the meeting
+    // floor towards the start, and double the budget. Dead ends found by one
+    // round are dead ends for every meeting floor, so the transposition table is
+    // kept across rounds
+    m_transpositionTable.Clear();
+    MeetingTable<NumWords> table;
+    int32_t numBackwardFloors = 0;
+    bool canMoveMeetingFloor = (m_numFloors > 0);
+    uint64_t roundNodes = FIRST_ROUND_NODES;
+    while (true)
+    {
+        // The halves of both sides together visit every floor, and the meeting floor twice
+        m_numMeetingFloors = (numBackwardFloors == 0) ? 0 : (m_numFloors + 1 - numBackwardFloors);
+        m_numStoredHalves = table.halves.size();
+        m_numJoinsChecked = 0;
+        m_roundNodeLimit = canMoveMeetingFloor ? (m_numNodesExpanded + roundNodes) : 0;
+        m_hasHitRoundLimit = false;
+        PrepareForwardSearch(board);
+        ResetCompatibleKeys(table, board.GetVisitedMask() & board.GetFloorMask());
+
+        int32_t numStartFloors = board.GetFloorMask().Test(board.GetStartIndex()) ? 1 : 0;
+        if (SearchForward(board, table, board.GetStartIndex(), numStartFloors, 0, moves))
+        {
+            return true;
+        }
+
+        // A round that was not cut short searched every first half
+        if (!m_hasHitRoundLimit)
+        {
+            return false;
+        }
+
+        // A table that no longer fits keeps the current meeting floor for good,
+        // while one cut short by the budget is retried with the next budget
+        MeetingTable<NumWords> grownTable;
+        m_roundNodeLimit = m_numNodesExpanded + roundNodes;
+        m_hasHitRoundLimit = false;
+        if (StoreBackwardHalves(board, grownTable, numBackwardFloors + 1))
+        {
+            table = std::move(grownTable);
+            ++numBackwardFloors;
+            canMoveMeetingFloor = (numBackwardFloors < m_numFloors);
+
+            // No second half reaches the start
+            if (table.halves.empty())
+            {
+                m_numMeetingFloors = m_numFloors + 1 - numBackwardFloors;
+                m_numStoredHalves = 0;
+                return false;
+            }
+        }
+        else if (m_hasHitNodeLimit)
+        {
+            return false;
+        }
+        else if (m_hasHitStoreLimit)
+        {
+            canMoveMeetingFloor = false;
+        }
+
+        roundNodes *= 2;
+    }
+}
+
+/**
+ * @brief Builds the table of reverse slides of every cell, and the switch of every door
+ * @param[in] roomData Room data
+ * @param[in] board Room bitboard
+ */
+template <size_t NumWords>
+void BidirectionalRoomSolver::BuildPredecessors(const RoomData& roomData, const RoomBitboard<NumWords>& board)
+{
+    m_doorSwitchIndices.assign(board.GetNumCells(), -1);
+    for (const SwitchDoorMapping &mapping : roomData.switchDoorMappings)
+    {
+        if ((mapping.switchId != -1) && (mapping.switchX != -1) && (mapping.doorX != -1))
+        {
+            m_doorSwitchIndices[mapping.doorY * board.GetWidth() + mapping.doorX] = mapping.switchY * board.GetWidth() + mapping.switchX;
+        }
+    }
+
+    m_predecessorOffsets.clear();
+    m_predecessors.clear();
+    for (int32_t cellIndex = 0; cellIndex < board.GetNumCells(); ++cellIndex)
+    {
+        for (Direction direction : ALL_DIRECTIONS)
+        {
+            m_predecessorOffsets.push_back(static_cast<int32_t>(m_predecessors.size()));
+            if (board.GetWallMask().Test(cellIndex))
+            {
+                continue;
+            }
+
+            // Slides never stop on ice in front of more ice or the goal
+            if (board.GetIceMask().Test(cellIndex) && board.HasNeighbor(cellIndex, direction))
+            {
+                int32_t nextIndex = board.GetNeighborIndex(cellIndex, direction);
+                if (board.GetIceMask().Test(nextIndex) || (nextIndex == board.GetGoalIndex()))
+                {
+                    continue;
+                }
+            }
+
+            // A move in this direction ending here started on the first cell behind
+            // this one that is not ice, or stopped on any ice cell in between
+            Direction reverseDirection = direction;
+            for (Direction candidate : ALL_DIRECTIONS)
+            {
+                if ((GetDirectionX(candidate) == -GetDirectionX(direction)) && (GetDirectionY(candidate) == -GetDirectionY(direction)))
+                {
+                    reverseDirection = candidate;
+                }
+            }
+
+            int32_t previousIndex = cellIndex;
+            while (board.HasNeighbor(previousIndex, reverseDirection))
+            {
+                previousIndex = board.GetNeighborIndex(previousIndex, reverseDirection);
+                if (board.GetWallMask().Test(previousIndex))
+                {
+                    break;
+                }
+
+                m_predecessors.push_back(previousIndex);
+                if (!board.GetIceMask().Test(previousIndex))
+                {
+                    break;
+                }
+            }
+        }
+    }
+    m_predecessorOffsets.push_back(static_cast<int32_t>(m_predecessors.size()));
+}
+
+/**
+ * @brief Prepares the forward search to start from the start of the room
+ * @param[in,out] board Room bitboard, reset to its initial state
+ */
+template <size_t NumWords>
+void BidirectionalRoomSolver::PrepareForwardSearch(RoomBitboard<NumWords>& board)
+{
+    board.Reset();
+    m_moves.clear();
+    m_closureEntries.clear();
+    m_successors.clear();
+    m_stateHash = board.ComputeStateHash();
+}
+
+/**
+ * @brief Stores every second half of the solutions that enters the specified
+ * number of floors in a meeting table
+ * @param[in,out] board Room bitboard, in its initial state
+ * @param[out] table Meeting table
+ * @param[in] numMeetingFloors Number of floors each second half enters, including the meeting floor
+ * @return Returns true if every second half was stored. Returns false if they do
+ * not fit in the table, or a node limit was hit
+ */
+template <size_t NumWords>
+bool BidirectionalRoomSolver::StoreBackwardHalves(RoomBitboard<NumWords>& board, MeetingTable<NumWords>& table, const int32_t& numMeetingFloors)
+{
+    m_hasHitStoreLimit = false;
+    m_numMeetingFloors = m_numFloors + 1 - numMeetingFloors;
+    m_moves.clear();
+    m_iceStops.clear();
+
+    Bitboard<NumWords> visitedMask;
+    visitedMask.Set(board.GetGoalIndex());
+    SearchBackward(board, table, board.GetGoalIndex(), visitedMask, 0, 0);
+    board.Reset();
+
+    return !m_hasHitStoreLimit && !m_hasHitNodeLimit && !m_hasHitRoundLimit;
+}
+
+/**
+ * @brief Lists the keys of the stored halves that a half with the specified
+ * floors visited can still be joined with, as the first compatible keys
+ * @param[in] table Meeting table
+ * @param[in] visitedFloorMask Floors the half has visited so far
+ */
+template <size_t NumWords>
+void BidirectionalRoomSolver::ResetCompatibleKeys(const MeetingTable<NumWords>& table, const Bitboard<NumWords>& visitedFloorMask)
+{
+    m_compatibleKeyIndices.clear();
+    for (size_t i = 0; i < table.keys.size(); ++i)
+    {
+        if ((table.keys[i].visitedFloorMask & visitedFloorMask).IsEmpty())
+        {
+            m_compatibleKeyIndices.push_back(static_cast<int32_t>(i));
+        }
+    }
+}
+
+/**
+ * @brief Keeps the compatible keys of the current level that leave the specified
+ * floor to the half searching, appending them as the keys of the next level
+ * @param[in] table Meeting table
+ * @param[in] firstKeyIndex Index of the first key of the current level in m_compatibleKeyIndices
+ * @param[in] lastKeyIndex Index past the last key of the current level in m_compatibleKeyIndices
+ * @param[in] floorIndex Cell index of the floor entered
+ * @return Index of the first key of the next level in m_compatibleKeyIndices
+ */
+template <size_t NumWords>
+size_t BidirectionalRoomSolver::FilterCompatibleKeys(
+    const MeetingTable<NumWords>& table,
+    const size_t& firstKeyIndex,
+    const size_t& lastKeyIndex,
+    const int32_t& floorIndex)
+{
+    size_t nextFirstKeyIndex = m_compatibleKeyIndices.size();
+    for (size_t i = firstKeyIndex; i < lastKeyIndex; ++i)
+    {
+        int32_t keyIndex = m_compatibleKeyIndices[i];
+        if (!table.keys[keyIndex].visitedFloorMask.Test(floorIndex))
+        {
+            m_compatibleKeyIndices.push_back(keyIndex);
+        }
+    }
+
+    return nextFirstKeyIndex;
+}
+
+/**
+ * @brief Recursively searches forward from the specified position, and joins
+ * the first halves with the second halves stored in the meeting table, or goes
+ * all the way to the goal if there is no meeting floor. Like RoomSolver, each
+ * search node is a room state, and the moves that only stop on ice are folded
+ * into the moves out of it.
+ * @param[in,out] board Room bitboard
+ * @param[in] table Meeting table
+ * @param[in] cellIndex Cell index of the player's position
+ * @param[in] numVisitedFloors Number of floors visited so far
+ * @param[in] firstKeyIndex Index of the first meeting key in m_compatibleKeyIndices
+ * that the first half can still be joined with
+ * @param[out] moves Joined solution, if one was found
+ * @return Returns true if a solution was found. Returns false otherwise
+ */
+template <size_t NumWords>
+bool BidirectionalRoomSolver::SearchForward(
+    RoomBitboard<NumWords>& board,
+    const MeetingTable<NumWords>& table,
+    const int32_t& cellIndex,
+    const int32_t& numVisitedFloors,
+    const size_t& firstKeyIndex,
+    std::vector<Direction>& moves)
+{
+    if (!ExpandNode())
+    {
+        return false;
+    }
+
+    if ((m_numMeetingFloors > 0) && (numVisitedFloors == m_numMeetingFloors))
+    {
+        // The second half visits every floor the first half has not, and the meeting floor
+        MeetingKey<NumWords> key { board.GetFloorMask() & ~board.GetVisitedMask(), cellIndex };
+        key.visitedFloorMask.Set(cellIndex);
+        return Join(board, table, key, board.GetVisitedMask() & ~board.GetFloorMask(), moves);
+    }
+
+    // Different move orders often lead to the same room state, which only needs to be searched once
+    uint64_t hash = m_stateHash ^ ZobristKeys::GetPositionKey(cellIndex);
+    if (m_transpositionTable.Contains(hash))
+    {
+        return false;
+    }
+
+    if (!CanVisitRemainingCells(board, cellIndex))
+    {
+        return false;
+    }
+
+    uint64_t firstNodeIndex = m_numNodesExpanded;
+    size_t firstEntryIndex = m_closureEntries.size();
+    size_t firstSuccessorIndex = m_successors.size();
+    size_t lastKeyIndex = m_compatibleKeyIndices.size();
+
+    bool isSolved = GatherSuccessors(board, cellIndex);
+    if (isSolved)
+    {
+        moves = m_moves;
+    }
+
+    for (size_t i = firstSuccessorIndex; (i < m_successors.size()) && !isSolved && !m_hasHitNodeLimit && !m_hasHitRoundLimit; ++i)
+    {
+        Successor successor = m_successors[i];
+        int32_t newCellIndex = m_closureEntries[successor.entryIndex].cellIndex;
+        RoomMoveRecord record;
+        board.ApplyMove(newCellIndex, successor.direction, record);
+
+        bool isFloor = (record.visitedCellIndex != -1) && board.GetFloorMask().Test(record.visitedCellIndex);
+        int32_t newNumVisitedFloors = numVisitedFloors + (isFloor ? 1 : 0);
+
+        // Keep the second halves that leave this floor to the first half
+        size_t nextFirstKeyIndex = firstKeyIndex;
+        if (isFloor && (newNumVisitedFloors < m_numMeetingFloors))
+        {
+            nextFirstKeyIndex = FilterCompatibleKeys(table, firstKeyIndex, lastKeyIndex, newCellIndex);
+        }
+
+        if ((m_numMeetingFloors == 0) || !isFloor || (newNumVisitedFloors == m_numMeetingFloors)
+            || (nextFirstKeyIndex < m_compatibleKeyIndices.size()))
+        {
+            m_stateHash ^= GetMoveHashKey(record);
+            int32_t numPushedMoves = PushPathToEntry(successor.entryIndex);
+            m_moves.push_back(successor.direction);
+
+            isSolved = SearchForward(board, table, newCellIndex, newNumVisitedFloors, nextFirstKeyIndex, moves);
+            m_moves.resize(m_moves.size() - numPushedMoves - 1);
+            m_stateHash ^= GetMoveHashKey(record);
+        }
+
+        m_compatibleKeyIndices.resize(lastKeyIndex);
+        board.UndoMove(record);
+    }
+
+    m_closureEntries.resize(firstEntryIndex);
+    m_successors.resize(firstSuccessorIndex);
+
+    // Only a fully searched room state is known to be a dead end
+    if (!isSolved && !m_hasHitNodeLimit && !m_hasHitRoundLimit)
+    {
+        m_transpositionTable.Store(hash, m_numNodesExpanded - firstNodeIndex);
+    }
+
+    return isSolved;
+}
+
+/**
+ * @brief Gathers the moves that change the room state from the specified position,
+ * pushing them to the successor stack in the order they should be tried
+ * @param[in,out] board Room bitboard
+ * @param[in] cellIndex Cell index of the player's position
+ * @return Returns true if one of the moves reaches the goal, in which case the moves
+ * leading to the goal are pushed to the current move list. Returns false otherwise
+ */
+template <size_t NumWords>
+bool BidirectionalRoomSolver::GatherSuccessors(RoomBitboard<NumWords>& board, const int32_t& cellIndex)
+{
+    // Gather all positions reachable by only stopping on ice cells, since those
+    // moves do not change the room state. From each of them, gather the moves
+    // that do change the room state.
+    size_t firstEntryIndex = m_closureEntries.size();
+    size_t firstSuccessorIndex = m_successors.size();
+    uint32_t mark = NextMark();
+    m_closureEntries.push_back({ cellIndex, -1, Direction::Up });
+    // A start that is not a floor stays unmarked, since stepping back onto it changes the room state
+    if (board.GetIceMask().Test(cellIndex))
+    {
+        m_cellMarks[cellIndex] = mark;
+    }
+
+    for (size_t i = firstEntryIndex; i < m_closureEntries.size(); ++i)
+    {
+        int32_t entryCellIndex = m_closureEntries[i].cellIndex;
+        for (Direction direction : ALL_DIRECTIONS)
+        {
+            int32_t newCellIndex = entryCellIndex;
+            RoomMoveRecord record;
+            if (!board.ApplyMove(newCellIndex, direction, record))
+            {
+                continue;
+            }
+
+            if (record.hasReachedGoal)
+            {
+                PushPathToEntry(static_cast<int32_t>(i));
+                m_moves.push_back(direction);
+                board.UndoMove(record);
+                return true;
+            }
+
+            if (!board.HasChangedRoomState(record))
+            {
+                if (m_cellMarks[newCellIndex] != mark)
+                {
+                    m_cellMarks[newCellIndex] = mark;
+                    m_closureEntries.push_back({ newCellIndex, static_cast<int32_t>(i), direction });
+                }
+            }
+            else if (m_cellMarks[newCellIndex] != mark)
+            {
+                // Different moves landing on the same cell lead to the same room state
+                m_cellMarks[newCellIndex] = mark;
+                m_successors.push_back({ static_cast<int32_t>(i), direction, board.CountOnwardSteps(newCellIndex) });
+            }
+
+            board.UndoMove(record);
+        }
+    }
+
+    // Warnsdorff's rule: try the cells with the fewest ways out first
+    std::stable_sort(
+        m_successors.begin() + firstSuccessorIndex,
+        m_successors.end(),
+        [](const Successor& a, const Successor& b)
+        {
+            return a.numOnwardSteps < b.numOnwardSteps;
+        });
+
+    return false;
+}
+
+/**
+ * @brief Pushes the moves needed to get to the specified closure entry
+ * @param[in] entryIndex Closure entry index
+ * @return Number of moves pushed
+ */
+int32_t BidirectionalRoomSolver::PushPathToEntry(const int32_t& entryIndex)
+{
+    size_t firstMoveIndex = m_moves.size();
+    int32_t currentEntryIndex = entryIndex;
+    while (m_closureEntries[currentEntryIndex].parentEntryIndex != -1)
+    {
+        m_moves.push_back(m_closureEntries[currentEntryIndex].direction);
+        currentEntryIndex = m_closureEntries[currentEntryIndex].parentEntryIndex;
+    }
+    std::reverse(m_moves.begin() + firstMoveIndex, m_moves.end());
+
+    return static_cast<int32_t>(m_moves.size() - firstMoveIndex);
+}
+
+/**
+ * @brief Gets a fresh mark value, effectively unmarking all cells
+ * @return Mark value
+ */
+uint32_t BidirectionalRoomSolver::NextMark()
+{
+    ++m_currentMark;
+    if (m_currentMark == 0)
+    {
+        std::fill(m_cellMarks.begin(), m_cellMarks.end(), 0);
+        m_currentMark = 1;
+    }
+
+    return m_currentMark;
+}
+
+/**
+ * @brief Checks whether all the unvisited floor cells and the goal can still be
+ * visited from the specified cell, assuming all locked doors can be opened
+ * @param[in] board Room bitboard
+ * @param[in] cellIndex Cell index of the player's position
+ * @return Returns true if the remaining cells might still be visited. Returns false
+ * if the current search branch is a dead end
+ */
+template <size_t NumWords>
+bool BidirectionalRoomSolver::CanVisitRemainingCells(const RoomBitboard<NumWords>& board, const int32_t& cellIndex)
+{
+    int32_t goalIndex = board.GetGoalIndex();
+    if (board.GetVisitedMask().Test(goalIndex))
+    {
+        return false;
+    }
+
+    // Cells that can still be walked through, locked doors included
+    Bitboard<NumWords> openMask = board.GetRoomMask() & ~(board.GetWallMask() | board.GetVisitedMask());
+    // Cells that must still be visited
+    Bitboard<NumWords> requiredMask = board.GetFloorMask() & openMask;
+    requiredMask.Set(goalIndex);
+
+    return m_articulationCheck.CanVisitRequiredCells(board, openMask, requiredMask, cellIndex);
+}
+
+/**
+ * @brief Stores a second half in the meeting table, unless the table already
+ * holds a half that can be swapped for it. The moves of the half are the ones in m_moves
+ * @param[in,out] table Meeting table
+ * @param[in] key Meeting key of the half
+ * @param[in] visitedOtherMask Cells other than floors visited by the half
+ */
+template <size_t NumWords>
+void BidirectionalRoomSolver::StoreHalf(MeetingTable<NumWords>& table, const MeetingKey<NumWords>& key, const Bitboard<NumWords>& visitedOtherMask)
+{
+    // When the room state is known, halves entering the same cells can be swapped
+    // for each other, so only the first one found is kept. Otherwise the order of
+    // the moves can matter
+    auto [it, isNewKey] = table.firstHalfIndices.emplace(key, static_cast<int32_t>(table.halves.size()));
+    int32_t nextHalfIndex = -1;
+    if (!isNewKey)
+    {
+        for (int32_t halfIndex = it->second; m_isStateKnown && (halfIndex != -1); halfIndex = table.halves[halfIndex].nextHalfIndex)
+        {
+            if (table.halves[halfIndex].visitedOtherMask == visitedOtherMask)
+            {
+                return;
+            }
+        }
+        nextHalfIndex = it->second;
+    }
+
+    if (table.halves.size() >= MAX_STORED_HALVES)
+    {
+        if (isNewKey)
+        {
+            table.firstHalfIndices.erase(it);
+        }
+        m_hasHitStoreLimit = true;
+        return;
+    }
+
+    if (isNewKey)
+    {
+        table.keys.push_back(key);
+    }
+    else
+    {
+        it->second = static_cast<int32_t>(table.halves.size());
+    }
+
+    table.halves.push_back({ visitedOtherMask, table.moves.size(), m_moves.size(), nextHalfIndex });
+    table.moves.insert(table.moves.end(), m_moves.begin(), m_moves.end());
+}
+
+/**
+ * @brief Recursively walks back from the specified position towards the start,
+ * and stores the second halves in the meeting table
+ * @param[in,out] board Room bitboard, used to check moves
+ * @param[in,out] table Meeting table
+ * @param[in] cellIndex Cell index of the player's position
+ * @param[in,out] visitedMask Cells other than ice entered between this position and the goal
+ * @param[in] numVisitedFloors Number of floors in visitedMask
+ * @param[in] firstIceStopIndex Index of the first ice stop made since the room state last changed
+ */
+template <size_t NumWords>
+void BidirectionalRoomSolver::SearchBackward(
+    RoomBitboard<NumWords>& board,
+    MeetingTable<NumWords>& table,
+    const int32_t& cellIndex,
+    Bitboard<NumWords>& visitedMask,
+    const int32_t& numVisitedFloors,
+    const size_t& firstIceStopIndex)
+{
+    if (!ExpandNode())
+    {
+        return;
+    }
+
+    bool isOnIce = board.GetIceMask().Test(cellIndex);
+    bool canRememberState = m_isStateKnown && !isOnIce;
+    if (canRememberState && (table.deadEndStates.find({ visitedMask, cellIndex }) != table.deadEndStates.end()))
+    {
+        return;
+    }
+
+    // The second half visits the rest of the floors, plus the meeting floor
+    int32_t numMeetingFloors = m_numFloors - m_numMeetingFloors + 1;
+    for (Direction direction : ALL_DIRECTIONS)
+    {
+        // Stopping on ice needs the next cell to be blocked, so it cannot be a
+        // cell that is only entered later, unless it is a door that was locked
+        if (isOnIce && board.HasNeighbor(cellIndex, direction))
+        {
+            int32_t nextIndex = board.GetNeighborIndex(cellIndex, direction);
+            if (visitedMask.Test(nextIndex) && !board.GetDoorMask().Test(nextIndex))
+            {
+                continue;
+            }
+        }
+
+        size_t offsetIndex = static_cast<size_t>(cellIndex) * 4 + static_cast<size_t>(direction);
+        for (int32_t i = m_predecessorOffsets[offsetIndex]; i < m_predecessorOffsets[offsetIndex + 1]; ++i)
+        {
+            int32_t previousIndex = m_predecessors[i];
+            if (m_isStateKnown && !IsMoveConsistent(board, previousIndex, direction, cellIndex, visitedMask))
+            {
+                continue;
+            }
+
+            if (board.GetIceMask().Test(previousIndex))
+            {
+                if (std::find(m_iceStops.begin() + firstIceStopIndex, m_iceStops.end(), previousIndex) != m_iceStops.end())
+                {
+                    continue;
+                }
+
+                m_iceStops.push_back(previousIndex);
+                m_moves.push_back(direction);
+                SearchBackward(board, table, previousIndex, visitedMask, numVisitedFloors, firstIceStopIndex);
+                m_moves.pop_back();
+                m_iceStops.pop_back();
+            }
+            else
+            {
+                if (visitedMask.Test(previousIndex) || (previousIndex == board.GetGoalIndex()))
+                {
+                    continue;
+                }
+
+                // A door has to be unlocked by a switch entered before it
+                if (board.GetDoorMask().Test(previousIndex)
+                    && ((m_doorSwitchIndices[previousIndex] == -1) || visitedMask.Test(m_doorSwitchIndices[previousIndex])))
+                {
+                    continue;
+                }
+
+                bool isFloor = board.GetFloorMask().Test(previousIndex);
+                int32_t newNumVisitedFloors = numVisitedFloors + (isFloor ? 1 : 0);
+                size_t nextFirstIceStopIndex = m_iceStops.size();
+                visitedMask.Set(previousIndex);
+                m_moves.push_back(direction);
+                // Without the room state, the order of the moves can matter even
+                // if the same cells are entered
+                if (CanReachStart(board, previousIndex, visitedMask))
+                {
+                    if (isFloor && (newNumVisitedFloors == numMeetingFloors))
+                    {
+                        StoreHalf(table, { visitedMask & board.GetFloorMask(), previousIndex }, visitedMask & ~board.GetFloorMask());
+                    }
+                    else
+                    {
+                        SearchBackward(board, table, previousIndex, visitedMask, newNumVisitedFloors, nextFirstIceStopIndex);
+                    }
+                }
+                m_moves.pop_back();
+                visitedMask.Reset(previousIndex);
+            }
+
+            if (m_hasHitNodeLimit || m_hasHitRoundLimit || m_hasHitStoreLimit)
+            {
+                return;
+            }
+        }
+    }
+
+    if (canRememberState)
+    {
+        table.deadEndStates.insert({ visitedMask, cellIndex });
+    }
+}
+
+/**
+ * @brief Counts a search node, and checks the node limits
+ * @return Returns true if the search can go on. Returns false if a node limit was hit
+ */
+bool BidirectionalRoomSolver::ExpandNode()
+{
+    ++m_numNodesExpanded;
+    if ((m_maxNodes != 0) && (m_numNodesExpanded > m_maxNodes))
+    {
+        m_hasHitNodeLimit = true;
+        return false;
+    }
+
+    if ((m_roundNodeLimit != 0) && (m_numNodesExpanded > m_roundNodeLimit))
+    {
+        m_hasHitRoundLimit = true;
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Checks that a move of the second half ends where the backward search
+ * expects, with every floor not entered from there to the goal visited
+ * @param[in,out] board Room bitboard, whose state is overwritten
+ * @param[in] fromIndex Cell index the move is made from
+ * @param[in] direction Direction of the move
+ * @param[in] toIndex Cell index the move should end on
+ * @param[in] visitedMask Cells other than ice entered from the end of the move to the goal
+ * @return Returns true if the move ends on the expected cell. Returns false otherwise
+ */
+template <size_t NumWords>
+bool BidirectionalRoomSolver::IsMoveConsistent(
+    RoomBitboard<NumWords>& board,
+    const int32_t& fromIndex,
+    const Direction& direction,
+    const int32_t& toIndex,
+    const Bitboard<NumWords>& visitedMask) const
+{
+    Bitboard<NumWords> visitedFloorMask = board.GetFloorMask() & ~visitedMask;
+    board.SetState(visitedFloorMask, Bitboard<NumWords>(), visitedFloorMask == board.GetFloorMask());
+
+    int32_t cellIndex = fromIndex;
+    RoomMoveRecord record;
+    return board.ApplyMove(cellIndex, direction, record) && (cellIndex == toIndex);
+}
+
+/**
+ * @brief Checks whether the first half can still connect the start with the
+ * current cell of the backward search, through the cells the second half has
+ * not entered
+ * @param[in] board Room bitboard, in its initial state
+ * @param[in] cellIndex Cell index of the player's position
+ * @param[in] visitedMask Cells other than ice entered between this position and the goal
+ * @return Returns true if the start, the current cell and every floor left to the
+ * first half are connected. Returns false otherwise
+ */
+template <size_t NumWords>
+bool BidirectionalRoomSolver::CanReachStart(const RoomBitboard<NumWords>& board, const int32_t& cellIndex, const Bitboard<NumWords>& visitedMask) const
+{
+    Bitboard<NumWords> openMask = board.GetRoomMask() & ~(board.GetWallMask() | visitedMask);
+    openMask.Set(cellIndex);
+
+    Bitboard<NumWords> requiredMask = board.GetFloorMask() & ~visitedMask;
+    requiredMask.Set(cellIndex);
+
+    Bitboard<NumWords> reachedMask;
+    reachedMask.Set(board.GetStartIndex());
+    while (true)
+    {
+        Bitboard<NumWords> grownMask = (reachedMask | board.GetNeighborMask(reachedMask)) & openMask;
+        if (grownMask == reachedMask)
+        {
+            break;
+        }
+        reachedMask = grownMask;
+    }
+
+    return (requiredMask & ~reachedMask).IsEmpty();
+}
+
+/**
+ * @brief Joins the current first half with the stored second halves meeting
+ * it, and replays each joined solution
+ * @param[in] board Room bitboard, in its initial state
+ * @param[in] table Meeting table
+ * @param[in] key Meeting key the stored halves need to have
+ * @param[in] visitedOtherMask Cells other than floors visited by the first half
+ * @param[out] moves Joined solution, if one was found
+ * @return Returns true if a joined solution solves the room. Returns false otherwise
+ */
+template <size_t NumWords>
+bool BidirectionalRoomSolver::Join(
+    const RoomBitboard<NumWords>& board,
+    const MeetingTable<NumWords>& table,
+    const MeetingKey<NumWords>& key,
+    const Bitboard<NumWords>& visitedOtherMask,
+    std::vector<Direction>& moves)
+{
+    auto it = table.firstHalfIndices.find(key);
+    if (it == table.firstHalfIndices.end())
+    {
+        return false;
+    }
+
+    for (int32_t halfIndex = it->second; halfIndex != -1; halfIndex = table.halves[halfIndex].nextHalfIndex)
+    {
+        const StoredHalf<NumWords> &half = table.halves[halfIndex];
+        if (!(half.visitedOtherMask & visitedOtherMask).IsEmpty())
+        {
+            continue;
+        }
+
+        // Second halves are kept from the goal back to the meeting cell
+        std::vector<Direction>::const_iterator storedMovesBegin = table.moves.begin() + half.firstMoveIndex;
+        std::vector<Direction>::const_iterator storedMovesEnd = storedMovesBegin + half.numMoves;
+        moves = m_moves;
+        moves.insert(moves.end(), std::make_reverse_iterator(storedMovesEnd), std::make_reverse_iterator(storedMovesBegin));
+
+        // The second half was found without knowing the room state, so replay the
+        // whole solution to check the doors and the ice slides
+        ++m_numJoinsChecked;
+        RoomBitboard<NumWords> replayBoard = board;
+        replayBoard.Reset();
+        int32_t replayCellIndex = replayBoard.GetStartIndex();
+        bool hasReachedGoal = false;
+        for (size_t i = 0; i < moves.size(); ++i)
+        {
+            RoomMoveRecord record;
+            if (!replayBoard.ApplyMove(replayCellIndex, moves[i], record))
+            {
+                break;
+            }
+            if (record.hasReachedGoal)
+            {
+                hasReachedGoal = (i + 1 == moves.size());
+                break;
+            }
+        }
+
+        if (hasReachedGoal)
+        {
+            return true;
+        }
+    }
+
+    moves.clear();
+    return false;
+}
@@ -0,0 +1,623 @@
+#pragma once
+
+#include "ArticulationCheck.hpp"
+#include "Bitboard.hpp"
+#include "ConnectivityTracker.hpp"
+#include "Direction.hpp"
+#include "LevelData.hpp"
+#include "RoomBitboard.hpp"
+#include "TranspositionTable.hpp"
+#include "ZobristKeys.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+/**
+ * Headless solver that searches from both ends of the solution and joins the two
+ * halves in the middle (meet in the middle).
+ *
+ * Every solution visits the floors one by one, so it can be split at the cell
+ * where a given number of floors have been visited. The backward search
+ * enumerates every second half from the goal back to such a cell, and stores it
+ * keyed by (cell, set of floors entered). The forward search then goes
+ * depth-first from the start, and once it has visited the rest of the floors,
+ * looks up the stored halves that enter exactly the floors it has not visited.
+ * It only follows first halves that leave out all the floors of at least one
+ * stored half.
+ *
+ * The forward search runs like RoomSolver's: each search node is a room state,
+ * with the moves that only stop on ice folded into the moves out of it, pruned
+ * with the articulation point check and a transposition table of the room states
+ * already searched.
+ *
+ * The meeting floor is picked from the work the search takes. It starts as a
+ * plain forward search to the goal, which solves most rooms as quickly as
+ * RoomSolver. Each time a forward round runs out of its node budget, the second
+ * halves are stored one floor deeper (within the same budget), moving the meeting
+ * floor towards the start, and the budget doubles. Room states the forward search
+ * proved to be dead ends stay dead ends for every meeting floor, so they are kept
+ * from one round to the next. The meeting floor stops moving once the second
+ * halves no longer fit in memory.
+ *
+ * Going backwards, the cells a move can have started from are found in tables of
+ * reverse slides built once per room: from a cell, walking against the move
+ * direction over ice reaches every cell a slide could have started (or stopped on
+ * ice) at. A slide can only stop on ice in front of a wall, or in front of a cell
+ * that was already visited or still locked, so going backwards it cannot stop on
+ * ice in front of ice, the goal, or a cell the second half enters later. Doors are
+ * only entered if their switch is not entered later either, and the start has to
+ * stay connected to the current cell and the floors left to the first half without
+ * crossing the second half. The backward search does not know the whole room
+ * state, so it may still propose halves that only look valid; each join is checked
+ * by replaying the whole solution before it is accepted.
+ *
+ * In rooms without switches, doors or empty cells, every floor is visited exactly
+ * once and nothing else changes the room state, so the state before each move of
+ * the second half is known exactly: every floor not entered later is visited.
+ * There, each backward move is checked by making it forward, and states of the
+ * backward search that were already searched are not searched again.
+ */
+class BidirectionalRoomSolver
+{
+public:
+    /**
+     * Maximum number of cells in a room the solver can handle
+     */
+    static constexpr int32_t MAX_CELLS = RoomBitboard<16>::MAX_CELLS;
+
+    static_assert(MAX_CELLS <= ZobristKeys::MAX_CELLS, "Every cell must have its own Zobrist keys");
+
+private:
+    /**
+     * Key of a state where the two halves of a solution meet
+     */
+    template <size_t NumWords>
+    struct MeetingKey
+    {
+        /**
+         * Floors visited by the half, including the meeting cell
+         */
+        Bitboard<NumWords> visitedFloorMask;
+
+        /**
+         * Cell index of the meeting cell
+         */
+        int32_t cellIndex;
+
+        /**
+         * @brief Compares two keys
+         * @param[in] other Key to compare with
+         * @return Returns true if both keys are the same
+         */
+        bool operator==(const MeetingKey& other) const
+        {
+            return (cellIndex == other.cellIndex) && (visitedFloorMask == other.visitedFloorMask);
+        }
+    };
+
+    /**
+     * Hash function of meeting keys
+     */
+    template <size_t NumWords>
+    struct MeetingKeyHash
+    {
+        /**
+         * @brief Hashes a key
+         * @param[in] key Key
+         * @return Hash of the key
+         */
+        size_t operator()(const MeetingKey<NumWords>& key) const
+        {
+            uint64_t hash = static_cast<uint64_t>(key.cellIndex) * 0x9E3779B97F4A7C15ULL;
+            for (size_t i = 0; i < NumWords; ++i)
+            {
+                hash = (hash ^ key.visitedFloorMask.GetWord(i)) * 0xBF58476D1CE4E5B9ULL;
+                hash ^= hash >> 31;
+            }
+
+            return static_cast<size_t>(hash);
+        }
+    };
+
+    /**
+     * Second half of a solution stored by the backward search
+     */
+    template <size_t NumWords>
+    struct StoredHalf
+    {
+        /**
+         * Cells other than floors (switches, doors and empty cells) visited by the
+         * half, including the goal
+         */
+        Bitboard<NumWords> visitedOtherMask;
+
+        /**
+         * Index of the first move of the half in the table's moves
+         */
+        size_t firstMoveIndex;
+
+        /**
+         * Number of moves in the half
+         */
+        size_t numMoves;
+
+        /**
+         * Index of the next half with the same key. -1 for the last one
+         */
+        int32_t nextHalfIndex;
+    };
+
+    /**
+     * Second halves stored by the backward search, chained by key
+     */
+    template <size_t NumWords>
+    struct MeetingTable
+    {
+        /**
+         * Index of the first half stored for each key
+         */
+        std::unordered_map<MeetingKey<NumWords>, int32_t, MeetingKeyHash<NumWords>> firstHalfIndices;
+
+        /**
+         * Distinct keys of the stored halves
+         */
+        std::vector<MeetingKey<NumWords>> keys;
+
+        /**
+         * Stored halves
+         */
+        std::vector<StoredHalf<NumWords>> halves;
+
+        /**
+         * Moves of every stored half, back to back, each from the goal back to
+         * the meeting cell
+         */
+        std::vector<Direction> moves;
+
+        /**
+         * States of the backward search, as (cell, cells entered from there to the
+         * goal), whose second halves were all stored already. Only used when the
+         * room state is known from the cells entered
+         */
+        std::unordered_set<MeetingKey<NumWords>, MeetingKeyHash<NumWords>> deadEndStates;
+    };
+
+    /**
+     * Entry in the list of positions the forward search reaches without changing
+     * the room state (i.e. by only stopping on ice cells)
+     */
+    struct ClosureEntry
+    {
+        /**
+         * Cell index of the position
+         */
+        int32_t cellIndex;
+
+        /**
+         * Index of the entry this entry was reached from. -1 for the first entry
+         */
+        int32_t parentEntryIndex;
+
+        /**
+         * Direction of the move from the parent entry
+         */
+        Direction direction;
+    };
+
+    /**
+     * Move of the forward search that changes the room state
+     */
+    struct Successor
+    {
+        /**
+         * Index of the closure entry the move is made from
+         */
+        int32_t entryIndex;
+
+        /**
+         * Direction of the move
+         */
+        Direction direction;
+
+        /**
+         * Number of onward steps from the cell the move ends on
+         */
+        int32_t numOnwardSteps;
+    };
+
+private:
+    /**
+     * Moves made so far in the current branch of the forward search, or the moves
+     * from the goal back to the current cell in the backward search
+     */
+    std::vector<Direction> m_moves;
+
+    /**
+     * Stack of closure entries for all the nodes in the current branch of the forward search
+     */
+    std::vector<ClosureEntry> m_closureEntries;
+
+    /**
+     * Stack of successors for all the nodes in the current branch of the forward search
+     */
+    std::vector<Successor> m_successors;
+
+    /**
+     * Per-cell marks used by the closure computation
+     */
+    std::vector<uint32_t> m_cellMarks;
+
+    /**
+     * Current mark value. Cells marked with a different value are unmarked
+     */
+    uint32_t m_currentMark;
+
+    /**
+     * Ice cells stopped on by the backward search since the room state last changed
+     */
+    std::vector<int32_t> m_iceStops;
+
+    /**
+     * Indices of the meeting keys of the stored halves that the current half can
+     * still be joined with, i.e. that visit none of its floors but the meeting
+     * floor. Each level of the search appends the keys it keeps to the ones of the
+     * level above
+     */
+    std::vector<int32_t> m_compatibleKeyIndices;
+
+    /**
+     * Index of the first reverse slide of each cell and direction in m_predecessors,
+     * indexed by (cell index * 4 + direction). The last entry is the total count
+     */
+    std::vector<int32_t> m_predecessorOffsets;
+
+    /**
+     * Cells a move can have been made from to end on each cell, grouped by cell and direction
+     */
+    std::vector<int32_t> m_predecessors;
+
+    /**
+     * Cell index of the switch of each door cell. -1 for other cells and for doors without a switch
+     */
+    std::vector<int32_t> m_doorSwitchIndices;
+
+    /**
+     * Number of floors the first half of a solution visits, including the start
+     * and the meeting floor
+     */
+    int32_t m_numMeetingFloors;
+
+    /**
+     * Number of floors in the room
+     */
+    int32_t m_numFloors;
+
+    /**
+     * Flag indicating whether the room state before each move of the second half is
+     * known from the cells it enters, i.e. the room has no switches, doors or empty cells
+     */
+    bool m_isStateKnown;
+
+    /**
+     * Flag indicating whether the current search stopped because its halves no
+     * longer fit in the meeting table
+     */
+    bool m_hasHitStoreLimit;
+
+    /**
+     * Number of second halves the last round of the forward search was joined with
+     */
+    uint64_t m_numStoredHalves;
+
+    /**
+     * Number of joined solutions replayed by the last call to Solve()
+     */
+    uint64_t m_numJoinsChecked;
+
+    /**
+     * Number of search nodes expanded by the last call to Solve(), in both directions
+     */
+    uint64_t m_numNodesExpanded;
+
+    /**
+     * Maximum number of search nodes to expand before giving up. 0 means no limit
+     */
+    uint64_t m_maxNodes;
+
+    /**
+     * Flag indicating whether the last search gave up due to the node limit
+     */
+    bool m_hasHitNodeLimit;
+
+    /**
+     * Number of search nodes expanded at which the current round of the search
+     * stops. 0 means the round runs until it is done
+     */
+    uint64_t m_roundNodeLimit;
+
+    /**
+     * Flag indicating whether the current round of the search stopped at its node limit
+     */
+    bool m_hasHitRoundLimit;
+
+    /**
+     * Room states of the forward search proved to be dead ends
+     */
+    TranspositionTable m_transpositionTable;
+
+    /**
+     * Zobrist hash of the visited cells and unlocked doors in the current branch of
+     * the forward search
+     */
+    uint64_t m_stateHash;
+
+    /**
+     * Articulation point check over the unvisited cells of the forward search
+     */
+    ArticulationCheck m_articulationCheck;
+
+public:
+    /**
+     * @brief Constructor
+     */
+    BidirectionalRoomSolver();
+
+    /**
+     * @brief Destructor
+     */
+    ~BidirectionalRoomSolver();
+
+    /**
+     * @brief Sets the maximum number of search nodes to expand before giving up
+     * @param[in] maxNodes Maximum number of search nodes. 0 means no limit
+     */
+    void SetMaxNodes(const uint64_t& maxNodes);
+
+    /**
+     * @brief Searches for a sequence of moves that solves the specified room. The
+     * search is exhaustive, so a room is unsolvable if no solution is found and the
+     * node limit was not hit.
+     * @param[in] roomData Room data
+     * @param[out] moves Sequence of moves that solves the room
+     * @return Returns true if a solution was found. Returns false otherwise
+     */
+    bool Solve(const RoomData& roomData, std::vector<Direction>& moves);
+
+    /**
+     * @brief Gets the number of search nodes expanded by the last call to Solve()
+     * @return Number of search nodes expanded
+     */
+    uint64_t GetNumNodesExpanded() const;
+
+    /**
+     * @brief Gets the number of floors the first half of a solution visits in the
+     * last round of the last call to Solve(), including the start and the meeting floor
+     * @return Number of floors. 0 if the forward search went all the way to the goal
+     */
+    int32_t GetNumMeetingFloors() const;
+
+    /**
+     * @brief Gets the number of second halves the last round of the last call to
+     * Solve() was joined with
+     * @return Number of stored halves
+     */
+    uint64_t GetNumStoredHalves() const;
+
+    /**
+     * @brief Gets the number of joined solutions replayed by the last call to Solve()
+     * @return Number of joins checked
+     */
+    uint64_t GetNumJoinsChecked() const;
+
+    /**
+     * @brief Queries whether the last call to Solve() gave up due to the node limit
+     * @return Returns true if the search gave up before exhausting all possibilities
+     */
+    bool HasHitNodeLimit() const;
+
+private:
+    /**
+     * @brief Searches for a solution using a bitboard with the specified number of words
+     * @param[in] roomData Room data
+     * @param[out] moves Sequence of moves that solves the room
+     * @return Returns true if a solution was found. Returns false otherwise
+     */
+    template <size_t NumWords>
+    bool SolveWithBitboard(const RoomData& roomData, std::vector<Direction>& moves);
+
+    /**
+     * @brief Builds the table of reverse slides of every cell, and the switch of every door
+     * @param[in] roomData Room data
+     * @param[in] board Room bitboard
+     */
+    template <size_t NumWords>
+    void BuildPredecessors(const RoomData& roomData, const RoomBitboard<NumWords>& board);
+
+    /**
+     * @brief Prepares the forward search to start from the start of the room
+     * @param[in,out] board Room bitboard, reset to its initial state
+     */
+    template <size_t NumWords>
+    void PrepareForwardSearch(RoomBitboard<NumWords>& board);
+
+    /**
+     * @brief Stores every second half of the solutions that enters the specified
+     * number of floors in a meeting table
+     * @param[in,out] board Room bitboard, in its initial state
+     * @param[out] table Meeting table
+     * @param[in] numMeetingFloors Number of floors each second half enters, including the meeting floor
+     * @return Returns true if every second half was stored. Returns false if they do
+     * not fit in the table, or a node limit was hit
+     */
+    template <size_t NumWords>
+    bool StoreBackwardHalves(RoomBitboard<NumWords>& board, MeetingTable<NumWords>& table, const int32_t& numMeetingFloors);
+
+    /**
+     * @brief Lists the keys of the stored halves that a half with the specified
+     * floors visited can still be joined with, as the first compatible keys
+     * @param[in] table Meeting table
+     * @param[in] visitedFloorMask Floors the half has visited so far
+     */
+    template <size_t NumWords>
+    void ResetCompatibleKeys(const MeetingTable<NumWords>& table, const Bitboard<NumWords>& visitedFloorMask);
+
+    /**
+     * @brief Keeps the compatible keys of the current level that leave the specified
+     * floor to the half searching, appending them as the keys of the next level
+     * @param[in] table Meeting table
+     * @param[in] firstKeyIndex Index of the first key of the current level in m_compatibleKeyIndices
+     * @param[in] lastKeyIndex Index past the last key of the current level in m_compatibleKeyIndices
+     * @param[in] floorIndex Cell index of the floor entered
+     * @return Index of the first key of the next level in m_compatibleKeyIndices
+     */
+    template <size_t NumWords>
+    size_t FilterCompatibleKeys(
+        const MeetingTable<NumWords>& table,
+        const size_t& firstKeyIndex,
+        const size_t& lastKeyIndex,
+        const int32_t& floorIndex);
+
+    /**
+     * @brief Recursively searches forward from the specified position, and joins
+     * the first halves with the second halves stored in the meeting table, or goes
+     * all the way to the goal if there is no meeting floor
+     * @param[in,out] board Room bitboard
+     * @param[in] table Meeting table
+     * @param[in] cellIndex Cell index of the player's position
+     * @param[in] numVisitedFloors Number of floors visited so far
+     * @param[in] firstKeyIndex Index of the first meeting key in m_compatibleKeyIndices
+     * that the first half can still be joined with
+     * @param[out] moves Joined solution, if one was found
+     * @return Returns true if a solution was found. Returns false otherwise
+     */
+    template <size_t NumWords>
+    bool SearchForward(
+        RoomBitboard<NumWords>& board,
+        const MeetingTable<NumWords>& table,
+        const int32_t& cellIndex,
+        const int32_t& numVisitedFloors,
+        const size_t& firstKeyIndex,
+        std::vector<Direction>& moves);
+
+    /**
+     * @brief Gathers the moves that change the room state from the specified position,
+     * pushing them to the successor stack in the order they should be tried
+     * @param[in,out] board Room bitboard
+     * @param[in] cellIndex Cell index of the player's position
+     * @return Returns true if one of the moves reaches the goal, in which case the moves
+     * leading to the goal are pushed to the current move list. Returns false otherwise
+     */
+    template <size_t NumWords>
+    bool GatherSuccessors(RoomBitboard<NumWords>& board, const int32_t& cellIndex);
+
+    /**
+     * @brief Pushes the moves needed to get to the specified closure entry
+     * @param[in] entryIndex Closure entry index
+     * @return Number of moves pushed
+     */
+    int32_t PushPathToEntry(const int32_t& entryIndex);
+
+    /**
+     * @brief Gets a fresh mark value, effectively unmarking all cells
+     * @return Mark value
+     */
+    uint32_t NextMark();
+
+    /**
+     * @brief Checks whether all the unvisited floor cells and the goal can still be
+     * visited from the specified cell, assuming all locked doors can be opened
+     * @param[in] board Room bitboard
+     * @param[in] cellIndex Cell index of the player's position
+     * @return Returns true if the remaining cells might still be visited. Returns false
+     * if the current search branch is a dead end
+     */
+    template <size_t NumWords>
+    bool CanVisitRemainingCells(const RoomBitboard<NumWords>& board, const int32_t& cellIndex);
+
+    /**
+     * @brief Stores a second half in the meeting table, unless the table already
+     * holds a half that can be swapped for it
+     * @param[in,out] table Meeting table
+     * @param[in] key Meeting key of the half
+     * @param[in] visitedOtherMask Cells other than floors visited by the half
+     */
+    template <size_t NumWords>
+    void StoreHalf(MeetingTable<NumWords>& table, const MeetingKey<NumWords>& key, const Bitboard<NumWords>& visitedOtherMask);
+
+    /**
+     * @brief Recursively walks back from the specified position towards the start,
+     * and stores the second halves in the meeting table
+     * @param[in,out] board Room bitboard, used to check moves
+     * @param[in,out] table Meeting table
+     * @param[in] cellIndex Cell index of the player's position
+     * @param[in,out] visitedMask Cells other than ice entered between this position and the goal
+     * @param[in] numVisitedFloors Number of floors in visitedMask
+     * @param[in] firstIceStopIndex Index of the first ice stop made since the room state last changed
+     */
+    template <size_t NumWords>
+    void SearchBackward(
+        RoomBitboard<NumWords>& board,
+        MeetingTable<NumWords>& table,
+        const int32_t& cellIndex,
+        Bitboard<NumWords>& visitedMask,
+        const int32_t& numVisitedFloors,
+        const size_t& firstIceStopIndex);
+
+    /**
+     * @brief Counts a search node, and checks the node limits
+     * @return Returns true if the search can go on. Returns false if a node limit was hit
+     */
+    bool ExpandNode();
+
+    /**
+     * @brief Checks that a move of the second half ends where the backward search
+     * expects, with every floor not entered from there to the goal visited
+     * @param[in,out] board Room bitboard, whose state is overwritten
+     * @param[in] fromIndex Cell index the move is made from
+     * @param[in] direction Direction of the move
+     * @param[in] toIndex Cell index the move should end on
+     * @param[in] visitedMask Cells other than ice entered from the end of the move to the goal
+     * @return Returns true if the move ends on the expected cell. Returns false otherwise
+     */
+    template <size_t NumWords>
+    bool IsMoveConsistent(
+        RoomBitboard<NumWords>& board,
+        const int32_t& fromIndex,
+        const Direction& direction,
+        const int32_t& toIndex,
+        const Bitboard<NumWords>& visitedMask) const;
+
+    /**
+     * @brief Checks whether the first half can still connect the start with the
+     * current cell of the backward search, through the cells the second half has
+     * not entered
+     * @param[in] board Room bitboard, in its initial state
+     * @param[in] cellIndex Cell index of the player's position
+     * @param[in] visitedMask Cells other than ice entered between this position and the goal
+     * @return Returns true if the start, the current cell and every floor left to the
+     * first half are connected. Returns false otherwise
+     */
+    template <size_t NumWords>
+    bool CanReachStart(const RoomBitboard<NumWords>& board, const int32_t& cellIndex, const Bitboard<NumWords>& visitedMask) const;
+
+    /**
+     * @brief Joins the current first half with the stored second halves meeting
+     * it, and replays each joined solution
+     * @param[in] board Room bitboard, in its initial state
+     * @param[in] table Meeting table
+     * @param[in] key Meeting key the stored halves need to have
+     * @param[in] visitedOtherMask Cells other than floors visited by the first half
+     * @param[out] moves Joined solution, if one was found
+     * @return Returns true if a joined solution solves the room. Returns false otherwise
+     */
+    template <size_t NumWords>
+    bool Join(
+        const RoomBitboard<NumWords>& board,
+        const MeetingTable<NumWords>& table,
+        const MeetingKey<NumWords>& key,
+        const Bitboard<NumWords>& visitedOtherMask,
+        std::vector<Direction>& moves);
+};
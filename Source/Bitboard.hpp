@@ -0,0 +1,272 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Fixed-size set of bits, used to represent a set of cells in a room
+ * where bit (y * width + x) corresponds to the cell at (x, y)
+ */
+template <size_t NumWords>
+class Bitboard
+{
+public:
+    /**
+     * Number of bits in the bitboard
+     */
+    static constexpr int32_t NUM_BITS = static_cast<int32_t>(NumWords * 64);
+
+private:
+    /**
+     * Underlying words, with the lowest bits in the first word
+     */
+    std::array<uint64_t, NumWords> m_words;
+
+public:
+    /**
+     * @brief Constructor. All bits are cleared.
+     */
+    constexpr Bitboard()
+        : m_words()
+    {
+    }
+
+    /**
+     * @brief Sets the bit at the specified index
+     * @param[in] index Bit index
+     */
+    constexpr void Set(const int32_t& index)
+    {
+        m_words[index >> 6] |= (uint64_t(1) << (index & 63));
+    }
+
+    /**
+     * @brief Clears the bit at the specified index
+     * @param[in] index Bit index
+     */
+    constexpr void Reset(const int32_t& index)
+    {
+        m_words[index >> 6] &= ~(uint64_t(1) << (index & 63));
+    }
+
+    /**
+     * @brief Queries whether the bit at the specified index is set or not
+     * @param[in] index Bit index
+     * @return Returns true if the bit is set. Returns false otherwise
+     */
+    constexpr bool Test(const int32_t& index) const
+    {
+        return ((m_words[index >> 6] >> (index & 63)) & 1) != 0;
+    }
+
+    /**
+     * @brief Clears all the bits
+     */
+    constexpr void Clear()
+    {
+        m_words.fill(0);
+    }
+
+    /**
+     * @brief Queries whether no bit is set
+     * @return Returns true if no bit is set. Returns false otherwise
+     */
+    constexpr bool IsEmpty() const
+    {
+        uint64_t combined = 0;
+        for (size_t i = 0; i < NumWords; ++i)
+        {
+            combined |= m_words[i];
+        }
+
+        return combined == 0;
+    }
+
+    /**
+     * @brief Counts the number of set bits
+     * @return Number of set bits
+     */
+    constexpr int32_t Count() const
+    {
+        int32_t count = 0;
+        for (size_t i = 0; i < NumWords; ++i)
+        {
+            count += std::popcount(m_words[i]);
+        }
+
+        return count;
+    }
+
+    /**
+     * @brief Gets the index of the lowest set bit
+     * @return Index of the lowest set bit. Returns -1 if no bit is set
+     */
+    constexpr int32_t FindFirst() const
+    {
+        for (size_t i = 0; i < NumWords; ++i)
+        {
+            if (m_words[i] != 0)
+            {
+                return static_cast<int32_t>(i * 64) + std::countr_zero(m_words[i]);
+            }
+        }
+
+        return -1;
+    }
+
+    /**
+     * @brief Gets the word at the specified index
+     * @param[in] wordIndex Word index
+     * @return Word containing bits [wordIndex * 64, wordIndex * 64 + 63]
+     */
+    constexpr uint64_t GetWord(const size_t& wordIndex) const
+    {
+        return m_words[wordIndex];
+    }
+
+    /**
+     * @brief Shifts all bits towards the higher indices
+     * @param[in] amount Number of bits to shift by
+     * @return Shifted bitboard
+     */
+    constexpr Bitboard operator<<(const int32_t& amount) const
+    {
+        Bitboard result;
+        const int32_t wordShift = amount >> 6;
+        const int32_t bitShift = amount & 63;
+        for (int32_t i = static_cast<int32_t>(NumWords) - 1; i >= wordShift; --i)
+        {
+            uint64_t word = m_words[i - wordShift] << bitShift;
+            if ((bitShift != 0) && (i - wordShift - 1 >= 0))
+            {
+                word |= m_words[i - wordShift - 1] >> (64 - bitShift);
+            }
+            result.m_words[i] = word;
+        }
+
+        return result;
+    }
+
+    /**
+     * @brief Shifts all bits towards the lower indices
+     * @param[in] amount Number of bits to shift by
+     * @return Shifted bitboard
+     */
+    constexpr Bitboard operator>>(const int32_t& amount) const
+    {
+        Bitboard result;
+        const int32_t wordShift = amount >> 6;
+        const int32_t bitShift = amount & 63;
+        for (int32_t i = 0; i + wordShift < static_cast<int32_t>(NumWords); ++i)
+        {
+            uint64_t word = m_words[i + wordShift] >> bitShift;
+            if ((bitShift != 0) && (i + wordShift + 1 < static_cast<int32_t>(NumWords)))
+            {
+                word |= m_words[i + wordShift + 1] << (64 - bitShift);
+            }
+            result.m_words[i] = word;
+        }
+
+        return result;
+    }
+
+    /**
+     * @brief Bitwise AND of the two bitboards
+     */
+    constexpr Bitboard operator&(const Bitboard& other) const
+    {
+        Bitboard result;
+        for (size_t i = 0; i < NumWords; ++i)
+        {
+            result.m_words[i] = m_words[i] & other.m_words[i];
+        }
+
+        return result;
+    }
+
+    /**
+     * @brief Bitwise OR of the two bitboards
+     */
+    constexpr Bitboard operator|(const Bitboard& other) const
+    {
+        Bitboard result;
+        for (size_t i = 0; i < NumWords; ++i)
+        {
+            result.m_words[i] = m_words[i] | other.m_words[i];
+        }
+
+        return result;
+    }
+
+    /**
+     * @brief Bitwise XOR of the two bitboards
+     */
+    constexpr Bitboard operator^(const Bitboard& other) const
+    {
+        Bitboard result;
+        for (size_t i = 0; i < NumWords; ++i)
+        {
+            result.m_words[i] = m_words[i] ^ other.m_words[i];
+        }
+
+        return result;
+    }
+
+    /**
+     * @brief Bitwise NOT of the bitboard
+     */
+    constexpr Bitboard operator~() const
+    {
+        Bitboard result;
+        for (size_t i = 0; i < NumWords; ++i)
+        {
+            result.m_words[i] = ~m_words[i];
+        }
+
+        return result;
+    }
+
+    /**
+     * @brief In-place bitwise AND with the other bitboard
+     */
+    constexpr Bitboard& operator&=(const Bitboard& other)
+    {
+        for (size_t i = 0; i < NumWords; ++i)
+        {
+            m_words[i] &= other.m_words[i];
+        }
+
+        return *this;
+    }
+
+    /**
+     * @brief In-place bitwise OR with the other bitboard
+     */
+    constexpr Bitboard& operator|=(const Bitboard& other)
+    {
+        for (size_t i = 0; i < NumWords; ++i)
+        {
+            m_words[i] |= other.m_words[i];
+        }
+
+        return *this;
+    }
+
+    /**
+     * @brief Checks whether both bitboards have the same bits set
+     */
+    constexpr bool operator==(const Bitboard& other) const
+    {
+        return m_words == other.m_words;
+    }
+
+    /**
+     * @brief Checks whether the bitboards differ in any bit
+     */
+    constexpr bool operator!=(const Bitboard& other) const
+    {
+        return m_words != other.m_words;
+    }
+};
@@ -0,0 +1,304 @@
+#pragma once
+
+#include "Direction.hpp"
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/**
+ * Grid padded with a one-cell border on every side. The border cells are
+ * filled with a sentinel value (e.g. a wall), so the neighbors of any cell
+ * inside the grid can be accessed by index without bounds checks.
+ *
+ * Coordinates passed to Get(), Set() and IsValidLocation() refer to the
+ * cells inside the border, the same as Grid. Indices refer to the padded
+ * buffer, which is (width + 2) cells wide.
+ */
+template <typename T>
+class BorderedGrid
+{
+private:
+    /**
+     * Grid width, excluding the border
+     */
+    int32_t m_width;
+
+    /**
+     * Grid height, excluding the border
+     */
+    int32_t m_height;
+
+    /**
+     * Number of cells in a row of the padded buffer
+     */
+    int32_t m_stride;
+
+    /**
+     * Index offset to the neighboring cell in each direction
+     */
+    std::array<int32_t, 4> m_neighborOffsets;
+
+    /**
+     * Underlying buffer containing the data for the
+     * cells in the grid, including the border
+     */
+    std::vector<T> m_buffer;
+
+public:
+    /**
+     * @brief Constructor
+     */
+    BorderedGrid()
+        : m_width(0)
+        , m_height(0)
+        , m_stride(2)
+        , m_neighborOffsets()
+        , m_buffer()
+    {
+    }
+
+    /**
+     * @brief Destructor
+     */
+    ~BorderedGrid()
+    {
+    }
+
+    /**
+     * @brief Gets the width of the grid, excluding the border.
+     * @return Grid width
+     */
+    int32_t GetWidth() const
+    {
+        return m_width;
+    }
+
+    /**
+     * @brief Gets the height of the grid, excluding the border.
+     * @return Grid height
+     */
+    int32_t GetHeight() const
+    {
+        return m_height;
+    }
+
+    /**
+     * @brief Resizes the grid to the specified width and height, and fills the border
+     * with the specified value. All the cells inside the border are reset.
+     * @param[in] width New width, excluding the border
+     * @param[in] height New height, excluding the border
+     * @param[in] borderValue Value of the cells in the border
+     */
+    void Resize(const int32_t& width, const int32_t& height, const T& borderValue)
+    {
+        m_width = width;
+        m_height = height;
+        m_stride = width + 2;
+        for (Direction direction : ALL_DIRECTIONS)
+        {
+            m_neighborOffsets[static_cast<uint8_t>(direction)] = GetOffset(GetDirectionX(direction), GetDirectionY(direction));
+        }
+
+        m_buffer.assign(m_stride * (height + 2), T());
+        for (int32_t x = -1; x <= width; ++x)
+        {
+            m_buffer[GetIndex(x, -1)] = borderValue;
+            m_buffer[GetIndex(x, height)] = borderValue;
+        }
+        for (int32_t y = 0; y < height; ++y)
+        {
+            m_buffer[GetIndex(-1, y)] = borderValue;
+            m_buffer[GetIndex(width, y)] = borderValue;
+        }
+    }
+
+    /**
+     * @brief Checks whether the specified location is a valid location or not.
+     * @param[in] x X-coordinate
+     * @param[in] y Y-coordinate
+     * @return Returns true if the specified location is inside the border. Returns false otherwise.
+     */
+    bool IsValidLocation(const int32_t& x, const int32_t& y) const
+    {
+        return (0 <= x) && (x < m_width) && (0 <= y) && (y < m_height);
+    }
+
+    /**
+     * @brief Gets the pointer to the cell data at the specified location.
+     * @param[in] x X-coordinate
+     * @param[in] y Y-coordinate
+     * @return Pointer to the cell data at the specified location. Returns nullptr if the location is invalid.
+     */
+    T* Get(const int32_t& x, const int32_t& y)
+    {
+        if (IsValidLocation(x, y))
+        {
+            return &m_buffer[GetIndex(x, y)];
+        }
+
+        return nullptr;
+    }
+
+    /**
+     * @brief Gets the pointer to the cell data at the specified location.
+     * @param[in] x X-coordinate
+     * @param[in] y Y-coordinate
+     * @return Pointer to the cell data at the specified location. Returns nullptr if the location is invalid.
+     */
+    const T* Get(const int32_t& x, const int32_t& y) const
+    {
+        if (IsValidLocation(x, y))
+        {
+            return &m_buffer[GetIndex(x, y)];
+        }
+
+        return nullptr;
+    }
+
+    /**
+     * @brief Sets the cell data at the specified location.
+     * @param[in] x X-coordinate
+     * @param[in] y Y-coordinate
+     * @param[in] data Cell data
+     */
+    void Set(const int32_t& x, const int32_t& y, const T& data)
+    {
+        if (IsValidLocation(x, y))
+        {
+            m_buffer[GetIndex(x, y)] = data;
+        }
+    }
+
+    /**
+     * @brief Gets the index of the specified location in the padded buffer. Locations
+     * in the border (x or y of -1, x of width, y of height) are allowed.
+     * @param[in] x X-coordinate
+     * @param[in] y Y-coordinate
+     * @return Index of the location
+     */
+    int32_t GetIndex(const int32_t& x, const int32_t& y) const
+    {
+        return (y + 1) * m_stride + (x + 1);
+    }
+
+    /**
+     * @brief Gets the location of the specified index in the padded buffer.
+     * @param[in] index Index in the padded buffer
+     * @param[out] x X-coordinate of the location
+     * @param[out] y Y-coordinate of the location
+     */
+    void GetLocation(const int32_t& index, int32_t& x, int32_t& y) const
+    {
+        x = index % m_stride - 1;
+        y = index / m_stride - 1;
+    }
+
+    /**
+     * @brief Gets the number of cells in the padded buffer, which is one past the
+     * largest valid index
+     * @return Number of cells, including the border
+     */
+    int32_t GetBufferSize() const
+    {
+        return static_cast<int32_t>(m_buffer.size());
+    }
+
+    /**
+     * @brief Gets the index offset for moving by the specified amount.
+     * @param[in] moveX Move amount in the x-axis
+     * @param[in] moveY Move amount in the y-axis
+     * @return Index offset
+     */
+    int32_t GetOffset(const int32_t& moveX, const int32_t& moveY) const
+    {
+        return moveY * m_stride + moveX;
+    }
+
+    /**
+     * @brief Gets the index offset to the neighboring cell in the specified direction.
+     * @param[in] direction Direction
+     * @return Index offset
+     */
+    int32_t GetNeighborOffset(const Direction& direction) const
+    {
+        return m_neighborOffsets[static_cast<uint8_t>(direction)];
+    }
+
+    /**
+     * @brief Gets the cell data at the specified index without any bounds checks.
+     * @param[in] index Index in the padded buffer
+     * @return Reference to the cell data at the specified index
+     */
+    T& GetAt(const int32_t& index)
+    {
+        return m_buffer[index];
+    }
+
+    /**
+     * @brief Gets the cell data at the specified index without any bounds checks.
+     * @param[in] index Index in the padded buffer
+     * @return Reference to the cell data at the specified index
+     */
+    const T& GetAt(const int32_t& index) const
+    {
+        return m_buffer[index];
+    }
+
+    /**
+     * @brief Gets the cells in the specified row, in memory order.
+     * @param[in] y Y-coordinate of the row
+     * @return Span over the cells in the row, excluding the border
+     */
+    std::span<T> GetRow(const int32_t& y)
+    {
+        return std::span<T>(m_buffer.data() + GetIndex(0, y), m_width);
+    }
+
+    /**
+     * @brief Gets the cells in the specified row, in memory order.
+     * @param[in] y Y-coordinate of the row
+     * @return Span over the cells in the row, excluding the border
+     */
+    std::span<const T> GetRow(const int32_t& y) const
+    {
+        return std::span<const T>(m_buffer.data() + GetIndex(0, y), m_width);
+    }
+
+    /**
+     * @brief Calls the specified function for every cell inside the border, in memory order
+     * (row by row).
+     * @param[in] func Function taking the x-coordinate, y-coordinate and a reference to the cell data
+     */
+    template <typename Func>
+    void ForEach(Func&& func)
+    {
+        for (int32_t y = 0; y < m_height; ++y)
+        {
+            T *row = m_buffer.data() + GetIndex(0, y);
+            for (int32_t x = 0; x < m_width; ++x)
+            {
+                func(x, y, row[x]);
+            }
+        }
+    }
+
+    /**
+     * @brief Calls the specified function for every cell inside the border, in memory order
+     * (row by row).
+     * @param[in] func Function taking the x-coordinate, y-coordinate and a const reference to the cell data
+     */
+    template <typename Func>
+    void ForEach(Func&& func) const
+    {
+        for (int32_t y = 0; y < m_height; ++y)
+        {
+            const T *row = m_buffer.data() + GetIndex(0, y);
+            for (int32_t x = 0; x < m_width; ++x)
+            {
+                func(x, y, row[x]);
+            }
+        }
+    }
+};
@@ -0,0 +1,229 @@
+#pragma once
+
+#include "LevelData.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/**
+ * Structure-of-arrays variant of Grid<CellData>, where the type, visited flag
+ * and state of the cells are each stored in their own contiguous plane in
+ * row-major order. Scans over a single field (e.g. counting unvisited floors,
+ * or clearing the visited flags and states) only touch the plane they need.
+ *
+ * Only CellScanKernels and BenchmarkScans use this grid. RoomData keeps its
+ * cells in a BorderedGrid<CellData>, which the game scene, the simulator and
+ * the solvers all read, and its completion check is a running count of the
+ * unvisited floors rather than a scan.
+ */
+class CellPlaneGrid
+{
+private:
+    /**
+     * Grid width
+     */
+    int32_t m_width;
+
+    /**
+     * Grid height
+     */
+    int32_t m_height;
+
+    /**
+     * Type of each cell
+     */
+    std::vector<CellData::Type> m_types;
+
+    /**
+     * Visited flag of each cell. 1 if visited, 0 otherwise
+     */
+    std::vector<uint8_t> m_visitedFlags;
+
+    /**
+     * State of each cell. One of the *_STATE values in Constants.hpp
+     */
+    std::vector<uint8_t> m_states;
+
+public:
+    /**
+     * @brief Constructor
+     */
+    CellPlaneGrid()
+        : m_width(0)
+        , m_height(0)
+        , m_types()
+        , m_visitedFlags()
+        , m_states()
+    {
+    }
+
+    /**
+     * @brief Destructor
+     */
+    ~CellPlaneGrid()
+    {
+    }
+
+    /**
+     * @brief Gets the width of the grid.
+     * @return Grid width
+     */
+    int32_t GetWidth() const
+    {
+        return m_width;
+    }
+
+    /**
+     * @brief Gets the height of the grid.
+     * @return Grid height
+     */
+    int32_t GetHeight() const
+    {
+        return m_height;
+    }
+
+    /**
+     * @brief Resizes the grid to the specified width and height.
+     * @param[in] width New width
+     * @param[in] height New height
+     */
+    void Resize(const int32_t& width, const int32_t& height)
+    {
+        m_width = width;
+        m_height = height;
+        m_types.resize(width * height);
+        m_visitedFlags.resize(width * height);
+        m_states.resize(width * height);
+    }
+
+    /**
+     * @brief Checks whether the specified location is a valid location or not.
+     * @param[in] x X-coordinate
+     * @param[in] y Y-coordinate
+     * @return Returns true if the specified location is valid. Returns false otherwise.
+     */
+    bool IsValidLocation(const int32_t& x, const int32_t& y) const
+    {
+        return (0 <= x) && (x < m_width) && (0 <= y) && (y < m_height);
+    }
+
+    /**
+     * @brief Gets the cell data at the specified location.
+     * @param[in] x X-coordinate
+     * @param[in] y Y-coordinate
+     * @return Cell data at the specified location. Returns an unvisited empty cell
+     * if the location is invalid.
+     */
+    CellData Get(const int32_t& x, const int32_t& y) const
+    {
+        CellData cellData;
+        if (IsValidLocation(x, y))
+        {
+            int32_t flattenedIndex = y * m_width + x;
+            cellData.SetType(m_types[flattenedIndex]);
+            cellData.SetVisited(m_visitedFlags[flattenedIndex] != 0);
+            cellData.SetState(m_states[flattenedIndex]);
+        }
+
+        return cellData;
+    }
+
+    /**
+     * @brief Sets the cell data at the specified location.
+     * @param[in] x X-coordinate
+     * @param[in] y Y-coordinate
+     * @param[in] data Cell data
+     */
+    void Set(const int32_t& x, const int32_t& y, const CellData& data)
+    {
+        if (IsValidLocation(x, y))
+        {
+            int32_t flattenedIndex = y * m_width + x;
+            m_types[flattenedIndex] = data.GetType();
+            m_visitedFlags[flattenedIndex] = data.IsVisited() ? 1 : 0;
+            m_states[flattenedIndex] = static_cast<uint8_t>(data.GetState());
+        }
+    }
+
+    /**
+     * @brief Gets the plane containing the type of each cell, in row-major order.
+     * @return Type plane
+     */
+    std::span<CellData::Type> GetTypePlane()
+    {
+        return m_types;
+    }
+
+    /**
+     * @brief Gets the plane containing the type of each cell, in row-major order.
+     * @return Type plane
+     */
+    std::span<const CellData::Type> GetTypePlane() const
+    {
+        return m_types;
+    }
+
+    /**
+     * @brief Gets the plane containing the visited flag of each cell, in row-major order.
+     * @return Visited flag plane. 1 if visited, 0 otherwise
+     */
+    std::span<uint8_t> GetVisitedPlane()
+    {
+        return m_visitedFlags;
+    }
+
+    /**
+     * @brief Gets the plane containing the visited flag of each cell, in row-major order.
+     * @return Visited flag plane. 1 if visited, 0 otherwise
+     */
+    std::span<const uint8_t> GetVisitedPlane() const
+    {
+        return m_visitedFlags;
+    }
+
+    /**
+     * @brief Gets the plane containing the state of each cell, in row-major order.
+     * @return State plane
+     */
+    std::span<uint8_t> GetStatePlane()
+    {
+        return m_states;
+    }
+
+    /**
+     * @brief Gets the plane containing the state of each cell, in row-major order.
+     * @return State plane
+     */
+    std::span<const uint8_t> GetStatePlane() const
+    {
+        return m_states;
+    }
+
+    /**
+     * @brief Clears the visited flag and state of every cell, leaving the types untouched.
+     */
+    void ClearVisitedAndStates()
+    {
+        std::fill(m_visitedFlags.begin(), m_visitedFlags.end(), 0);
+        std::fill(m_states.begin(), m_states.end(), 0);
+    }
+
+    /**
+     * @brief Counts the number of unvisited cells of the specified type.
+     * @param[in] type Cell type
+     * @return Number of unvisited cells of the specified type
+     */
+    int32_t CountUnvisited(const CellData::Type& type) const
+    {
+        int32_t count = 0;
+        for (size_t i = 0; i < m_types.size(); ++i)
+        {
+            count += ((m_types[i] == type) & (m_visitedFlags[i] == 0)) ? 1 : 0;
+        }
+
+        return count;
+    }
+};
@@ -0,0 +1,379 @@
+#include "CellScanKernels.hpp"
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define CELL_SCAN_KERNELS_X86
+#include <immintrin.h>
+#endif
+
+namespace
+{
+/**
+ * @brief Counts the cells of a type whose visited flag is 0, one cell at a time
+ */
+int32_t CountUnvisitedScalar(const uint8_t* types, const uint8_t* visitedFlags, size_t count, uint8_t type)
+{
+    int32_t numCells = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        numCells += ((types[i] == type) && (visitedFlags[i] == 0)) ? 1 : 0;
+    }
+
+    return numCells;
+}
+
+/**
+ * @brief Finds the index of the first cell of a type, one cell at a time
+ */
+int32_t FindFirstScalar(const uint8_t* types, size_t count, uint8_t type)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (types[i] == type)
+        {
+            return static_cast<int32_t>(i);
+        }
+    }
+
+    return -1;
+}
+
+/**
+ * @brief Checks whether any cell of a type has a visited flag of 0, one cell at a time
+ */
+bool HasUnvisitedScalar(const uint8_t* types, const uint8_t* visitedFlags, size_t count, uint8_t type)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        if ((types[i] == type) && (visitedFlags[i] == 0))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+#ifdef CELL_SCAN_KERNELS_X86
+/**
+ * @brief Gets the vector with 0xFF for each of the 16 cells of a type whose visited flag is 0, and 0 otherwise
+ */
+__attribute__((target("sse2")))
+inline __m128i GetUnvisitedVectorSSE2(const uint8_t* types, const uint8_t* visitedFlags, __m128i typeVector)
+{
+    __m128i typeMatches = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(types)), typeVector);
+    __m128i unvisited = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(visitedFlags)), _mm_setzero_si128());
+    return _mm_and_si128(typeMatches, unvisited);
+}
+
+/**
+ * @brief Counts the cells of a type whose visited flag is 0, 16 cells at a time. SSE2 has no
+ * popcount, so the matches are summed per byte lane, and the lanes are added up with
+ * _mm_sad_epu8 before they can overflow.
+ */
+__attribute__((target("sse2")))
+int32_t CountUnvisitedSSE2(const uint8_t* types, const uint8_t* visitedFlags, size_t count, uint8_t type)
+{
+    const __m128i typeVector = _mm_set1_epi8(static_cast<char>(type));
+    const __m128i zero = _mm_setzero_si128();
+    __m128i totals = zero;
+    size_t i = 0;
+    while (i + 16 <= count)
+    {
+        size_t blockEnd = ((count - i) / 16 > 255) ? (i + 255 * 16) : count;
+        __m128i laneCounts = zero;
+        for (; i + 16 <= blockEnd; i += 16)
+        {
+            laneCounts = _mm_sub_epi8(laneCounts, GetUnvisitedVectorSSE2(types + i, visitedFlags + i, typeVector));
+        }
+        totals = _mm_add_epi64(totals, _mm_sad_epu8(laneCounts, zero));
+    }
+
+    int32_t numCells = _mm_cvtsi128_si32(totals) + _mm_cvtsi128_si32(_mm_srli_si128(totals, 8));
+    return numCells + CountUnvisitedScalar(types + i, visitedFlags + i, count - i, type);
+}
+
+/**
+ * @brief Finds the index of the first cell of a type, 16 cells at a time
+ */
+__attribute__((target("sse2")))
+int32_t FindFirstSSE2(const uint8_t* types, size_t count, uint8_t type)
+{
+    const __m128i typeVector = _mm_set1_epi8(static_cast<char>(type));
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16)
+    {
+        __m128i typeMatches = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(types + i)), typeVector);
+        uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(typeMatches));
+        if (mask != 0)
+        {
+            return static_cast<int32_t>(i) + std::countr_zero(mask);
+        }
+    }
+
+    int32_t tailIndex = FindFirstScalar(types + i, count - i, type);
+    return (tailIndex == -1) ? -1 : static_cast<int32_t>(i) + tailIndex;
+}
+
+/**
+ * @brief Checks whether any cell of a type has a visited flag of 0, 16 cells at a time
+ */
+__attribute__((target("sse2")))
+bool HasUnvisitedSSE2(const uint8_t* types, const uint8_t* visitedFlags, size_t count, uint8_t type)
+{
+    const __m128i typeVector = _mm_set1_epi8(static_cast<char>(type));
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16)
+    {
+        if (_mm_movemask_epi8(GetUnvisitedVectorSSE2(types + i, visitedFlags + i, typeVector)) != 0)
+        {
+            return true;
+        }
+    }
+
+    return HasUnvisitedScalar(types + i, visitedFlags + i, count - i, type);
+}
+
+/**
+ * @brief Gets the mask of the cells of a type whose visited flag is 0, for 32 cells
+ */
+__attribute__((target("avx2")))
+inline uint32_t GetUnvisitedMaskAVX2(const uint8_t* types, const uint8_t* visitedFlags, __m256i typeVector)
+{
+    __m256i typeMatches = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(types)), typeVector);
+    __m256i unvisited = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(visitedFlags)), _mm256_setzero_si256());
+    return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_and_si256(typeMatches, unvisited)));
+}
+
+/**
+ * @brief Counts the cells of a type whose visited flag is 0, 32 cells at a time
+ */
+__attribute__((target("avx2")))
+int32_t CountUnvisitedAVX2(const uint8_t* types, const uint8_t* visitedFlags, size_t count, uint8_t type)
+{
+    const __m256i typeVector = _mm256_set1_epi8(static_cast<char>(type));
+    int32_t numCells = 0;
+    size_t i = 0;
+    for (; i + 32 <= count; i += 32)
+    {
+        numCells += std::popcount(GetUnvisitedMaskAVX2(types + i, visitedFlags + i, typeVector));
+    }
+
+    return numCells + CountUnvisitedScalar(types + i, visitedFlags + i, count - i, type);
+}
+
+/**
+ * @brief Finds the index of the first cell of a type, 32 cells at a time
+ */
+__attribute__((target("avx2")))
+int32_t FindFirstAVX2(const uint8_t* types, size_t count, uint8_t type)
+{
+    const __m256i typeVector = _mm256_set1_epi8(static_cast<char>(type));
+    size_t i = 0;
+    for (; i + 32 <= count; i += 32)
+    {
+        __m256i typeMatches = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(types + i)), typeVector);
+        uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(typeMatches));
+        if (mask != 0)
+        {
+            return static_cast<int32_t>(i) + std::countr_zero(mask);
+        }
+    }
+
+    int32_t tailIndex = FindFirstScalar(types + i, count - i, type);
+    return (tailIndex == -1) ? -1 : static_cast<int32_t>(i) + tailIndex;
+}
+
+/**
+ * @brief Checks whether any cell of a type has a visited flag of 0, 32 cells at a time
+ */
+__attribute__((target("avx2")))
+bool HasUnvisitedAVX2(const uint8_t* types, const uint8_t* visitedFlags, size_t count, uint8_t type)
+{
+    const __m256i typeVector = _mm256_set1_epi8(static_cast<char>(type));
+    size_t i = 0;
+    for (; i + 32 <= count; i += 32)
+    {
+        if (GetUnvisitedMaskAVX2(types + i, visitedFlags + i, typeVector) != 0)
+        {
+            return true;
+        }
+    }
+
+    return HasUnvisitedScalar(types + i, visitedFlags + i, count - i, type);
+}
+#endif
+}
+
+/**
+ * @brief Constructor. Picks the best kernels supported by the CPU.
+ */
+CellScanKernels::CellScanKernels()
+    : m_simdLevel(SimdLevel::Scalar)
+    , m_countUnvisitedKernel(&CountUnvisitedScalar)
+    , m_findFirstKernel(&FindFirstScalar)
+    , m_hasUnvisitedKernel(&HasUnvisitedScalar)
+{
+    SetSimdLevel(GetSupportedSimdLevel());
+}
+
+/**
+ * @brief Destructor
+ */
+CellScanKernels::~CellScanKernels()
+{
+}
+
+/**
+ * @brief Gets the best instruction set supported by the CPU
+ * @return Best supported instruction set
+ */
+SimdLevel CellScanKernels::GetSupportedSimdLevel()
+{
+#ifdef CELL_SCAN_KERNELS_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+    {
+        return SimdLevel::AVX2;
+    }
+    if (__builtin_cpu_supports("sse2"))
+    {
+        return SimdLevel::SSE2;
+    }
+#endif
+
+    return SimdLevel::Scalar;
+}
+
+/**
+ * @brief Gets the display name of the specified instruction set
+ * @param[in] simdLevel Instruction set
+ * @return Display name
+ */
+const char* CellScanKernels::GetSimdLevelName(const SimdLevel& simdLevel)
+{
+    switch (simdLevel)
+    {
+        case SimdLevel::SSE2:
+            return "SSE2";
+        case SimdLevel::AVX2:
+            return "AVX2";
+        default:
+            return "Scalar";
+    }
+}
+
+/**
+ * @brief Switches to the kernels for the specified instruction set
+ * @param[in] simdLevel Instruction set
+ * @return Returns true if the operation was successful. Returns false if the
+ * CPU does not support the instruction set, in which case the kernels are unchanged
+ */
+bool CellScanKernels::SetSimdLevel(const SimdLevel& simdLevel)
+{
+    if (static_cast<int32_t>(simdLevel) > static_cast<int32_t>(GetSupportedSimdLevel()))
+    {
+        return false;
+    }
+
+    m_simdLevel = simdLevel;
+    switch (simdLevel)
+    {
+#ifdef CELL_SCAN_KERNELS_X86
+        case SimdLevel::SSE2:
+            m_countUnvisitedKernel = &CountUnvisitedSSE2;
+            m_findFirstKernel = &FindFirstSSE2;
+            m_hasUnvisitedKernel = &HasUnvisitedSSE2;
+            break;
+        case SimdLevel::AVX2:
+            m_countUnvisitedKernel = &CountUnvisitedAVX2;
+            m_findFirstKernel = &FindFirstAVX2;
+            m_hasUnvisitedKernel = &HasUnvisitedAVX2;
+            break;
+#endif
+        default:
+            m_countUnvisitedKernel = &CountUnvisitedScalar;
+            m_findFirstKernel = &FindFirstScalar;
+            m_hasUnvisitedKernel = &HasUnvisitedScalar;
+            break;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Gets the instruction set used by the current kernels
+ * @return Instruction set
+ */
+SimdLevel CellScanKernels::GetSimdLevel() const
+{
+    return m_simdLevel;
+}
+
+/**
+ * @brief Clears the visited flag and state of every cell in the grid
+ * @param[in,out] grid Cell grid
+ */
+void CellScanKernels::ResetVisitedAndStates(CellPlaneGrid& grid) const
+{
+    std::span<uint8_t> visitedPlane = grid.GetVisitedPlane();
+    std::span<uint8_t> statePlane = grid.GetStatePlane();
+
+    // memset already uses the widest stores the CPU has, and beats hand-written
+    // kernels at every instruction set
+    std::memset(visitedPlane.data(), 0, visitedPlane.size());
+    std::memset(statePlane.data(), 0, statePlane.size());
+}
+
+/**
+ * @brief Counts the number of unvisited cells of the specified type
+ * @param[in] grid Cell grid
+ * @param[in] type Cell type
+ * @return Number of unvisited cells of the specified type
+ */
+int32_t CellScanKernels::CountUnvisited(const CellPlaneGrid& grid, const CellData::Type& type) const
+{
+    std::span<const CellData::Type> typePlane = grid.GetTypePlane();
+    std::span<const uint8_t> visitedPlane = grid.GetVisitedPlane();
+    return m_countUnvisitedKernel(
+        reinterpret_cast<const uint8_t*>(typePlane.data()),
+        visitedPlane.data(),
+        typePlane.size(),
+        static_cast<uint8_t>(type));
+}
+
+/**
+ * @brief Finds the first cell of the specified type, in row-major order
+ * @param[in] grid Cell grid
+ * @param[in] type Cell type
+ * @return Flattened index (y * width + x) of the cell. Returns -1 if there is no such cell
+ */
+int32_t CellScanKernels::FindFirst(const CellPlaneGrid& grid, const CellData::Type& type) const
+{
+    std::span<const CellData::Type> typePlane = grid.GetTypePlane();
+    return m_findFirstKernel(
+        reinterpret_cast<const uint8_t*>(typePlane.data()),
+        typePlane.size(),
+        static_cast<uint8_t>(type));
+}
+
+/**
+ * @brief Checks if every floor cell in the grid has been visited
+ * @param[in] grid Cell grid
+ * @return Returns true if there is no unvisited floor cell
+ */
+bool CellScanKernels::IsComplete(const CellPlaneGrid& grid) const
+{
+    std::span<const CellData::Type> typePlane = grid.GetTypePlane();
+    std::span<const uint8_t> visitedPlane = grid.GetVisitedPlane();
+    return !m_hasUnvisitedKernel(
+        reinterpret_cast<const uint8_t*>(typePlane.data()),
+        visitedPlane.data(),
+        typePlane.size(),
+        static_cast<uint8_t>(CellData::Type::Floor));
+}
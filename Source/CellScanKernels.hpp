@@ -0,0 +1,119 @@
+#pragma once
+
+#include "CellPlaneGrid.hpp"
+#include "LevelData.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Instruction set used by the cell scan kernels
+ */
+enum class SimdLevel
+{
+    Scalar,
+    SSE2,
+    AVX2
+};
+
+/**
+ * Room-wide scans over the planes of a CellPlaneGrid (resetting the visited
+ * flags, counting unvisited cells, finding a cell and testing completion).
+ * Each scan but the reset has an SSE2 and an AVX2 kernel as well as a scalar
+ * fallback, and the best kernels supported by the CPU are picked at runtime.
+ * The reset is a plain memset, which is already faster than any of them.
+ *
+ * The kernels are standalone: they only run over CellPlaneGrid, which the
+ * engine does not use, so RoomData's reset and completion check do not go
+ * through them.
+ */
+class CellScanKernels
+{
+private:
+    /**
+     * Instruction set used by the current kernels
+     */
+    SimdLevel m_simdLevel;
+
+    /**
+     * Kernel that counts the cells of a type whose visited flag is 0
+     */
+    int32_t (*m_countUnvisitedKernel)(const uint8_t* types, const uint8_t* visitedFlags, size_t count, uint8_t type);
+
+    /**
+     * Kernel that finds the index of the first cell of a type
+     */
+    int32_t (*m_findFirstKernel)(const uint8_t* types, size_t count, uint8_t type);
+
+    /**
+     * Kernel that checks whether any cell of a type has a visited flag of 0
+     */
+    bool (*m_hasUnvisitedKernel)(const uint8_t* types, const uint8_t* visitedFlags, size_t count, uint8_t type);
+
+public:
+    /**
+     * @brief Constructor. Picks the best kernels supported by the CPU.
+     */
+    CellScanKernels();
+
+    /**
+     * @brief Destructor
+     */
+    ~CellScanKernels();
+
+    /**
+     * @brief Gets the best instruction set supported by the CPU
+     * @return Best supported instruction set
+     */
+    static SimdLevel GetSupportedSimdLevel();
+
+    /**
+     * @brief Gets the display name of the specified instruction set
+     * @param[in] simdLevel Instruction set
+     * @return Display name
+     */
+    static const char* GetSimdLevelName(const SimdLevel& simdLevel);
+
+    /**
+     * @brief Switches to the kernels for the specified instruction set
+     * @param[in] simdLevel Instruction set
+     * @return Returns true if the operation was successful. Returns false if the
+     * CPU does not support the instruction set, in which case the kernels are unchanged
+     */
+    bool SetSimdLevel(const SimdLevel& simdLevel);
+
+    /**
+     * @brief Gets the instruction set used by the current kernels
+     * @return Instruction set
+     */
+    SimdLevel GetSimdLevel() const;
+
+    /**
+     * @brief Clears the visited flag and state of every cell in the grid
+     * @param[in,out] grid Cell grid
+     */
+    void ResetVisitedAndStates(CellPlaneGrid& grid) const;
+
+    /**
+     * @brief Counts the number of unvisited cells of the specified type
+     * @param[in] grid Cell grid
+     * @param[in] type Cell type
+     * @return Number of unvisited cells of the specified type
+     */
+    int32_t CountUnvisited(const CellPlaneGrid& grid, const CellData::Type& type) const;
+
+    /**
+     * @brief Finds the first cell of the specified type, in row-major order
+     * @param[in] grid Cell grid
+     * @param[in] type Cell type
+     * @return Flattened index (y * width + x) of the cell. Returns -1 if there is no such cell
+     */
+    int32_t FindFirst(const CellPlaneGrid& grid, const CellData::Type& type) const;
+
+    /**
+     * @brief Checks if every floor cell in the grid has been visited
+     * @param[in] grid Cell grid
+     * @return Returns true if there is no unvisited floor cell
+     */
+    bool IsComplete(const CellPlaneGrid& grid) const;
+};
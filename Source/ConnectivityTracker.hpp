@@ -0,0 +1,445 @@
+#pragma once
+
+#include "ArticulationCheck.hpp"
+#include "Direction.hpp"
+#include "RoomBitboard.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Tracks which cells of a room can still be walked through while a search makes
+ * and undoes moves, to detect dead ends as early as possible.
+ *
+ * A cell is open if it is not a wall and not visited. Ice cells are never visited,
+ * so they stay open. Locked doors are also open, since their switch may still be
+ * pressed later. The cells that must still be visited are the unvisited floors
+ * and the goal.
+ *
+ * Each move only updates the open neighbor count of the cells around the cell it
+ * visits, and undoing the move reverts them. Those counts catch a floor that can
+ * no longer be both entered and left right away. Connectivity is recomputed when
+ * the visited cell is a local cut, i.e. when its open neighbors are not connected
+ * to each other through the eight cells around it, or when the player stops on
+ * ice. It runs the same ArticulationCheck as RoomSolver, then looks for required
+ * cells that ice slides make impossible to reach.
+ */
+template <size_t NumWords>
+class ConnectivityTracker
+{
+public:
+    /**
+     * Bitboard type used for the masks
+     */
+    using Mask = Bitboard<NumWords>;
+
+private:
+    /**
+     * Mask of the open cells
+     */
+    Mask m_openMask;
+
+    /**
+     * Mask of the cells that must still be visited
+     */
+    Mask m_requiredMask;
+
+    /**
+     * Number of open neighbors of each cell
+     */
+    std::array<uint8_t, Mask::NUM_BITS> m_openNeighborCounts;
+
+    /**
+     * Articulation point check run when connectivity is recomputed
+     */
+    ArticulationCheck m_articulationCheck;
+
+    /**
+     * Last cell of the line of ice that a move from each cell in each direction slides
+     * over, or the cell itself if the move does not start with ice. Ice never changes,
+     * so these are only computed once.
+     */
+    std::vector<std::array<int32_t, 4>> m_iceRunEnds;
+
+    /**
+     * Queue of the breadth-first searches over the cells the player can stop on
+     */
+    std::vector<int32_t> m_searchQueue;
+
+    /**
+     * Number of times connectivity had to be recomputed
+     */
+    uint64_t m_numConnectivityChecks;
+
+public:
+    /**
+     * @brief Constructor
+     */
+    ConnectivityTracker()
+        : m_openMask()
+        , m_requiredMask()
+        , m_openNeighborCounts()
+        , m_articulationCheck()
+        , m_iceRunEnds()
+        , m_searchQueue()
+        , m_numConnectivityChecks(0)
+    {
+    }
+
+    /**
+     * @brief Initializes the tracker from the current state of the specified room
+     * @param[in] board Room bitboard
+     */
+    void Build(const RoomBitboard<NumWords>& board)
+    {
+        m_openMask = board.GetRoomMask() & ~(board.GetWallMask() | board.GetVisitedMask());
+        m_requiredMask = board.GetFloorMask() & m_openMask;
+        if (board.GetGoalIndex() != -1)
+        {
+            m_requiredMask.Set(board.GetGoalIndex());
+        }
+        m_numConnectivityChecks = 0;
+
+        m_articulationCheck.Resize(board.GetNumCells());
+        m_iceRunEnds.resize(board.GetNumCells());
+        m_searchQueue.reserve(board.GetNumCells());
+
+        for (int32_t i = 0; i < board.GetNumCells(); ++i)
+        {
+            m_openNeighborCounts[i] = 0;
+            for (Direction direction : ALL_DIRECTIONS)
+            {
+                if (board.HasNeighbor(i, direction) && m_openMask.Test(board.GetNeighborIndex(i, direction)))
+                {
+                    ++m_openNeighborCounts[i];
+                }
+
+                int32_t runEndIndex = i;
+                while (board.HasNeighbor(runEndIndex, direction)
+                    && board.GetIceMask().Test(board.GetNeighborIndex(runEndIndex, direction)))
+                {
+                    runEndIndex = board.GetNeighborIndex(runEndIndex, direction);
+                }
+                m_iceRunEnds[i][static_cast<size_t>(direction)] = runEndIndex;
+            }
+        }
+    }
+
+    /**
+     * @brief Updates the tracker after a move was made on the room
+     * @param[in] board Room bitboard
+     * @param[in] record Record of the changes made by the move
+     */
+    void ApplyMove(const RoomBitboard<NumWords>& board, const RoomMoveRecord& record)
+    {
+        if (record.visitedCellIndex == -1)
+        {
+            return;
+        }
+
+        m_openMask.Reset(record.visitedCellIndex);
+        m_requiredMask.Reset(record.visitedCellIndex);
+        for (Direction direction : ALL_DIRECTIONS)
+        {
+            if (board.HasNeighbor(record.visitedCellIndex, direction))
+            {
+                --m_openNeighborCounts[board.GetNeighborIndex(record.visitedCellIndex, direction)];
+            }
+        }
+    }
+
+    /**
+     * @brief Reverts the changes made to the tracker by a move
+     * @param[in] board Room bitboard
+     * @param[in] record Record of the changes made by the move
+     */
+    void UndoMove(const RoomBitboard<NumWords>& board, const RoomMoveRecord& record)
+    {
+        if (record.visitedCellIndex == -1)
+        {
+            return;
+        }
+
+        m_openMask.Set(record.visitedCellIndex);
+        if (board.GetFloorMask().Test(record.visitedCellIndex) || (record.visitedCellIndex == board.GetGoalIndex()))
+        {
+            m_requiredMask.Set(record.visitedCellIndex);
+        }
+        for (Direction direction : ALL_DIRECTIONS)
+        {
+            if (board.HasNeighbor(record.visitedCellIndex, direction))
+            {
+                ++m_openNeighborCounts[board.GetNeighborIndex(record.visitedCellIndex, direction)];
+            }
+        }
+    }
+
+    /**
+     * @brief Checks whether the room can no longer be completed after a move
+     * @param[in] board Room bitboard
+     * @param[in] previousCellIndex Cell index of the player's position before the move
+     * @param[in] cellIndex Cell index of the player's position after the move
+     * @param[in] record Record of the changes made by the move
+     * @return Returns true if the current search branch is a dead end. Returns false
+     * if the room might still be completed
+     */
+    bool IsDeadEnd(
+        const RoomBitboard<NumWords>& board,
+        const int32_t& previousCellIndex,
+        const int32_t& cellIndex,
+        const RoomMoveRecord& record)
+    {
+        int32_t goalIndex = board.GetGoalIndex();
+        if ((goalIndex == -1) || !m_openMask.Test(goalIndex))
+        {
+            return true;
+        }
+
+        // Only the floors around the cell that got visited and the cells the player
+        // left and entered can have lost a way in or out. Checking them first is
+        // cheap, and avoids recomputing connectivity for most of the dead moves.
+        if (HasStrandedNeighbor(board, previousCellIndex, cellIndex)
+            || HasStrandedNeighbor(board, cellIndex, cellIndex))
+        {
+            return true;
+        }
+
+        // Visiting a cell that is not a local cut keeps the open cells connected the
+        // same way as before the move. Stopping on ice visits nothing, but changes
+        // where the player can slide to from there, so those moves are always checked.
+        if ((record.visitedCellIndex != -1) && !IsLocalCut(board, record.visitedCellIndex))
+        {
+            return false;
+        }
+
+        return !CanReachRequiredCells(board, cellIndex);
+    }
+
+    /**
+     * @brief Checks whether all the cells that must still be visited can be reached
+     * from the specified position, by recomputing connectivity from scratch
+     * @param[in] board Room bitboard
+     * @param[in] cellIndex Cell index of the player's position
+     * @return Returns true if the required cells are reachable. Returns false otherwise
+     */
+    bool CanReachRequiredCells(const RoomBitboard<NumWords>& board, const int32_t& cellIndex)
+    {
+        ++m_numConnectivityChecks;
+        if (m_requiredMask.IsEmpty())
+        {
+            return true;
+        }
+
+        if (!m_articulationCheck.CanVisitRequiredCells(board, m_openMask, m_requiredMask, cellIndex))
+        {
+            return false;
+        }
+
+        return CanSlideToRequiredCells(board, cellIndex);
+    }
+
+    /**
+     * @brief Gets the number of times connectivity had to be recomputed since the tracker was built
+     * @return Number of connectivity checks
+     */
+    uint64_t GetNumConnectivityChecks() const
+    {
+        return m_numConnectivityChecks;
+    }
+
+private:
+    /**
+     * @brief Checks whether every cell that must still be visited, the goal included,
+     * can be reached from the specified position with actual moves. Ice makes moves
+     * one-way, so this catches parts of the room that the player can never slide into.
+     * @param[in] board Room bitboard
+     * @param[in] cellIndex Cell index of the player's position
+     * @return Returns true if every required cell can be reached. Returns false otherwise
+     */
+    bool CanSlideToRequiredCells(const RoomBitboard<NumWords>& board, const int32_t& cellIndex)
+    {
+        // Breadth-first search over the cells the player can stop on. The goal ends
+        // the room, so no moves are made from it.
+        int32_t goalIndex = board.GetGoalIndex();
+        Mask passableMask = m_openMask & ~board.GetLockedDoorMask();
+        Mask reachedMask;
+        reachedMask.Set(cellIndex);
+        m_searchQueue.clear();
+        m_searchQueue.push_back(cellIndex);
+        size_t queueIndex = 0;
+        while (true)
+        {
+            for (; queueIndex < m_searchQueue.size(); ++queueIndex)
+            {
+                int32_t currentIndex = m_searchQueue[queueIndex];
+                if (currentIndex == goalIndex)
+                {
+                    continue;
+                }
+
+                for (Direction direction : ALL_DIRECTIONS)
+                {
+                    // Ice is never visited, so a move always slides over it. The player stops
+                    // on the cell after the ice if it can be entered, or on the last ice cell
+                    // once that cell is blocked, which every cell that is not ice can become.
+                    int32_t stopIndex = m_iceRunEnds[currentIndex][static_cast<size_t>(direction)];
+
+                    if ((stopIndex != currentIndex) && !reachedMask.Test(stopIndex))
+                    {
+                        reachedMask.Set(stopIndex);
+                        m_searchQueue.push_back(stopIndex);
+                    }
+
+                    if (board.HasNeighbor(stopIndex, direction))
+                    {
+                        int32_t targetIndex = board.GetNeighborIndex(stopIndex, direction);
+                        if (passableMask.Test(targetIndex) && !reachedMask.Test(targetIndex))
+                        {
+                            reachedMask.Set(targetIndex);
+                            m_searchQueue.push_back(targetIndex);
+                        }
+                    }
+                }
+            }
+
+            // A locked door opens once its switch has been reached. Doors are not ice,
+            // so the only moves that change are the ones that used to stop right next
+            // to the door, which can now stop on the door instead.
+            Mask openedDoorMask = board.GetLinkedDoorMask(reachedMask & board.GetSwitchMask()) & m_openMask & ~passableMask;
+            if (openedDoorMask.IsEmpty())
+            {
+                break;
+            }
+            passableMask |= openedDoorMask;
+
+            Mask movableMask = reachedMask;
+            movableMask.Reset(goalIndex);
+            Mask enteredDoorMask = board.GetNeighborMask(movableMask) & openedDoorMask;
+            while (!enteredDoorMask.IsEmpty())
+            {
+                int32_t doorIndex = enteredDoorMask.FindFirst();
+                enteredDoorMask.Reset(doorIndex);
+                reachedMask.Set(doorIndex);
+                m_searchQueue.push_back(doorIndex);
+            }
+        }
+
+        return (m_requiredMask & ~reachedMask).IsEmpty();
+    }
+
+    /**
+     * @brief Checks whether any unvisited floor next to the specified cell can no
+     * longer be both entered and left
+     * @param[in] board Room bitboard
+     * @param[in] centerIndex Cell index whose neighbors are checked
+     * @param[in] playerIndex Cell index of the player's position
+     * @return Returns true if a floor is stranded. Returns false otherwise
+     */
+    bool HasStrandedNeighbor(const RoomBitboard<NumWords>& board, const int32_t& centerIndex, const int32_t& playerIndex) const
+    {
+        for (Direction direction : ALL_DIRECTIONS)
+        {
+            if (!board.HasNeighbor(centerIndex, direction))
+            {
+                continue;
+            }
+
+            int32_t neighborIndex = board.GetNeighborIndex(centerIndex, direction);
+            if (board.GetFloorMask().Test(neighborIndex) && m_openMask.Test(neighborIndex)
+                && IsStranded(board, neighborIndex, playerIndex))
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    /**
+     * @brief Checks whether the specified unvisited floor can no longer be both entered and left
+     * @param[in] board Room bitboard
+     * @param[in] floorIndex Cell index of the floor
+     * @param[in] playerIndex Cell index of the player's position
+     * @return Returns true if the floor is stranded. Returns false otherwise
+     */
+    bool IsStranded(const RoomBitboard<NumWords>& board, const int32_t& floorIndex, const int32_t& playerIndex) const
+    {
+        int32_t numWays = m_openNeighborCounts[floorIndex];
+        for (Direction direction : ALL_DIRECTIONS)
+        {
+            if (!board.HasNeighbor(floorIndex, direction))
+            {
+                continue;
+            }
+
+            int32_t neighborIndex = board.GetNeighborIndex(floorIndex, direction);
+            if (board.GetIceMask().Test(neighborIndex))
+            {
+                // The floor can be entered from and left through the same ice cell
+                return false;
+            }
+            if (neighborIndex == playerIndex)
+            {
+                // The player's cell is a way in. If it is still open, i.e. a start
+                // that is not a floor, it is also a way back out.
+                ++numWays;
+            }
+        }
+
+        return numWays < 2;
+    }
+
+    /**
+     * @brief Checks whether the open neighbors of the specified cell are not all
+     * connected to each other through the eight cells around it. Visiting a cell
+     * that is not a local cut never splits the open cells.
+     * @param[in] board Room bitboard
+     * @param[in] cellIndex Cell index
+     * @return Returns true if the cell is a local cut. Returns false otherwise
+     */
+    bool IsLocalCut(const RoomBitboard<NumWords>& board, const int32_t& cellIndex) const
+    {
+        // Neighbors in clockwise order, so that consecutive ones share a diagonal cell
+        constexpr std::array<Direction, 4> CLOCKWISE_DIRECTIONS =
+        {
+            Direction::Up,
+            Direction::Right,
+            Direction::Down,
+            Direction::Left
+        };
+
+        std::array<bool, 4> isOpen {};
+        int32_t numOpenNeighbors = 0;
+        for (size_t i = 0; i < CLOCKWISE_DIRECTIONS.size(); ++i)
+        {
+            Direction direction = CLOCKWISE_DIRECTIONS[i];
+            isOpen[i] = board.HasNeighbor(cellIndex, direction)
+                && m_openMask.Test(board.GetNeighborIndex(cellIndex, direction));
+            numOpenNeighbors += isOpen[i] ? 1 : 0;
+        }
+
+        int32_t numLinks = 0;
+        for (size_t i = 0; i < CLOCKWISE_DIRECTIONS.size(); ++i)
+        {
+            size_t nextIndex = (i + 1) % CLOCKWISE_DIRECTIONS.size();
+            if (!isOpen[i] || !isOpen[nextIndex])
+            {
+                continue;
+            }
+
+            int32_t neighborIndex = board.GetNeighborIndex(cellIndex, CLOCKWISE_DIRECTIONS[i]);
+            if (board.HasNeighbor(neighborIndex, CLOCKWISE_DIRECTIONS[nextIndex])
+                && m_openMask.Test(board.GetNeighborIndex(neighborIndex, CLOCKWISE_DIRECTIONS[nextIndex])))
+            {
+                ++numLinks;
+            }
+        }
+
+        // Open neighbors form a ring when all four are linked
+        int32_t numLocalComponents = numOpenNeighbors - ((numLinks == 4) ? 3 : numLinks);
+        return numLocalComponents > 1;
+    }
+};
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+/**
+ * Direction of a single player move
+ */
+enum class Direction : uint8_t
+{
+    Up,
+    Down,
+    Left,
+    Right
+};
+
+/**
+ * List of all the directions, in the order the player can input them
+ */
+constexpr std::array<Direction, 4> ALL_DIRECTIONS =
+{
+    Direction::Up,
+    Direction::Down,
+    Direction::Left,
+    Direction::Right
+};
+
+/**
+ * @brief Gets the move amount in the x-axis for the specified direction
+ * @param[in] direction Direction
+ * @return Move amount in the x-axis
+ */
+constexpr int32_t GetDirectionX(const Direction& direction)
+{
+    return (direction == Direction::Left) ? -1 : ((direction == Direction::Right) ? 1 : 0);
+}
+
+/**
+ * @brief Gets the move amount in the y-axis for the specified direction
+ * @param[in] direction Direction
+ * @return Move amount in the y-axis
+ */
+constexpr int32_t GetDirectionY(const Direction& direction)
+{
+    return (direction == Direction::Up) ? -1 : ((direction == Direction::Down) ? 1 : 0);
+}
+
+/**
+ * @brief Gets the character used to represent the specified direction in move sequences
+ * @param[in] direction Direction
+ * @return 'U', 'D', 'L' or 'R'
+ */
+constexpr char GetDirectionChar(const Direction& direction)
+{
+    constexpr char DIRECTION_CHARS[] = { 'U', 'D', 'L', 'R' };
+    return DIRECTION_CHARS[static_cast<uint8_t>(direction)];
+}
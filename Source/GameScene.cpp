@@ -2,11 +2,13 @@
 
 #include "Constants.hpp"
 #include "LevelData.hpp"
+#include "ReplayData.hpp"
 
 #include <array>
 #include <cctype>
 #include <iostream>
 #include <raylib.h>
+#include <span>
 #include <string>
 
 #define CELL_SIZE 40.0f
@@ -21,6 +23,8 @@
 
 #define SLIDE_DURATION 0.1f
 
+#define REPLAY_FILE_PATH "replays.dat"
+
 /**
  * @brief Constructor
  */
@@ -30,6 +34,7 @@ GameScene::GameScene(SceneManager *sceneManager)
     , m_levels()
     , m_currentLevelIndex(-1)
     , m_currentRoomIndex(-1)
+    , m_simulator()
     , m_playerPositionX(0)
     , m_playerPositionY(0)
     , m_playerVisualScale(1.0f)
@@ -37,15 +42,20 @@ GameScene::GameScene(SceneManager *sceneManager)
     , m_startLevelFadeInTimer(0.0f)
     , m_endLevelFadeOutTimer(0.0f)
     , m_resetButtonBounds()
+    , m_undoButtonBounds()
+    , m_redoButtonBounds()
     , m_backToTitleButton()
-    , m_slideDirectionX(-1)
-    , m_slideDirectionY(-1)
+    , m_slideDirection(Direction::Up)
     , m_slideTimer(0.0f)
+    , m_numSlideCellsLeft(0)
     , m_isSliding(false)
     , m_moveUpKeys()
     , m_moveDownKeys()
     , m_moveLeftKeys()
     , m_moveRightKeys()
+    , m_resetRoomKeys()
+    , m_undoMoveKeys()
+    , m_redoMoveKeys()
     , m_textures()
 {
 }
@@ -100,11 +110,27 @@ void GameScene::Begin()
 
     m_resetRoomKeys.push_back(KEY_R);
 
+    m_undoMoveKeys.push_back(KEY_Z);
+    m_undoMoveKeys.push_back(KEY_BACKSPACE);
+
+    m_redoMoveKeys.push_back(KEY_Y);
+
     m_resetButtonBounds.width = 140.0f;
     m_resetButtonBounds.height = 50.0f;
     m_resetButtonBounds.x = GetScreenWidth() - m_resetButtonBounds.width - 10.0f;
     m_resetButtonBounds.y = GetScreenHeight() - m_resetButtonBounds.height - 10.0f;
 
+    // Undo and redo buttons sit to the left of the reset button
+    m_redoButtonBounds.width = 130.0f;
+    m_redoButtonBounds.height = m_resetButtonBounds.height;
+    m_redoButtonBounds.x = m_resetButtonBounds.x - m_redoButtonBounds.width - 10.0f;
+    m_redoButtonBounds.y = m_resetButtonBounds.y;
+
+    m_undoButtonBounds.width = 130.0f;
+    m_undoButtonBounds.height = m_resetButtonBounds.height;
+    m_undoButtonBounds.x = m_redoButtonBounds.x - m_undoButtonBounds.width - 10.0f;
+    m_undoButtonBounds.y = m_resetButtonBounds.y;
+
     m_backToTitleButton.width = 200.0f;
     m_backToTitleButton.height = 50.0f;
     m_backToTitleButton.x = (GetScreenWidth() - m_backToTitleButton.width) / 2.0f;
@@ -134,55 +160,69 @@ void GameScene::Update(const float& deltaTime)
             return;
         }
 
+        // Undo and redo wait for the current slide to finish, so that a slide is
+        // always undone as a whole
+        if ((m_currentLevelIndex >= 0) && (m_currentRoomIndex >= 0) && !m_isSliding)
+        {
+            if ((IsMouseButtonPressed(MOUSE_BUTTON_LEFT) && CheckCollisionPointRec(mousePosition, m_undoButtonBounds))
+                || IsAnyKeyPressed(m_undoMoveKeys))
+            {
+                if (m_simulator.UndoMove())
+                {
+                    UpdatePlayerFromSimulator();
+                }
+                return;
+            }
+
+            if ((IsMouseButtonPressed(MOUSE_BUTTON_LEFT) && CheckCollisionPointRec(mousePosition, m_redoButtonBounds))
+                || IsAnyKeyPressed(m_redoMoveKeys))
+            {
+                if (m_simulator.RedoMove())
+                {
+                    UpdatePlayerFromSimulator();
+                }
+                return;
+            }
+        }
+
         if ((m_currentLevelIndex >= 0) && (m_currentRoomIndex >= 0))
         {
             if (m_isSliding)
             {
+                // The end of the slide is already known, so the room only
+                // changes once the player reaches it
                 m_slideTimer -= deltaTime;
                 if (m_slideTimer <= 0.0f)
                 {
                     m_slideTimer = SLIDE_DURATION;
-                    Move(m_slideDirectionX, m_slideDirectionY);
+                    m_playerPositionX += GetDirectionX(m_slideDirection);
+                    m_playerPositionY += GetDirectionY(m_slideDirection);
 
-                    LevelData &levelData = m_levels[m_currentLevelIndex];
-                    RoomData &roomData = levelData.rooms[m_currentRoomIndex];
-
-                    int32_t nextPlayerX = m_playerPositionX + m_slideDirectionX;
-                    int32_t nextPlayerY = m_playerPositionY + m_slideDirectionY;
-
-                    CellData *currentCellData = roomData.cells.Get(m_playerPositionX, m_playerPositionY);
-                    CellData *nextCellData = roomData.cells.Get(nextPlayerX, nextPlayerY);
-                    if (!IsTraversible(nextCellData) 
-                        || (currentCellData->type != CellData::Type::Ice))
+                    --m_numSlideCellsLeft;
+                    if (m_numSlideCellsLeft <= 0)
                     {
                         m_isSliding = false;
+                        ApplyMove(m_slideDirection);
                     }
                 }
             }
             else
             {
-                int32_t moveX = 0, moveY = 0;
                 if (IsAnyKeyPressed(m_moveUpKeys))
                 {
-                    moveY = -1;
+                    Move(Direction::Up);
                 }
                 else if (IsAnyKeyPressed(m_moveDownKeys))
                 {
-                    moveY = 1;
+                    Move(Direction::Down);
                 }
-
-                if (IsAnyKeyPressed(m_moveLeftKeys))
+                else if (IsAnyKeyPressed(m_moveLeftKeys))
                 {
-                    moveX = -1;
+                    Move(Direction::Left);
                 }
                 else if (IsAnyKeyPressed(m_moveRightKeys))
                 {
-                    moveX = 1;
-                }
-
-                if ((moveX != 0) || (moveY != 0))
-                {
-                    Move(moveX, moveY);
+                    Move(Direction::Right);
                 }
             }
         }
@@ -294,17 +334,18 @@ void GameScene::Draw()
         };
 
         // Draw grid
-        for (int32_t x = 0; x < roomWidth; ++x)
+        for (int32_t y = 0; y < roomHeight; ++y)
         {
-            for (int32_t y = 0; y < roomHeight; ++y)
+            std::span<CellData> row = roomData.cells.GetRow(y);
+            for (int32_t x = 0; x < roomWidth; ++x)
             {
-                CellData *cellData = roomData.cells.Get(x, y);
-                if (cellData->type == CellData::Type::Empty)
+                CellData *cellData = &row[x];
+                if (cellData->GetType() == CellData::Type::Empty)
                 {
                 }
-                else if (cellData->type == CellData::Type::Switch)
+                else if (cellData->GetType() == CellData::Type::Switch)
                 {
-                    if (cellData->state == Constants::SWITCH_UNPRESSED_STATE)
+                    if (cellData->GetState() == Constants::SWITCH_UNPRESSED_STATE)
                     {
                         DrawCircle(offset.x + (x + 0.5f) * CELL_SIZE, offset.y + (y + 0.5f) * CELL_SIZE, SWITCH_RADIUS, RED);
 
@@ -325,9 +366,9 @@ void GameScene::Draw()
                         }
                     }
                 }
-                else if (cellData->type == CellData::Type::Door)
+                else if (cellData->GetType() == CellData::Type::Door)
                 {
-                    if (cellData->state == Constants::DOOR_LOCKED_STATE)
+                    if (cellData->GetState() == Constants::DOOR_LOCKED_STATE)
                     {
                         DrawRectangle(offset.x + x * CELL_SIZE, offset.y + y * CELL_SIZE, CELL_SIZE, CELL_SIZE, BROWN);
 
@@ -348,12 +389,12 @@ void GameScene::Draw()
                         }
                     }
                 }
-                else if (cellData->type == CellData::Type::Floor)
+                else if (cellData->GetType() == CellData::Type::Floor)
                 {
                 }
-                else if (cellData->type == CellData::Type::Goal)
+                else if (cellData->GetType() == CellData::Type::Goal)
                 {
-                    if (IsRoomComplete(roomData))
+                    if (roomData.IsComplete())
                     {
                         DrawRectangle(offset.x + x * CELL_SIZE, offset.y + y * CELL_SIZE, CELL_SIZE, CELL_SIZE, GREEN);
                     }
@@ -375,11 +416,11 @@ void GameScene::Draw()
                         BLACK
                     );
                 }
-                else if (cellData->type == CellData::Type::Wall)
+                else if (cellData->GetType() == CellData::Type::Wall)
                 {
                     DrawRectangle(offset.x + x * CELL_SIZE, offset.y + y * CELL_SIZE, CELL_SIZE, CELL_SIZE, GRAY);
                 }
-                else if (cellData->type == CellData::Type::Ice)
+                else if (cellData->GetType() == CellData::Type::Ice)
                 {
                     /*DrawTextureEx(
                         m_textures[Constants::SLIDE_UP_TEXTURE_NAME],
@@ -400,12 +441,13 @@ void GameScene::Draw()
         }
 
         // Overlay a red rectangle on top of visited cells
-        for (int32_t x = 0; x < roomWidth; ++x)
+        for (int32_t y = 0; y < roomHeight; ++y)
         {
-            for (int32_t y = 0; y < roomHeight; ++y)
+            std::span<CellData> row = roomData.cells.GetRow(y);
+            for (int32_t x = 0; x < roomWidth; ++x)
             {
-                CellData *cellData = roomData.cells.Get(x, y);
-                if (cellData->isVisited
+                CellData *cellData = &row[x];
+                if (cellData->IsVisited()
                     && ((m_playerPositionX != x) || (m_playerPositionY != y)))
                 {
                     DrawRectangle(offset.x + x * CELL_SIZE, offset.y + y * CELL_SIZE, CELL_SIZE, CELL_SIZE, ColorAlpha(RED, 0.75f));
@@ -417,29 +459,10 @@ void GameScene::Draw()
         float playerRadius = (CELL_SIZE - 6.0f) / 2.0f * m_playerVisualScale;
         DrawCircle(offset.x + (m_playerPositionX + 0.5f) * CELL_SIZE, offset.y + (m_playerPositionY + 0.5f) * CELL_SIZE, playerRadius, BLUE);
 
-        // Draw reset button
-        std::string resetText = "Reset (R)";
-        float resetTextFontSize = 24.0f;
-        const int32_t resetButtonOutlineThickness = 4;
-        DrawRectangleRec(m_resetButtonBounds, BLACK);
-        DrawRectangle(
-            m_resetButtonBounds.x + resetButtonOutlineThickness,
-            m_resetButtonBounds.y + resetButtonOutlineThickness,
-            m_resetButtonBounds.width - resetButtonOutlineThickness * 2,
-            m_resetButtonBounds.height - resetButtonOutlineThickness * 2,
-            WHITE
-        );
-        int32_t resetTextWidth = MeasureText(
-            resetText.c_str(),
-            resetTextFontSize);
-        float resetTextPaddingLeft = (m_resetButtonBounds.width - resetTextWidth) / 2.0f;
-        float resetTextPaddingTop = (m_resetButtonBounds.height - resetTextFontSize) / 2.0f;
-        DrawText(
-            resetText.c_str(),
-            m_resetButtonBounds.x + resetTextPaddingLeft,
-            m_resetButtonBounds.y + resetTextPaddingTop,
-            resetTextFontSize,
-            BLACK);
+        // Draw undo, redo and reset buttons
+        DrawButton(m_undoButtonBounds, "Undo (Z)");
+        DrawButton(m_redoButtonBounds, "Redo (Y)");
+        DrawButton(m_resetButtonBounds, "Reset (R)");
 
         // Draw instructions text
         std::string instructionsText = "W/A/S/D/Arrow Keys - Move";
@@ -556,103 +579,109 @@ void GameScene::End()
 }
 
 /**
- * @brief Queries whether the specified cell type is traversible by the player or not
- * @param[in] cellData Cell data
- * @return Returns true if the specified cell type is traversible. Returns false otherwise
+ * @brief Moves the player in the specified direction within the grid. If the move
+ * enters ice, the player's visual starts sliding towards the end of the slide,
+ * and the move is only applied to the room once it gets there
+ * @param[in] direction Direction of the move
  */
-bool GameScene::IsTraversible(const CellData* cellData)
+bool GameScene::Move(const Direction& direction)
 {
-    if (cellData == nullptr)
+    SlideData slide = m_simulator.GetSlide(direction);
+    if (slide.length == 0)
     {
         return false;
     }
-    if (cellData->type == CellData::Type::Wall)
-    {
-        return false;
-    }
-    if (cellData->isVisited)
+
+    if (slide.length > 1)
     {
-        return false;
+        m_playerPositionX += GetDirectionX(direction);
+        m_playerPositionY += GetDirectionY(direction);
+
+        m_isSliding = true;
+        m_slideDirection = direction;
+        m_slideTimer = SLIDE_DURATION;
+        m_numSlideCellsLeft = slide.length - 1;
     }
-    if ((cellData->type == CellData::Type::Door)
-        && (cellData->state == Constants::DOOR_LOCKED_STATE))
+    else
     {
-        return false;
+        ApplyMove(direction);
     }
 
     return true;
 }
 
 /**
- * @brief Moves the player by the specified move amount within the grid
- * @param[in] moveX Move amount in the x-axis
- * @param[in] moveY Move amount in the y-axis
+ * @brief Applies the specified move to the room simulator
+ * @param[in] direction Direction of the move
  */
-bool GameScene::Move(const int32_t& moveX, const int32_t& moveY)
+void GameScene::ApplyMove(const Direction& direction)
 {
-    LevelData &levelData = m_levels[m_currentLevelIndex];
-    RoomData &roomData = levelData.rooms[m_currentRoomIndex];
-
-    int32_t currentPlayerX = m_playerPositionX;
-    int32_t currentPlayerY = m_playerPositionY;
-    int32_t newPlayerX = currentPlayerX + moveX;
-    int32_t newPlayerY = currentPlayerY + moveY;
-    if (roomData.cells.IsValidLocation(newPlayerX, newPlayerY)
-        && IsTraversible(roomData.cells.Get(newPlayerX, newPlayerY)))
-    {
-        m_playerPositionX = newPlayerX;
-        m_playerPositionY = newPlayerY;
-
-        CellData *cellData = roomData.cells.Get(newPlayerX, newPlayerY);
-        if (cellData->type != CellData::Type::Ice)
-        {
-            cellData->isVisited = true;
-        }
-
-        if ((currentPlayerX != newPlayerX)
-            || (currentPlayerY != newPlayerY))
-        {
-            if (cellData->type == CellData::Type::Floor)
-            {
-            }
-            else if (cellData->type == CellData::Type::Switch)
-            {
-                int32_t switchId = roomData.GetSwitchIdFromSwitchPosition(newPlayerX, newPlayerY);
-                if (switchId != -1)
-                {
-                    cellData->state = Constants::SWITCH_PRESSED_STATE;
-
-                    SwitchDoorMapping &mapping = roomData.switchDoorMappings[switchId];
-                    CellData *doorCell = roomData.cells.Get(mapping.doorX, mapping.doorY);
-                    doorCell->state = Constants::DOOR_UNLOCKED_STATE;
-                }
-            }
-            else if (cellData->type == CellData::Type::Goal)
-            {
-                if (cellData->state == Constants::GOAL_UNLOCKED_STATE)
-                {
-                    m_currentState = State::EndRoom;
-                }
-            }
-            else if (cellData->type == CellData::Type::Ice)
-            {
-                m_isSliding = true;
-                m_slideDirectionX = moveX;
-                m_slideDirectionY = moveY;
-                m_slideTimer = SLIDE_DURATION;
-            }
+    m_simulator.ApplyMove(direction);
+    UpdatePlayerFromSimulator();
+}
 
-            if (IsRoomComplete(roomData))
-            {
-                CellData *goalCell = roomData.cells.Get(roomData.goalX, roomData.goalY);
-                goalCell->state = Constants::GOAL_UNLOCKED_STATE;
-            }
-        }
+/**
+ * @brief Moves the player's visual to the simulator's player position, and ends
+ * the room if the player entered the unlocked goal
+ */
+void GameScene::UpdatePlayerFromSimulator()
+{
+    m_playerPositionX = m_simulator.GetPlayerX();
+    m_playerPositionY = m_simulator.GetPlayerY();
+    if (m_simulator.HasReachedGoal())
+    {
+        SaveReplay();
+        m_currentState = State::EndRoom;
+    }
+}
 
-        return true;
+/**
+ * @brief Appends the moves made to complete the current room to the replay file,
+ * if the game was built with RECORD_REPLAYS. Does nothing otherwise
+ */
+void GameScene::SaveReplay()
+{
+#ifdef RECORD_REPLAYS
+    // Level files are numbered from 1, in the same order as the levels are loaded
+    ReplayData replayData;
+    replayData.levelId = m_currentLevelIndex + 1;
+    replayData.roomIndex = m_currentRoomIndex;
+    m_simulator.GetMoves(replayData.moves);
+    if (!replayData.AppendToFile(REPLAY_FILE_PATH))
+    {
+        std::cerr << "Failed to save replay to " << REPLAY_FILE_PATH << "!" << std::endl;
     }
+#endif
+}
 
-    return false;
+/**
+ * @brief Draws a button with a black outline and the specified text centered in it
+ * @param[in] bounds Button bounds
+ * @param[in] text Button text
+ */
+void GameScene::DrawButton(const Rectangle& bounds, const std::string& text)
+{
+    float textFontSize = 24.0f;
+    const int32_t outlineThickness = 4;
+    DrawRectangleRec(bounds, BLACK);
+    DrawRectangle(
+        bounds.x + outlineThickness,
+        bounds.y + outlineThickness,
+        bounds.width - outlineThickness * 2,
+        bounds.height - outlineThickness * 2,
+        WHITE
+    );
+    int32_t textWidth = MeasureText(
+        text.c_str(),
+        textFontSize);
+    float textPaddingLeft = (bounds.width - textWidth) / 2.0f;
+    float textPaddingTop = (bounds.height - textFontSize) / 2.0f;
+    DrawText(
+        text.c_str(),
+        bounds.x + textPaddingLeft,
+        bounds.y + textPaddingTop,
+        textFontSize,
+        BLACK);
 }
 
 /**
@@ -697,59 +726,7 @@ void GameScene::ResetCurrentRoom()
     }
 
     LevelData &levelData = m_levels[m_currentLevelIndex];
-    RoomData &roomData = levelData.rooms[m_currentRoomIndex];
-    m_playerPositionX = roomData.playerStartX;
-    m_playerPositionY = roomData.playerStartY;
-
-    int32_t roomWidth = roomData.cells.GetWidth();
-    int32_t roomHeight = roomData.cells.GetHeight();
-    for (int32_t x = 0; x < roomWidth; ++x)
-    {
-        for (int32_t y = 0; y < roomHeight; ++y)
-        {
-            CellData *cellData = roomData.cells.Get(x, y);
-            cellData->state = 0;
-            cellData->isVisited = false;
-        }
-    }
-
-    CellData *playerCell = roomData.cells.Get(m_playerPositionX, m_playerPositionY);
-    if ((playerCell != nullptr)
-        && (playerCell->type == CellData::Type::Floor))
-    {
-        playerCell->isVisited = true;
-    }
-
-    CellData *goalCell = roomData.cells.Get(roomData.goalX, roomData.goalY);
-    if (goalCell != nullptr)
-    {
-        goalCell->state = Constants::GOAL_LOCKED_STATE;
-    }
-}
-
-/**
- * @brief Checks if the specified room is completed or not
- * @param[in] roomData Room data
- * @return Returns true if the specified room is completed
- */
-bool GameScene::IsRoomComplete(RoomData &roomData)
-{
-    int32_t roomWidth = roomData.cells.GetWidth();
-    int32_t roomHeight = roomData.cells.GetHeight();
-    for (int32_t x = 0; x < roomWidth; ++x)
-    {
-        for (int32_t y = 0; y < roomHeight; ++y)
-        {
-            CellData *cellData = roomData.cells.Get(x, y);
-            if (cellData->type == CellData::Type::Floor)
-            {
-                if (!cellData->isVisited)
-                {
-                    return false;
-                }
-            }
-        }
-    }
-
-    return true;
+    m_simulator.Reset(&levelData.rooms[m_currentRoomIndex]);
+    m_playerPositionX = m_simulator.GetPlayerX();
+    m_playerPositionY = m_simulator.GetPlayerY();
 }
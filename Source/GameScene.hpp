@@ -1,6 +1,8 @@
 #pragma once
 
+#include "Direction.hpp"
 #include "LevelData.hpp"
+#include "RoomSimulator.hpp"
 #include "Scene.hpp"
 #include "SceneManager.hpp"
 
@@ -53,12 +55,19 @@ private:
     int32_t m_currentRoomIndex;
 
     /**
-     * Current X-position of the player
+     * Simulator playing the current room
+     */
+    RoomSimulator m_simulator;
+
+    /**
+     * Current X-position of the player's visual, which lags behind the simulator
+     * while sliding
      */
     int32_t m_playerPositionX;
 
     /**
-     * Current Y-position of the player
+     * Current Y-position of the player's visual, which lags behind the simulator
+     * while sliding
      */
     int32_t m_playerPositionY;
 
@@ -88,25 +97,36 @@ private:
     Rectangle m_resetButtonBounds;
 
     /**
-     * Back to title button bounds
+     * Undo button bounds
      */
-    Rectangle m_backToTitleButton;
+    Rectangle m_undoButtonBounds;
 
     /**
-     * Slide X-direction
+     * Redo button bounds
      */
-    int32_t m_slideDirectionX;
+    Rectangle m_redoButtonBounds;
+
+    /**
+     * Back to title button bounds
+     */
+    Rectangle m_backToTitleButton;
 
     /**
-     * Slide Y-direction
+     * Slide direction
      */
-    int32_t m_slideDirectionY;
+    Direction m_slideDirection;
 
     /**
      * Timer for sliding to the next cell
      */
     float m_slideTimer;
 
+    /**
+     * Number of cells left to slide over before the player's visual reaches the
+     * end of the slide
+     */
+    int32_t m_numSlideCellsLeft;
+
     /**
      * Flag indicating whether we are currently sliding
      */
@@ -137,6 +157,16 @@ private:
      */
     std::vector<uint32_t> m_resetRoomKeys;
 
+    /**
+     * List of accepted keys to undo the last move
+     */
+    std::vector<uint32_t> m_undoMoveKeys;
+
+    /**
+     * List of accepted keys to redo the last undone move
+     */
+    std::vector<uint32_t> m_redoMoveKeys;
+
     /**
      * Map of strings and their corresponding textures
      */
@@ -176,21 +206,40 @@ public:
 
 private:
     /**
-     * @brief Queries whether the specified cell type is traversible by the player or not
-     * @param[in] cellData Cell data
-     * @return Returns true if the specified cell type is traversible. Returns false otherwise
-     */
-    bool IsTraversible(const CellData* cellData);
-
-    /**
-     * @brief Moves the player by the specified move amount within the grid
-     * @param[in] moveX Move amount in the x-axis
-     * @param[in] moveY Move amount in the y-axis
+     * @brief Moves the player in the specified direction within the grid. If the move
+     * enters ice, the player's visual starts sliding towards the end of the slide,
+     * and the move is only applied to the room once it gets there
+     * @param[in] direction Direction of the move
      * @return Returns true if the movement was successful 
      * (not hitting a wall, not going into a visited cell). 
      * Returns false otherwise.
      */
-    bool Move(const int32_t& moveX, const int32_t& moveY);
+    bool Move(const Direction& direction);
+
+    /**
+     * @brief Applies the specified move to the room simulator
+     * @param[in] direction Direction of the move
+     */
+    void ApplyMove(const Direction& direction);
+
+    /**
+     * @brief Moves the player's visual to the simulator's player position, and ends
+     * the room if the player entered the unlocked goal
+     */
+    void UpdatePlayerFromSimulator();
+
+    /**
+     * @brief Appends the moves made to complete the current room to the replay file,
+     * if the game was built with RECORD_REPLAYS. Does nothing otherwise
+     */
+    void SaveReplay();
+
+    /**
+     * @brief Draws a button with a black outline and the specified text centered in it
+     * @param[in] bounds Button bounds
+     * @param[in] text Button text
+     */
+    void DrawButton(const Rectangle& bounds, const std::string& text);
 
     /**
      * @brief Queries whether any of the keys in the specified list of keys 
@@ -210,11 +259,4 @@ private:
      * @brief Resets the current room
      */
     void ResetCurrentRoom();
-
-    /**
-     * @brief Checks if the specified room is completed or not
-     * @param[in] roomData Room data
-     * @return Returns true if the specified room is completed
-     */
-    bool IsRoomComplete(RoomData &roomData);
 };
@@ -1,12 +1,13 @@
 #pragma once
 
 #include <cstdint>
+#include <span>
 #include <vector>
 
 /**
  * Grid
  */
- template <typename T>
+template <typename T>
 class Grid
 {
 private:
@@ -80,7 +81,7 @@ public:
      * @param[in] y Y-coordinate
      * @return Returns true if the specified location is valid. Returns false otherwise.
      */
-    bool IsValidLocation(const int32_t& x, const int32_t& y)
+    bool IsValidLocation(const int32_t& x, const int32_t& y) const
     {
         return (0 <= x) && (x < m_width) && (0 <= y) && (y < m_height);
     }
@@ -102,6 +103,23 @@ public:
         return nullptr;
     }
 
+    /**
+     * @brief Gets the pointer to the cell data at the specified location.
+     * @param[in] x X-coordinate
+     * @param[in] y Y-coordinate
+     * @return Pointer to the cell data at the specified location. Returns nullptr if the location is invalid.
+     */
+    const T* Get(const int32_t& x, const int32_t& y) const
+    {
+        if (IsValidLocation(x, y))
+        {
+            int32_t flattenedIndex = y * m_width + x;
+            return &m_buffer[flattenedIndex];
+        }
+
+        return nullptr;
+    }
+
     /**
      * @brief Sets the cell data at the specified location.
      * @param[in] x X-coordinate
@@ -116,4 +134,60 @@ public:
             m_buffer[flattenedIndex] = data;
         }
     }
+
+    /**
+     * @brief Gets the cells in the specified row, in memory order.
+     * @param[in] y Y-coordinate of the row
+     * @return Span over the cells in the row
+     */
+    std::span<T> GetRow(const int32_t& y)
+    {
+        return std::span<T>(m_buffer.data() + y * m_width, m_width);
+    }
+
+    /**
+     * @brief Gets the cells in the specified row, in memory order.
+     * @param[in] y Y-coordinate of the row
+     * @return Span over the cells in the row
+     */
+    std::span<const T> GetRow(const int32_t& y) const
+    {
+        return std::span<const T>(m_buffer.data() + y * m_width, m_width);
+    }
+
+    /**
+     * @brief Calls the specified function for every cell, in memory order
+     * (row by row).
+     * @param[in] func Function taking the x-coordinate, y-coordinate and a reference to the cell data
+     */
+    template <typename Func>
+    void ForEach(Func&& func)
+    {
+        for (int32_t y = 0; y < m_height; ++y)
+        {
+            T *row = m_buffer.data() + y * m_width;
+            for (int32_t x = 0; x < m_width; ++x)
+            {
+                func(x, y, row[x]);
+            }
+        }
+    }
+
+    /**
+     * @brief Calls the specified function for every cell, in memory order
+     * (row by row).
+     * @param[in] func Function taking the x-coordinate, y-coordinate and a const reference to the cell data
+     */
+    template <typename Func>
+    void ForEach(Func&& func) const
+    {
+        for (int32_t y = 0; y < m_height; ++y)
+        {
+            const T *row = m_buffer.data() + y * m_width;
+            for (int32_t x = 0; x < m_width; ++x)
+            {
+                func(x, y, row[x]);
+            }
+        }
+    }
 };
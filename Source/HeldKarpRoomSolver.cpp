@@ -0,0 +1,517 @@
+#include "HeldKarpRoomSolver.hpp"
+
+#include <algorithm>
+#include <bit>
+
+/**
+ * @brief Constructor
+ */
+HeldKarpRoomSolver::HeldKarpRoomSolver()
+    : m_stateCellIndices()
+    , m_stateBits()
+    , m_floorStateMask(0)
+    , m_requiredStateMasks()
+    , m_unlockedDoorIndices()
+    , m_neighborStateMasks()
+    , m_goalNeighborStateMask(0)
+    , m_startStateMask(0)
+    , m_reachablePositions()
+    , m_closureEntries()
+    , m_transitions()
+    , m_cellMarks()
+    , m_currentMark(0)
+    , m_numStateCells(0)
+    , m_numStatesExpanded(0)
+{
+}
+
+/**
+ * @brief Destructor
+ */
+HeldKarpRoomSolver::~HeldKarpRoomSolver()
+{
+}
+
+/**
+ * @brief Counts the floor, switch, door and empty cells in the specified room,
+ * which are the cells that change the room state when stepped on
+ * @param[in] roomData Room data
+ * @return Number of state cells
+ */
+int32_t HeldKarpRoomSolver::CountStateCells(const RoomData& roomData)
+{
+    int32_t numStateCells = 0;
+    roomData.cells.ForEach([&](const int32_t& x, const int32_t& y, const CellData& cellData)
+    {
+        bool isGoal = (x == roomData.goalX) && (y == roomData.goalY);
+        if (!isGoal && (cellData.GetType() != CellData::Type::Wall) && (cellData.GetType() != CellData::Type::Ice))
+        {
+            ++numStateCells;
+        }
+    });
+
+    return numStateCells;
+}
+
+/**
+ * @brief Searches for a sequence of moves that solves the specified room. The
+ * search is exhaustive, so a room is unsolvable if no solution is found.
+ * @param[in] roomData Room data
+ * @param[out] moves Sequence of moves that solves the room
+ * @return Returns true if a solution was found. Returns false otherwise, including
+ * when the room has more than MAX_STATE_CELLS state cells
+ */
+bool HeldKarpRoomSolver::Solve(const RoomData& roomData, std::vector<Direction>& moves)
+{
+    moves.clear();
+    m_numStatesExpanded = 0;
+    m_numStateCells = CountStateCells(roomData);
+    if (m_numStateCells > MAX_STATE_CELLS)
+    {
+        return false;
+    }
+
+    return DispatchToBitboard(roomData.cells.GetWidth(), roomData.cells.GetHeight(), [&](auto numWords)
+    {
+        return SolveWithBitboard<decltype(numWords)::value>(roomData, moves);
+    });
+}
+
+/**
+ * @brief Gets the number of state cells in the last room passed to Solve()
+ * @return Number of state cells
+ */
+int32_t HeldKarpRoomSolver::GetNumStateCells() const
+{
+    return m_numStateCells;
+}
+
+/**
+ * @brief Queries whether the last room passed to Solve() was too large for the solver
+ * @return Returns true if the room has more than MAX_STATE_CELLS state cells
+ */
+bool HeldKarpRoomSolver::HasExceededCellLimit() const
+{
+    return m_numStateCells > MAX_STATE_CELLS;
+}
+
+/**
+ * @brief Gets the number of search states expanded by the last call to Solve()
+ * @return Number of search states expanded
+ */
+uint64_t HeldKarpRoomSolver::GetNumStatesExpanded() const
+{
+    return m_numStatesExpanded;
+}
+
+/**
+ * @brief Searches for a solution using a bitboard with the specified number of words
+ * @param[in] roomData Room data
+ * @param[out] moves Sequence of moves that solves the room
+ * @return Returns true if a solution was found. Returns false otherwise
+ */
+template <size_t NumWords>
+bool HeldKarpRoomSolver::SolveWithBitboard(const RoomData& roomData, std::vector<Direction>& moves)
+{
+    RoomBitboard<NumWords> board;
+    if (!board.Build(roomData) || (board.GetGoalIndex() == -1))
+    {
+        return false;
+    }
+
+    IndexStateCells(roomData, board);
+    int32_t numStateCells = static_cast<int32_t>(m_stateCellIndices.size());
+    m_reachablePositions.assign(size_t(1) << numStateCells, 0);
+    m_cellMarks.assign(board.GetNumCells(), 0);
+    m_currentMark = 0;
+
+    // The start is expanded on the bitboard, since the goal stays locked until the first move
+    int32_t startIndex = board.GetStartIndex();
+    SetBoardState(board, m_startStateMask, true);
+    GatherTransitions(board, startIndex);
+    ++m_numStatesExpanded;
+    for (const Transition &transition : m_transitions)
+    {
+        if (transition.stateBit == -1)
+        {
+            return FindMovesTo(board, m_startStateMask, true, startIndex, -1, moves);
+        }
+        m_reachablePositions[m_startStateMask | (1u << transition.stateBit)] |= (1u << transition.stateBit);
+    }
+
+    // Every move visits one more state cell, so going through the sets in increasing
+    // order expands each set only after all the sets it can be reached from
+    bool hasIce = !board.GetIceMask().IsEmpty();
+    uint32_t finalStateMask = 0;
+    int32_t finalStateBit = -1;
+    for (uint32_t stateMask = 0; (stateMask < m_reachablePositions.size()) && (finalStateBit == -1); ++stateMask)
+    {
+        uint32_t positions = m_reachablePositions[stateMask];
+        if (positions == 0)
+        {
+            continue;
+        }
+
+        if (hasIce)
+        {
+            SetBoardState(board, stateMask, false);
+        }
+
+        bool isComplete = ((stateMask & m_floorStateMask) == m_floorStateMask);
+        while ((positions != 0) && (finalStateBit == -1))
+        {
+            int32_t stateBit = std::countr_zero(positions);
+            positions &= positions - 1;
+            ++m_numStatesExpanded;
+
+            if (!hasIce)
+            {
+                if (isComplete && ((m_goalNeighborStateMask >> stateBit) & 1))
+                {
+                    finalStateMask = stateMask;
+                    finalStateBit = stateBit;
+                    break;
+                }
+
+                uint32_t nextPositions = m_neighborStateMasks[stateBit] & ~stateMask;
+                while (nextPositions != 0)
+                {
+                    int32_t nextStateBit = std::countr_zero(nextPositions);
+                    nextPositions &= nextPositions - 1;
+                    if ((stateMask & m_requiredStateMasks[nextStateBit]) == m_requiredStateMasks[nextStateBit])
+                    {
+                        m_reachablePositions[stateMask | (1u << nextStateBit)] |= (1u << nextStateBit);
+                    }
+                }
+                continue;
+            }
+
+            GatherTransitions(board, m_stateCellIndices[stateBit]);
+            for (const Transition &transition : m_transitions)
+            {
+                if (transition.stateBit == -1)
+                {
+                    finalStateMask = stateMask;
+                    finalStateBit = stateBit;
+                    break;
+                }
+                m_reachablePositions[stateMask | (1u << transition.stateBit)] |= (1u << transition.stateBit);
+            }
+        }
+    }
+
+    if (finalStateBit == -1)
+    {
+        return false;
+    }
+
+    // Walk back from the goal, finding a predecessor of each state among the
+    // positions reachable with one state cell less
+    std::vector<std::vector<Direction>> segments(1);
+    FindMovesTo(board, finalStateMask, false, m_stateCellIndices[finalStateBit], -1, segments.back());
+
+    uint32_t stateMask = finalStateMask;
+    int32_t stateBit = finalStateBit;
+    while (true)
+    {
+        uint32_t previousStateMask = stateMask & ~(1u << stateBit);
+        segments.emplace_back();
+        if ((previousStateMask == m_startStateMask)
+            && FindMovesTo(board, m_startStateMask, true, startIndex, stateBit, segments.back()))
+        {
+            break;
+        }
+
+        uint32_t previousPositions = m_reachablePositions[previousStateMask];
+        int32_t previousStateBit = -1;
+        while ((previousPositions != 0) && (previousStateBit == -1))
+        {
+            int32_t candidateStateBit = std::countr_zero(previousPositions);
+            previousPositions &= previousPositions - 1;
+            if (FindMovesTo(board, previousStateMask, false, m_stateCellIndices[candidateStateBit], stateBit, segments.back()))
+            {
+                previousStateBit = candidateStateBit;
+            }
+        }
+        if (previousStateBit == -1)
+        {
+            return false;
+        }
+
+        stateMask = previousStateMask;
+        stateBit = previousStateBit;
+    }
+
+    for (auto it = segments.rbegin(); it != segments.rend(); ++it)
+    {
+        moves.insert(moves.end(), it->begin(), it->end());
+    }
+
+    return true;
+}
+
+/**
+ * @brief Assigns a state cell bit to every floor, switch, door and empty cell,
+ * and precomputes the masks used by the transitions
+ * @param[in] roomData Room data
+ * @param[in] board Room bitboard
+ */
+template <size_t NumWords>
+void HeldKarpRoomSolver::IndexStateCells(const RoomData& roomData, const RoomBitboard<NumWords>& board)
+{
+    int32_t numCells = board.GetNumCells();
+    typename RoomBitboard<NumWords>::Mask stateCellMask = board.GetRoomMask() & ~(board.GetWallMask() | board.GetIceMask());
+
+    m_stateCellIndices.clear();
+    m_stateBits.assign(numCells, -1);
+    m_floorStateMask = 0;
+    for (int32_t i = 0; i < numCells; ++i)
+    {
+        if (!stateCellMask.Test(i) || (i == board.GetGoalIndex()))
+        {
+            continue;
+        }
+
+        int32_t stateBit = static_cast<int32_t>(m_stateCellIndices.size());
+        m_stateBits[i] = stateBit;
+        m_stateCellIndices.push_back(i);
+        if (board.GetFloorMask().Test(i))
+        {
+            m_floorStateMask |= (1u << stateBit);
+        }
+    }
+
+    int32_t numStateCells = static_cast<int32_t>(m_stateCellIndices.size());
+    m_requiredStateMasks.assign(numStateCells, 0);
+    m_unlockedDoorIndices.assign(numStateCells, -1);
+
+    // Doors can only be stepped on once their switch has been visited. Doors
+    // without a switch can never be stepped on.
+    std::vector<uint8_t> canStepOnFlags(numStateCells, 1);
+    for (int32_t i = 0; i < numStateCells; ++i)
+    {
+        canStepOnFlags[i] = board.GetDoorMask().Test(m_stateCellIndices[i]) ? 0 : 1;
+    }
+    for (const SwitchDoorMapping &mapping : roomData.switchDoorMappings)
+    {
+        if ((mapping.switchId == -1)
+            || !roomData.cells.IsValidLocation(mapping.switchX, mapping.switchY)
+            || !roomData.cells.IsValidLocation(mapping.doorX, mapping.doorY))
+        {
+            continue;
+        }
+
+        int32_t switchStateBit = m_stateBits[mapping.switchY * board.GetWidth() + mapping.switchX];
+        int32_t doorIndex = mapping.doorY * board.GetWidth() + mapping.doorX;
+        int32_t doorStateBit = m_stateBits[doorIndex];
+        if ((switchStateBit == -1) || (doorStateBit == -1))
+        {
+            continue;
+        }
+
+        m_unlockedDoorIndices[switchStateBit] = doorIndex;
+        m_requiredStateMasks[doorStateBit] = (1u << switchStateBit);
+        canStepOnFlags[doorStateBit] = 1;
+    }
+
+    m_neighborStateMasks.assign(numStateCells, 0);
+    m_goalNeighborStateMask = 0;
+    for (int32_t i = 0; i < numStateCells; ++i)
+    {
+        for (Direction direction : ALL_DIRECTIONS)
+        {
+            if (!board.HasNeighbor(m_stateCellIndices[i], direction))
+            {
+                continue;
+            }
+
+            int32_t neighborIndex = board.GetNeighborIndex(m_stateCellIndices[i], direction);
+            int32_t neighborStateBit = m_stateBits[neighborIndex];
+            if ((neighborStateBit != -1) && (canStepOnFlags[neighborStateBit] != 0))
+            {
+                m_neighborStateMasks[i] |= (1u << neighborStateBit);
+            }
+            if (neighborIndex == board.GetGoalIndex())
+            {
+                m_goalNeighborStateMask |= (1u << i);
+            }
+        }
+    }
+
+    // Only a floor start is visited on reset
+    m_startStateMask = 0;
+    int32_t startStateBit = m_stateBits[board.GetStartIndex()];
+    if ((startStateBit != -1) && board.GetFloorMask().Test(board.GetStartIndex()))
+    {
+        m_startStateMask = (1u << startStateBit);
+    }
+}
+
+/**
+ * @brief Sets the room bitboard to the state where the specified state cells are visited
+ * @param[in,out] board Room bitboard
+ * @param[in] stateMask Mask of the visited state cells
+ * @param[in] isInitialState Flag indicating whether this is the state at the start,
+ * before any move unlocked the goal
+ */
+template <size_t NumWords>
+void HeldKarpRoomSolver::SetBoardState(RoomBitboard<NumWords>& board, const uint32_t& stateMask, const bool& isInitialState) const
+{
+    typename RoomBitboard<NumWords>::Mask visitedMask;
+    typename RoomBitboard<NumWords>::Mask unlockedMask;
+    uint32_t remainingStateMask = stateMask;
+    while (remainingStateMask != 0)
+    {
+        int32_t stateBit = std::countr_zero(remainingStateMask);
+        remainingStateMask &= remainingStateMask - 1;
+
+        visitedMask.Set(m_stateCellIndices[stateBit]);
+        if (m_unlockedDoorIndices[stateBit] != -1)
+        {
+            unlockedMask.Set(m_unlockedDoorIndices[stateBit]);
+        }
+    }
+
+    bool isGoalUnlocked = !isInitialState && ((stateMask & m_floorStateMask) == m_floorStateMask);
+    board.SetState(visitedMask, unlockedMask, isGoalUnlocked);
+}
+
+/**
+ * @brief Gathers the moves that change the room state from the specified position,
+ * sliding over ice as needed
+ * @param[in,out] board Room bitboard, set to the state to expand
+ * @param[in] cellIndex Cell index of the player's position
+ */
+template <size_t NumWords>
+void HeldKarpRoomSolver::GatherTransitions(RoomBitboard<NumWords>& board, const int32_t& cellIndex)
+{
+    m_closureEntries.clear();
+    m_transitions.clear();
+
+    uint32_t mark = NextMark();
+    m_closureEntries.push_back({ cellIndex, -1, Direction::Up });
+    m_cellMarks[cellIndex] = mark;
+
+    // In a room already complete at the start, every stop on ice unlocks the goal,
+    // all leading to the same room state. The entries after the first such stop are
+    // expanded in that state, where the start can be stepped on again
+    RoomMoveRecord goalUnlockRecord = {};
+    size_t goalUnlockEntryIndex = 0;
+    bool hasUnlockedGoal = false;
+    for (size_t i = 0; i < m_closureEntries.size(); ++i)
+    {
+        if ((goalUnlockEntryIndex != 0) && (i == goalUnlockEntryIndex))
+        {
+            const ClosureEntry &entry = m_closureEntries[i];
+            int32_t parentCellIndex = m_closureEntries[entry.parentEntryIndex].cellIndex;
+            board.ApplyMove(parentCellIndex, entry.direction, goalUnlockRecord);
+            hasUnlockedGoal = true;
+
+            mark = NextMark();
+            for (size_t j = i; j < m_closureEntries.size(); ++j)
+            {
+                m_cellMarks[m_closureEntries[j].cellIndex] = mark;
+            }
+        }
+
+        for (Direction direction : ALL_DIRECTIONS)
+        {
+            int32_t newCellIndex = m_closureEntries[i].cellIndex;
+            RoomMoveRecord record;
+            if (!board.ApplyMove(newCellIndex, direction, record))
+            {
+                continue;
+            }
+
+            if (record.hasReachedGoal)
+            {
+                m_transitions.push_back({ static_cast<int32_t>(i), direction, -1 });
+            }
+            else if (record.visitedCellIndex == -1)
+            {
+                // Other stops on ice keep the room state
+                if (m_cellMarks[newCellIndex] != mark)
+                {
+                    m_cellMarks[newCellIndex] = mark;
+                    m_closureEntries.push_back({ newCellIndex, static_cast<int32_t>(i), direction });
+                    if (board.HasChangedRoomState(record) && (goalUnlockEntryIndex == 0))
+                    {
+                        goalUnlockEntryIndex = m_closureEntries.size() - 1;
+                    }
+                }
+            }
+            else if (m_stateBits[newCellIndex] != -1)
+            {
+                // Entering a locked goal is left out, since the goal can never be entered again
+                m_transitions.push_back({ static_cast<int32_t>(i), direction, m_stateBits[newCellIndex] });
+            }
+
+            board.UndoMove(record);
+        }
+    }
+
+    if (hasUnlockedGoal)
+    {
+        board.UndoMove(goalUnlockRecord);
+    }
+}
+
+/**
+ * @brief Finds the moves leading from a state to the specified state cell or the goal
+ * @param[in,out] board Room bitboard
+ * @param[in] stateMask Mask of the visited state cells
+ * @param[in] isInitialState Flag indicating whether this is the state at the start
+ * @param[in] cellIndex Cell index of the player's position
+ * @param[in] targetStateBit State cell bit to move to. -1 to move to the goal
+ * @param[out] moves Moves leading to the target, in order
+ * @return Returns true if the target can be reached with a single state change
+ */
+template <size_t NumWords>
+bool HeldKarpRoomSolver::FindMovesTo(
+    RoomBitboard<NumWords>& board,
+    const uint32_t& stateMask,
+    const bool& isInitialState,
+    const int32_t& cellIndex,
+    const int32_t& targetStateBit,
+    std::vector<Direction>& moves)
+{
+    moves.clear();
+    SetBoardState(board, stateMask, isInitialState);
+    GatherTransitions(board, cellIndex);
+    for (const Transition &transition : m_transitions)
+    {
+        if (transition.stateBit != targetStateBit)
+        {
+            continue;
+        }
+
+        moves.push_back(transition.direction);
+        int32_t entryIndex = transition.entryIndex;
+        while (m_closureEntries[entryIndex].parentEntryIndex != -1)
+        {
+            moves.push_back(m_closureEntries[entryIndex].direction);
+            entryIndex = m_closureEntries[entryIndex].parentEntryIndex;
+        }
+        std::reverse(moves.begin(), moves.end());
+
+        return true;
+    }
+
+    return false;
+}
+
+/**
+ * @brief Gets a fresh mark value, effectively unmarking all cells
+ * @return Mark value
+ */
+uint32_t HeldKarpRoomSolver::NextMark()
+{
+    ++m_currentMark;
+    if (m_currentMark == 0)
+    {
+        std::fill(m_cellMarks.begin(), m_cellMarks.end(), 0);
+        m_currentMark = 1;
+    }
+
+    return m_currentMark;
+}
@@ -0,0 +1,263 @@
+#pragma once
+
+#include "Direction.hpp"
+#include "LevelData.hpp"
+#include "RoomBitboard.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Exact solver for small rooms, using dynamic programming over the set of
+ * visited cells and the player's position (Held-Karp). Only floors, switches,
+ * doors and empty cells change the room state when stepped on, so a room with
+ * k of them has at most 2^k sets of visited cells, and the solver stores the
+ * positions the player can be at for each set as a bitmask.
+ *
+ * Rooms without ice use precomputed neighbor masks, so each transition is a few
+ * bit operations. In rooms with ice, the transitions are found by sliding on a
+ * room bitboard set to the stored state. Pressing a switch unlocks its door in
+ * every state that contains the switch.
+ */
+class HeldKarpRoomSolver
+{
+public:
+    /**
+     * Maximum number of floor, switch, door and empty cells in a room the solver can handle
+     */
+    static constexpr int32_t MAX_STATE_CELLS = 24;
+
+private:
+    /**
+     * Entry in the list of positions reachable without changing the room state
+     * (i.e. by only stopping on ice cells)
+     */
+    struct ClosureEntry
+    {
+        /**
+         * Cell index of the position
+         */
+        int32_t cellIndex;
+
+        /**
+         * Index of the entry this entry was reached from. -1 for the first entry
+         */
+        int32_t parentEntryIndex;
+
+        /**
+         * Direction of the move from the parent entry
+         */
+        Direction direction;
+    };
+
+    /**
+     * Move that changes the room state
+     */
+    struct Transition
+    {
+        /**
+         * Index of the closure entry the move is made from
+         */
+        int32_t entryIndex;
+
+        /**
+         * Direction of the move
+         */
+        Direction direction;
+
+        /**
+         * State cell bit of the cell the move ends on. -1 if the move reaches the goal
+         */
+        int32_t stateBit;
+    };
+
+private:
+    /**
+     * Cell index of each state cell, indexed by state cell bit
+     */
+    std::vector<int32_t> m_stateCellIndices;
+
+    /**
+     * State cell bit of each cell. -1 for cells that do not change the room state
+     */
+    std::vector<int32_t> m_stateBits;
+
+    /**
+     * Mask of the state cell bits of the floors
+     */
+    uint32_t m_floorStateMask;
+
+    /**
+     * Mask of the state cell bits that have to be visited before each state cell
+     * can be stepped on, i.e. the switch of a door
+     */
+    std::vector<uint32_t> m_requiredStateMasks;
+
+    /**
+     * Cell index of the door unlocked by each state cell. -1 if the state cell is not a switch
+     */
+    std::vector<int32_t> m_unlockedDoorIndices;
+
+    /**
+     * Mask of the state cell bits next to each state cell that can ever be stepped on.
+     * Only used in rooms without ice
+     */
+    std::vector<uint32_t> m_neighborStateMasks;
+
+    /**
+     * Mask of the state cell bits next to the goal. Only used in rooms without ice
+     */
+    uint32_t m_goalNeighborStateMask;
+
+    /**
+     * Mask of the state cell bits visited at the start
+     */
+    uint32_t m_startStateMask;
+
+    /**
+     * Positions the player can be at after visiting each set of state cells, as a
+     * mask of state cell bits, indexed by the mask of the visited state cells
+     */
+    std::vector<uint32_t> m_reachablePositions;
+
+    /**
+     * Closure entries of the state being expanded
+     */
+    std::vector<ClosureEntry> m_closureEntries;
+
+    /**
+     * Transitions out of the state being expanded
+     */
+    std::vector<Transition> m_transitions;
+
+    /**
+     * Per-cell marks used by closure computation
+     */
+    std::vector<uint32_t> m_cellMarks;
+
+    /**
+     * Current mark value. Cells marked with a different value are unmarked
+     */
+    uint32_t m_currentMark;
+
+    /**
+     * Number of state cells in the last room passed to Solve()
+     */
+    int32_t m_numStateCells;
+
+    /**
+     * Number of search states expanded by the last call to Solve()
+     */
+    uint64_t m_numStatesExpanded;
+
+public:
+    /**
+     * @brief Constructor
+     */
+    HeldKarpRoomSolver();
+
+    /**
+     * @brief Destructor
+     */
+    ~HeldKarpRoomSolver();
+
+    /**
+     * @brief Counts the floor, switch, door and empty cells in the specified room,
+     * which are the cells that change the room state when stepped on
+     * @param[in] roomData Room data
+     * @return Number of state cells
+     */
+    static int32_t CountStateCells(const RoomData& roomData);
+
+    /**
+     * @brief Searches for a sequence of moves that solves the specified room. The
+     * search is exhaustive, so a room is unsolvable if no solution is found.
+     * @param[in] roomData Room data
+     * @param[out] moves Sequence of moves that solves the room
+     * @return Returns true if a solution was found. Returns false otherwise, including
+     * when the room has more than MAX_STATE_CELLS state cells
+     */
+    bool Solve(const RoomData& roomData, std::vector<Direction>& moves);
+
+    /**
+     * @brief Gets the number of state cells in the last room passed to Solve()
+     * @return Number of state cells
+     */
+    int32_t GetNumStateCells() const;
+
+    /**
+     * @brief Queries whether the last room passed to Solve() was too large for the solver
+     * @return Returns true if the room has more than MAX_STATE_CELLS state cells
+     */
+    bool HasExceededCellLimit() const;
+
+    /**
+     * @brief Gets the number of search states expanded by the last call to Solve()
+     * @return Number of search states expanded
+     */
+    uint64_t GetNumStatesExpanded() const;
+
+private:
+    /**
+     * @brief Searches for a solution using a bitboard with the specified number of words
+     * @param[in] roomData Room data
+     * @param[out] moves Sequence of moves that solves the room
+     * @return Returns true if a solution was found. Returns false otherwise
+     */
+    template <size_t NumWords>
+    bool SolveWithBitboard(const RoomData& roomData, std::vector<Direction>& moves);
+
+    /**
+     * @brief Assigns a state cell bit to every floor, switch, door and empty cell,
+     * and precomputes the masks used by the transitions
+     * @param[in] roomData Room data
+     * @param[in] board Room bitboard
+     */
+    template <size_t NumWords>
+    void IndexStateCells(const RoomData& roomData, const RoomBitboard<NumWords>& board);
+
+    /**
+     * @brief Sets the room bitboard to the state where the specified state cells are visited
+     * @param[in,out] board Room bitboard
+     * @param[in] stateMask Mask of the visited state cells
+     * @param[in] isInitialState Flag indicating whether this is the state at the start,
+     * before any move unlocked the goal
+     */
+    template <size_t NumWords>
+    void SetBoardState(RoomBitboard<NumWords>& board, const uint32_t& stateMask, const bool& isInitialState) const;
+
+    /**
+     * @brief Gathers the moves that change the room state from the specified position,
+     * sliding over ice as needed
+     * @param[in,out] board Room bitboard, set to the state to expand
+     * @param[in] cellIndex Cell index of the player's position
+     */
+    template <size_t NumWords>
+    void GatherTransitions(RoomBitboard<NumWords>& board, const int32_t& cellIndex);
+
+    /**
+     * @brief Finds the moves leading from a state to the specified state cell or the goal
+     * @param[in,out] board Room bitboard
+     * @param[in] stateMask Mask of the visited state cells
+     * @param[in] isInitialState Flag indicating whether this is the state at the start
+     * @param[in] cellIndex Cell index of the player's position
+     * @param[in] targetStateBit State cell bit to move to. -1 to move to the goal
+     * @param[out] moves Moves leading to the target, in order
+     * @return Returns true if the target can be reached with a single state change
+     */
+    template <size_t NumWords>
+    bool FindMovesTo(
+        RoomBitboard<NumWords>& board,
+        const uint32_t& stateMask,
+        const bool& isInitialState,
+        const int32_t& cellIndex,
+        const int32_t& targetStateBit,
+        std::vector<Direction>& moves);
+
+    /**
+     * @brief Gets a fresh mark value, effectively unmarking all cells
+     * @return Mark value
+     */
+    uint32_t NextMark();
+};
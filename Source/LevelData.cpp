@@ -1,16 +1,40 @@
 #include "LevelData.hpp"
 
+#include "Constants.hpp"
+#include "Direction.hpp"
+
+#include <array>
 #include <cctype>
 #include <cstdint>
 #include <fstream>
 #include <iostream>
 #include <sstream>
 #include <string>
+#include <vector>
 
 #define WALL_SYMBOL '#'
 #define GOAL_SYMBOL '@'
 #define FLOOR_SYMBOL '.'
 #define ICE_SYMBOL '*'
+#define EMPTY_SYMBOL ' '
+
+/**
+ * @brief Gets the mapping for the specified switch ID
+ * @param[in] switchId Switch ID
+ * @return Pointer to the mapping for the specified switch ID. Returns nullptr
+ * if the room has no switch or door with the specified ID.
+ */
+SwitchDoorMapping* RoomData::GetSwitchDoorMapping(const int32_t& switchId)
+{
+    int32_t mappingIndex = switchId - 'a';
+    if ((mappingIndex < 0) || (mappingIndex >= MAX_SWITCHES)
+        || (switchDoorMappings[mappingIndex].switchId == -1))
+    {
+        return nullptr;
+    }
+
+    return &switchDoorMappings[mappingIndex];
+}
 
 /**
  * @brief Gets the switch ID from the switch position
@@ -19,17 +43,16 @@
  * @return Switch ID of the switch at the specified position. If the switch at
  * the specified position does not exist in the database, returns -1.
  */
-int32_t RoomData::GetSwitchIdFromSwitchPosition(const int32_t &switchX, const int32_t &switchY)
+int32_t RoomData::GetSwitchIdFromSwitchPosition(const int32_t &switchX, const int32_t &switchY) const
 {
-    for (auto &it : switchDoorMappings)
+    const CellData *cellData = cells.Get(switchX, switchY);
+    if ((cellData == nullptr) || (cellData->GetType() != CellData::Type::Switch))
     {
-        if ((it.second.switchX == switchX) && (it.second.switchY == switchY))
-        {
-            return it.first;
-        }
+        return -1;
     }
 
-    return -1;
+    int8_t switchIndex = *switchIndices.Get(switchX, switchY);
+    return (switchIndex == -1) ? -1 : ('a' + switchIndex);
 }
 
 /**
@@ -39,17 +62,339 @@ int32_t RoomData::GetSwitchIdFromSwitchPosition(const int32_t &switchX, const in
  * @return Switch ID of the door at the specified position. If the door at
  * the specified position does not exist in the database, returns -1.
  */
-int32_t RoomData::GetSwitchIdFromDoorPosition(const int32_t& doorX, const int32_t& doorY)
+int32_t RoomData::GetSwitchIdFromDoorPosition(const int32_t& doorX, const int32_t& doorY) const
 {
-    for (auto &it : switchDoorMappings)
+    const CellData *cellData = cells.Get(doorX, doorY);
+    if ((cellData == nullptr) || (cellData->GetType() != CellData::Type::Door))
     {
-        if ((it.second.doorX == doorX) && (it.second.doorY == doorY))
+        return -1;
+    }
+
+    int8_t switchIndex = *switchIndices.Get(doorX, doorY);
+    return (switchIndex == -1) ? -1 : ('a' + switchIndex);
+}
+
+/**
+ * @brief Resets the state of all the cells in the room, and marks the
+ * player's starting cell as visited
+ */
+void RoomData::ResetCells()
+{
+    numUnvisitedFloors = 0;
+
+    cells.ForEach([this](const int32_t&, const int32_t&, CellData& cellData)
+    {
+        cellData.SetState(0);
+        cellData.SetVisited(false);
+        if (cellData.GetType() == CellData::Type::Floor)
         {
-            return it.first;
+            ++numUnvisitedFloors;
         }
+    });
+
+    CellData *playerCell = cells.Get(playerStartX, playerStartY);
+    if ((playerCell != nullptr)
+        && (playerCell->GetType() == CellData::Type::Floor))
+    {
+        VisitCell(playerStartX, playerStartY);
     }
 
-    return -1;
+    CellData *goalCell = cells.Get(goalX, goalY);
+    if (goalCell != nullptr)
+    {
+        goalCell->SetState(Constants::GOAL_LOCKED_STATE);
+    }
+}
+
+/**
+ * @brief Marks the cell at the specified position as visited
+ * @param[in] x X-coordinate
+ * @param[in] y Y-coordinate
+ */
+void RoomData::VisitCell(const int32_t& x, const int32_t& y)
+{
+    CellData *cellData = cells.Get(x, y);
+    if ((cellData == nullptr) || cellData->IsVisited())
+    {
+        return;
+    }
+
+    cellData->SetVisited(true);
+    if (cellData->GetType() == CellData::Type::Floor)
+    {
+        --numUnvisitedFloors;
+    }
+}
+
+/**
+ * @brief Marks the cell at the specified position as not visited, undoing VisitCell()
+ * @param[in] x X-coordinate
+ * @param[in] y Y-coordinate
+ */
+void RoomData::UnvisitCell(const int32_t& x, const int32_t& y)
+{
+    CellData *cellData = cells.Get(x, y);
+    if ((cellData == nullptr) || !cellData->IsVisited())
+    {
+        return;
+    }
+
+    cellData->SetVisited(false);
+    if (cellData->GetType() == CellData::Type::Floor)
+    {
+        ++numUnvisitedFloors;
+    }
+}
+
+/**
+ * @brief Unlocks the door at the specified position
+ * @param[in] x X-coordinate
+ * @param[in] y Y-coordinate
+ */
+void RoomData::UnlockDoor(const int32_t& x, const int32_t& y)
+{
+    CellData *cellData = cells.Get(x, y);
+    if ((cellData == nullptr) || (cellData->GetState() == Constants::DOOR_UNLOCKED_STATE))
+    {
+        return;
+    }
+
+    cellData->SetState(Constants::DOOR_UNLOCKED_STATE);
+}
+
+/**
+ * @brief Locks the door at the specified position, undoing UnlockDoor()
+ * @param[in] x X-coordinate
+ * @param[in] y Y-coordinate
+ */
+void RoomData::LockDoor(const int32_t& x, const int32_t& y)
+{
+    CellData *cellData = cells.Get(x, y);
+    if ((cellData == nullptr) || (cellData->GetState() == Constants::DOOR_LOCKED_STATE))
+    {
+        return;
+    }
+
+    cellData->SetState(Constants::DOOR_LOCKED_STATE);
+}
+
+/**
+ * @brief Queries whether the player can currently enter the cell at the specified index
+ * @param[in] cellIndex Index in the cells grid
+ * @return Returns true if the cell is not a wall, not visited, and not a locked door
+ */
+bool RoomData::IsTraversible(const int32_t& cellIndex) const
+{
+    const CellData &cellData = cells.GetAt(cellIndex);
+    if (cellData.GetType() == CellData::Type::Wall)
+    {
+        return false;
+    }
+    if (cellData.IsVisited())
+    {
+        return false;
+    }
+    if ((cellData.GetType() == CellData::Type::Door)
+        && (cellData.GetState() == Constants::DOOR_LOCKED_STATE))
+    {
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Checks if the room is completed or not
+ * @return Returns true if every floor cell in the room has been visited
+ */
+bool RoomData::IsComplete() const
+{
+    return numUnvisitedFloors == 0;
+}
+
+/**
+ * @brief Queries whether the goal is unlocked or not
+ * @return Returns true if the goal is unlocked
+ */
+bool RoomData::IsGoalUnlocked() const
+{
+    const CellData *goalCell = cells.Get(goalX, goalY);
+    return (goalCell != nullptr) && (goalCell->GetState() == Constants::GOAL_UNLOCKED_STATE);
+}
+
+/**
+ * @brief Runs the unsolvability checks on the room layout in linear time, and
+ * stores the results in analysis
+ */
+void RoomData::Analyze()
+{
+    analysis = { false, false, 0, 0, false, 0 };
+
+    const CellData *startCell = cells.Get(playerStartX, playerStartY);
+    const CellData *goalCell = cells.Get(goalX, goalY);
+    if ((startCell == nullptr) || (startCell->GetType() == CellData::Type::Wall)
+        || (goalCell == nullptr) || (goalCell->GetType() != CellData::Type::Goal)
+        || ((playerStartX == goalX) && (playerStartY == goalY)))
+    {
+        analysis.hasInvalidStartOrGoal = true;
+        return;
+    }
+
+    // Every floor needs a way in and a different way out, except when entering
+    // from and leaving through the same ice cell, or through a start that is not
+    // a floor, which is only visited when the player steps back on it. The path
+    // also alternates between the two colors of a checkerboard, which fixes how
+    // many floors each color has when the path has no optional cells to step on.
+    std::array<int32_t, 2> numPathCellsPerColor = { 0, 0 };
+    bool hasOptionalCells = false;
+    int32_t reenterableStartIndex = (startCell->GetType() != CellData::Type::Floor)
+        ? cells.GetIndex(playerStartX, playerStartY) : -1;
+    cells.ForEach([&](const int32_t& x, const int32_t& y, const CellData& cellData)
+    {
+        // Only a floor start is visited on reset, so any other start can be stepped on again
+        bool isStart = (x == playerStartX) && (y == playerStartY);
+        CellData::Type type = cellData.GetType();
+        if ((type == CellData::Type::Ice) || (type == CellData::Type::Switch)
+            || (type == CellData::Type::Door) || (type == CellData::Type::Empty))
+        {
+            hasOptionalCells = true;
+        }
+
+        if (isStart || (type == CellData::Type::Goal))
+        {
+            ++numPathCellsPerColor[(x + y) & 1];
+            return;
+        }
+        if (type != CellData::Type::Floor)
+        {
+            return;
+        }
+
+        ++numPathCellsPerColor[(x + y) & 1];
+
+        int32_t cellIndex = cells.GetIndex(x, y);
+        int32_t numOpenNeighbors = 0;
+        bool hasReenterableNeighbor = false;
+        for (Direction direction : ALL_DIRECTIONS)
+        {
+            int32_t neighborIndex = cellIndex + cells.GetNeighborOffset(direction);
+            CellData::Type neighborType = cells.GetAt(neighborIndex).GetType();
+            numOpenNeighbors += (neighborType != CellData::Type::Wall) ? 1 : 0;
+            hasReenterableNeighbor = hasReenterableNeighbor || (neighborType == CellData::Type::Ice)
+                || (neighborIndex == reenterableStartIndex);
+        }
+        if ((numOpenNeighbors == 0) || ((numOpenNeighbors == 1) && !hasReenterableNeighbor))
+        {
+            ++analysis.numDeadEndFloors;
+        }
+    });
+
+    if (!hasOptionalCells)
+    {
+        int32_t startColor = (playerStartX + playerStartY) & 1;
+        int32_t goalColor = (goalX + goalY) & 1;
+        int32_t expectedDifference = (startColor == goalColor) ? 1 : 0;
+        analysis.hasParityMismatch =
+            (numPathCellsPerColor[startColor] - numPathCellsPerColor[1 - startColor] != expectedDifference);
+    }
+
+    // Flood fill from the start, where a door can only be passed once its switch
+    // has been reached. Ice is treated like floor, which can only reach more cells.
+    std::vector<uint8_t> isReached(cells.GetBufferSize(), 0);
+    std::array<bool, MAX_SWITCHES> isSwitchReached {};
+    std::array<int32_t, MAX_SWITCHES> blockedDoorIndices;
+    blockedDoorIndices.fill(-1);
+
+    std::vector<int32_t> cellQueue;
+    int32_t startIndex = cells.GetIndex(playerStartX, playerStartY);
+    isReached[startIndex] = 1;
+    cellQueue.push_back(startIndex);
+    for (size_t i = 0; i < cellQueue.size(); ++i)
+    {
+        int32_t cellIndex = cellQueue[i];
+        int32_t x, y;
+        cells.GetLocation(cellIndex, x, y);
+
+        int32_t switchId = GetSwitchIdFromSwitchPosition(x, y);
+        if ((switchId != -1) && !isSwitchReached[switchId - 'a'])
+        {
+            isSwitchReached[switchId - 'a'] = true;
+            int32_t doorIndex = blockedDoorIndices[switchId - 'a'];
+            if ((doorIndex != -1) && (isReached[doorIndex] == 0))
+            {
+                isReached[doorIndex] = 1;
+                cellQueue.push_back(doorIndex);
+            }
+        }
+
+        for (Direction direction : ALL_DIRECTIONS)
+        {
+            int32_t neighborIndex = cellIndex + cells.GetNeighborOffset(direction);
+            CellData::Type neighborType = cells.GetAt(neighborIndex).GetType();
+            if ((isReached[neighborIndex] != 0) || (neighborType == CellData::Type::Wall))
+            {
+                continue;
+            }
+
+            if (neighborType == CellData::Type::Door)
+            {
+                int32_t neighborX, neighborY;
+                cells.GetLocation(neighborIndex, neighborX, neighborY);
+                int32_t doorSwitchId = GetSwitchIdFromDoorPosition(neighborX, neighborY);
+                if (doorSwitchId == -1)
+                {
+                    continue;
+                }
+                if (!isSwitchReached[doorSwitchId - 'a'])
+                {
+                    // Passed once the switch is reached, if ever
+                    blockedDoorIndices[doorSwitchId - 'a'] = neighborIndex;
+                    continue;
+                }
+            }
+
+            isReached[neighborIndex] = 1;
+            cellQueue.push_back(neighborIndex);
+        }
+    }
+
+    cells.ForEach([&](const int32_t& x, const int32_t& y, const CellData& cellData)
+    {
+        bool isCellReached = (isReached[cells.GetIndex(x, y)] != 0);
+        switch (cellData.GetType())
+        {
+            case CellData::Type::Floor:
+                analysis.numUnreachableFloors += isCellReached ? 0 : 1;
+                break;
+            case CellData::Type::Goal:
+                analysis.isGoalUnreachable = analysis.isGoalUnreachable || !isCellReached;
+                break;
+            case CellData::Type::Door:
+            {
+                int32_t doorSwitchId = GetSwitchIdFromDoorPosition(x, y);
+                if ((doorSwitchId == -1) || !isSwitchReached[doorSwitchId - 'a'])
+                {
+                    ++analysis.numUnopenableDoors;
+                }
+                break;
+            }
+            default:
+                break;
+        }
+    });
+}
+
+/**
+ * @brief Queries whether any of the checks proves that the room is unsolvable
+ * @return Returns true if the room is provably unsolvable
+ */
+bool RoomAnalysis::IsProvablyUnsolvable() const
+{
+    return hasInvalidStartOrGoal
+        || hasParityMismatch
+        || (numDeadEndFloors > 0)
+        || (numUnreachableFloors > 0)
+        || isGoalUnreachable;
 }
 
 /**
@@ -80,28 +425,38 @@ bool LevelData::LoadFromFile(const std::string &levelFilePath)
         return false;
     }
 
+    return LoadFromStream(file);
+}
+
+/**
+ * @brief Loads the level data from the specified stream, in the same format as level files
+ * @param[in] stream Stream containing the level data
+ * @return Returns true if the operation was successful. Returns false otherwise
+ */
+bool LevelData::LoadFromStream(std::istream& stream)
+{
     descriptionLines.clear();
 
     int32_t descriptionNumLines;
-    file >> descriptionNumLines;
+    stream >> descriptionNumLines;
 
     std::string line;
-    std::getline(file, line);
+    std::getline(stream, line);
 
     for (int32_t i = 0; i < descriptionNumLines; ++i)
     {
-        std::getline(file, line);
+        std::getline(stream, line);
         descriptionLines.push_back(line);
     }
 
     rooms.clear();
 
     int32_t numRooms;
-    file >> numRooms;
+    stream >> numRooms;
     for (int32_t i = 0; i < numRooms; ++i)
     {
         int32_t roomWidth, roomHeight;
-        file >> roomWidth >> roomHeight;
+        stream >> roomWidth >> roomHeight;
         if ((roomWidth == 0) || (roomHeight == 0))
         {
             std::cerr << "Room width or height is 0!" << std::endl;
@@ -110,29 +465,38 @@ bool LevelData::LoadFromFile(const std::string &levelFilePath)
         rooms.emplace_back();
 
         RoomData &room = rooms.back();
-        room.cells.Resize(roomWidth, roomHeight);
+        CellData borderCell;
+        borderCell.SetType(CellData::Type::Wall);
+        room.cells.Resize(roomWidth, roomHeight, borderCell);
+        room.switchIndices.Resize(roomWidth, roomHeight);
+        for (SwitchDoorMapping &mapping : room.switchDoorMappings)
+        {
+            mapping = { -1, -1, -1, -1, -1 };
+        }
 
-        std::getline(file, line);
+        std::getline(stream, line);
         for (int32_t y = 0; y < roomHeight; ++y)
         {
-            std::getline(file, line);
+            std::getline(stream, line);
             for (int32_t x = 0; x < roomWidth; ++x)
             {
                 if (std::isalpha(line[x]))
                 {
                     int32_t switchId = static_cast<int32_t>(std::tolower(line[x]));
 
+                    SwitchDoorMapping &mapping = room.switchDoorMappings[switchId - 'a'];
+                    mapping.switchId = switchId;
                     if (std::islower(line[x]))
                     {
-                        room.switchDoorMappings[switchId].switchX = x;
-                        room.switchDoorMappings[switchId].switchY = y;
-                        room.cells.Get(x, y)->type = CellData::Type::Switch;
+                        mapping.switchX = x;
+                        mapping.switchY = y;
+                        room.cells.Get(x, y)->SetType(CellData::Type::Switch);
                     }
                     else
                     {
-                        room.switchDoorMappings[switchId].doorX = x;
-                        room.switchDoorMappings[switchId].doorY = y;
-                        room.cells.Get(x, y)->type = CellData::Type::Door;
+                        mapping.doorX = x;
+                        mapping.doorY = y;
+                        room.cells.Get(x, y)->SetType(CellData::Type::Door);
                     }
                 }
                 else
@@ -140,24 +504,24 @@ bool LevelData::LoadFromFile(const std::string &levelFilePath)
                     switch (line[x])
                     {
                         case FLOOR_SYMBOL:
-                            room.cells.Get(x, y)->type = CellData::Type::Floor;
+                            room.cells.Get(x, y)->SetType(CellData::Type::Floor);
                             break;
                         case WALL_SYMBOL:
-                            room.cells.Get(x, y)->type = CellData::Type::Wall;
+                            room.cells.Get(x, y)->SetType(CellData::Type::Wall);
                             break;
 
                         case ICE_SYMBOL:
-                            room.cells.Get(x, y)->type = CellData::Type::Ice;
+                            room.cells.Get(x, y)->SetType(CellData::Type::Ice);
                             break;
 
                         case GOAL_SYMBOL:
-                            room.cells.Get(x, y)->type = CellData::Type::Goal;
+                            room.cells.Get(x, y)->SetType(CellData::Type::Goal);
                             room.goalX = x;
                             room.goalY = y;
                             break;
 
                         default:
-                            room.cells.Get(x, y)->type = CellData::Type::Empty;
+                            room.cells.Get(x, y)->SetType(CellData::Type::Empty);
                             break;
                     }
                 }
@@ -165,8 +529,100 @@ bool LevelData::LoadFromFile(const std::string &levelFilePath)
             }
         }   
 
-        file >> room.playerStartX >> room.playerStartY;
+        stream >> room.playerStartX >> room.playerStartY;
+
+        // Index the switch and door positions so that they can be looked up
+        // per cell. If a letter appears more than once, the last one wins.
+        room.switchIndices.ForEach([](const int32_t&, const int32_t&, int8_t& switchIndex)
+        {
+            switchIndex = -1;
+        });
+        for (const SwitchDoorMapping &mapping : room.switchDoorMappings)
+        {
+            int8_t switchIndex = static_cast<int8_t>(mapping.switchId - 'a');
+            room.switchIndices.Set(mapping.switchX, mapping.switchY, switchIndex);
+            room.switchIndices.Set(mapping.doorX, mapping.doorY, switchIndex);
+        }
+
+        room.ResetCells();
+        room.Analyze();
     }
 
     return true;
 }
+
+/**
+ * @brief Saves the level data to the specified file, in a format LoadFromFile() reads back
+ * @param[in] levelFilePath Path to the file to write
+ * @return Returns true if the operation was successful. Returns false otherwise
+ */
+bool LevelData::SaveToFile(const std::string& levelFilePath) const
+{
+    std::ofstream file(levelFilePath);
+    if (file.fail())
+    {
+        return false;
+    }
+
+    return SaveToStream(file);
+}
+
+/**
+ * @brief Saves the level data to the specified stream, in the same format as level files
+ * @param[in] stream Stream to write the level data to
+ * @return Returns true if the operation was successful. Returns false otherwise
+ */
+bool LevelData::SaveToStream(std::ostream& stream) const
+{
+    stream << descriptionLines.size() << std::endl;
+    for (const std::string &descriptionLine : descriptionLines)
+    {
+        stream << descriptionLine << std::endl;
+    }
+
+    stream << rooms.size() << std::endl;
+    for (const RoomData &room : rooms)
+    {
+        int32_t roomWidth = room.cells.GetWidth();
+        int32_t roomHeight = room.cells.GetHeight();
+        stream << roomWidth << " " << roomHeight << std::endl;
+
+        std::string line;
+        for (int32_t y = 0; y < roomHeight; ++y)
+        {
+            line.clear();
+            for (int32_t x = 0; x < roomWidth; ++x)
+            {
+                switch (room.cells.Get(x, y)->GetType())
+                {
+                    case CellData::Type::Floor:
+                        line.push_back(FLOOR_SYMBOL);
+                        break;
+                    case CellData::Type::Wall:
+                        line.push_back(WALL_SYMBOL);
+                        break;
+                    case CellData::Type::Ice:
+                        line.push_back(ICE_SYMBOL);
+                        break;
+                    case CellData::Type::Goal:
+                        line.push_back(GOAL_SYMBOL);
+                        break;
+                    case CellData::Type::Switch:
+                        line.push_back(static_cast<char>(room.GetSwitchIdFromSwitchPosition(x, y)));
+                        break;
+                    case CellData::Type::Door:
+                        line.push_back(static_cast<char>(std::toupper(room.GetSwitchIdFromDoorPosition(x, y))));
+                        break;
+                    default:
+                        line.push_back(EMPTY_SYMBOL);
+                        break;
+                }
+            }
+            stream << line << std::endl;
+        }
+
+        stream << room.playerStartX << " " << room.playerStartY << std::endl;
+    }
+
+    return !stream.fail();
+}
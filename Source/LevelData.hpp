@@ -1,9 +1,13 @@
 #pragma once
 
+#include "BorderedGrid.hpp"
+#include "Constants.hpp"
 #include "Grid.hpp"
 
+#include <array>
 #include <cstdint>
-#include <map>
+#include <istream>
+#include <ostream>
 #include <string>
 #include <vector>
 
@@ -40,14 +44,14 @@ struct SwitchDoorMapping
 };
 
 /**
- * Struct containing data about a cell in the level data
+ * Struct containing data about a cell in the level data, packed into a single byte
  */
 struct CellData
 {
     /**
      * Cell type enum
      */
-    enum class Type
+    enum class Type : uint8_t
     {
         Empty,
         Floor,
@@ -58,20 +62,146 @@ struct CellData
         Goal
     };
 
+private:
     /**
-     * Cell type
+     * Mask for the bits holding the cell type
      */
-    Type type;
+    static constexpr uint8_t TYPE_MASK = 0x07;
 
     /**
-     * Flag indicating whether this cell has been visited or not
+     * Bit indicating whether this cell has been visited or not
      */
-    bool isVisited;
+    static constexpr uint8_t VISITED_BIT = 0x08;
 
     /**
-     * Current state of the cell
+     * Bit holding the current state of the cell
      */
-    int32_t state;
+    static constexpr uint8_t STATE_BIT = 0x10;
+
+    /**
+     * Packed cell type, visited flag and state
+     */
+    uint8_t m_bits;
+
+public:
+    /**
+     * @brief Constructor. The cell is an unvisited empty cell with a state of 0.
+     */
+    constexpr CellData()
+        : m_bits(0)
+    {
+    }
+
+    /**
+     * @brief Gets the cell type
+     * @return Cell type
+     */
+    constexpr Type GetType() const
+    {
+        return static_cast<Type>(m_bits & TYPE_MASK);
+    }
+
+    /**
+     * @brief Sets the cell type
+     * @param[in] type Cell type
+     */
+    constexpr void SetType(const Type& type)
+    {
+        m_bits = (m_bits & ~TYPE_MASK) | static_cast<uint8_t>(type);
+    }
+
+    /**
+     * @brief Queries whether this cell has been visited or not
+     * @return Returns true if the cell has been visited
+     */
+    constexpr bool IsVisited() const
+    {
+        return (m_bits & VISITED_BIT) != 0;
+    }
+
+    /**
+     * @brief Sets whether this cell has been visited or not
+     * @param[in] isVisited Flag indicating whether the cell has been visited
+     */
+    constexpr void SetVisited(const bool& isVisited)
+    {
+        m_bits = isVisited ? (m_bits | VISITED_BIT) : (m_bits & ~VISITED_BIT);
+    }
+
+    /**
+     * @brief Gets the current state of the cell
+     * @return Current state of the cell. One of the *_STATE values in Constants.hpp
+     */
+    constexpr int32_t GetState() const
+    {
+        return ((m_bits & STATE_BIT) != 0) ? 1 : 0;
+    }
+
+    /**
+     * @brief Sets the current state of the cell
+     * @param[in] state New state of the cell. One of the *_STATE values in Constants.hpp
+     */
+    constexpr void SetState(const int32_t& state)
+    {
+        m_bits = (state != 0) ? (m_bits | STATE_BIT) : (m_bits & ~STATE_BIT);
+    }
+};
+
+static_assert(sizeof(CellData) == 1, "CellData is expected to be packed into a single byte");
+static_assert((Constants::GOAL_LOCKED_STATE == 0) && (Constants::GOAL_UNLOCKED_STATE == 1)
+    && (Constants::SWITCH_UNPRESSED_STATE == 0) && (Constants::SWITCH_PRESSED_STATE == 1)
+    && (Constants::DOOR_LOCKED_STATE == 0) && (Constants::DOOR_UNLOCKED_STATE == 1),
+    "Cell states are expected to fit in a single bit");
+
+/**
+ * Results of the cheap checks run on a room when it is loaded, which can prove
+ * that a room is unsolvable without searching it. A room that passes every
+ * check may still be unsolvable.
+ */
+struct RoomAnalysis
+{
+    /**
+     * Flag indicating whether the player's starting position is outside the room
+     * or on a wall, or the room has no goal
+     */
+    bool hasInvalidStartOrGoal;
+
+    /**
+     * Flag indicating whether the floors cannot be split evenly between the two
+     * colors of a checkerboard, as a path from the start to the goal needs to.
+     * Only checked for rooms made of floors and walls.
+     */
+    bool hasParityMismatch;
+
+    /**
+     * Number of floor cells, other than the start, that cannot be both entered
+     * and left because they have a single neighbor that is not a wall or ice
+     */
+    int32_t numDeadEndFloors;
+
+    /**
+     * Number of floor cells that cannot be reached from the player's starting
+     * position, even if every door that can be unlocked is unlocked
+     */
+    int32_t numUnreachableFloors;
+
+    /**
+     * Flag indicating whether the goal cannot be reached from the player's
+     * starting position, even if every door that can be unlocked is unlocked
+     */
+    bool isGoalUnreachable;
+
+    /**
+     * Number of doors that can never be unlocked, because their switch is
+     * missing or cannot be reached
+     */
+    int32_t numUnopenableDoors;
+
+    /**
+     * @brief Queries whether any of the checks proves that the room is unsolvable
+     * @return Returns true if the room is provably unsolvable
+     */
+    bool IsProvablyUnsolvable() const;
 };
 
 /**
@@ -80,9 +210,9 @@ struct CellData
 struct RoomData
 {
     /**
-     * Grid for the cell data
+     * Grid for the cell data, surrounded by a border of wall cells
      */
-    Grid<CellData> cells;
+    BorderedGrid<CellData> cells;
 
     /**
      * Player's starting X-position
@@ -105,9 +235,98 @@ struct RoomData
     int32_t goalY;
 
     /**
-     * List of mappings between switches and doors in the room
+     * Maximum number of switch-door pairs in a room, one for each letter
+     */
+    static constexpr int32_t MAX_SWITCHES = 26;
+
+    /**
+     * List of mappings between switches and doors in the room, indexed by
+     * (switch ID - 'a'). Unused entries have a switch ID of -1
+     */
+    std::array<SwitchDoorMapping, MAX_SWITCHES> switchDoorMappings;
+
+    /**
+     * Index into the switch-door mappings (switch ID - 'a') of the switch or door
+     * at each cell. -1 for all other cells. Kept to one byte per cell, like CellData
+     */
+    Grid<int8_t> switchIndices;
+
+    /**
+     * Number of floor cells that have not been visited yet
+     */
+    int32_t numUnvisitedFloors;
+
+    /**
+     * Results of the unsolvability checks, computed when the room is loaded
+     */
+    RoomAnalysis analysis;
+
+    /**
+     * @brief Runs the unsolvability checks on the room layout in linear time, and
+     * stores the results in analysis
+     */
+    void Analyze();
+
+    /**
+     * @brief Resets the state of all the cells in the room, and marks the
+     * player's starting cell as visited
+     */
+    void ResetCells();
+
+    /**
+     * @brief Marks the cell at the specified position as visited
+     * @param[in] x X-coordinate
+     * @param[in] y Y-coordinate
+     */
+    void VisitCell(const int32_t& x, const int32_t& y);
+
+    /**
+     * @brief Marks the cell at the specified position as not visited, undoing VisitCell()
+     * @param[in] x X-coordinate
+     * @param[in] y Y-coordinate
+     */
+    void UnvisitCell(const int32_t& x, const int32_t& y);
+
+    /**
+     * @brief Unlocks the door at the specified position
+     * @param[in] x X-coordinate
+     * @param[in] y Y-coordinate
+     */
+    void UnlockDoor(const int32_t& x, const int32_t& y);
+
+    /**
+     * @brief Locks the door at the specified position, undoing UnlockDoor()
+     * @param[in] x X-coordinate
+     * @param[in] y Y-coordinate
+     */
+    void LockDoor(const int32_t& x, const int32_t& y);
+
+    /**
+     * @brief Queries whether the player can currently enter the cell at the specified index
+     * @param[in] cellIndex Index in the cells grid
+     * @return Returns true if the cell is not a wall, not visited, and not a locked door
+     */
+    bool IsTraversible(const int32_t& cellIndex) const;
+
+    /**
+     * @brief Checks if the room is completed or not
+     * @return Returns true if every floor cell in the room has been visited
+     */
+    bool IsComplete() const;
+
+    /**
+     * @brief Queries whether the goal is unlocked or not
+     * @return Returns true if the goal is unlocked
+     */
+    bool IsGoalUnlocked() const;
+
+    /**
+     * @brief Gets the mapping for the specified switch ID
+     * @param[in] switchId Switch ID
+     * @return Pointer to the mapping for the specified switch ID. Returns nullptr
+     * if the room has no switch or door with the specified ID.
      */
-    std::map<int32_t, SwitchDoorMapping> switchDoorMappings;
+    SwitchDoorMapping* GetSwitchDoorMapping(const int32_t& switchId);
 
     /**
      * @brief Gets the switch ID from the switch position
@@ -116,7 +335,7 @@ struct RoomData
      * @return Switch ID of the switch at the specified position. If the switch at
      * the specified position does not exist in the database, returns -1.
      */
-    int32_t GetSwitchIdFromSwitchPosition(const int32_t& switchX, const int32_t& switchY);
+    int32_t GetSwitchIdFromSwitchPosition(const int32_t& switchX, const int32_t& switchY) const;
 
     /**
      * @brief Gets the switch ID from the door position
@@ -125,7 +344,7 @@ struct RoomData
      * @return Switch ID of the door at the specified position. If the door at
      * the specified position does not exist in the database, returns -1.
      */
-    int32_t GetSwitchIdFromDoorPosition(const int32_t& doorX, const int32_t& doorY);
+    int32_t GetSwitchIdFromDoorPosition(const int32_t& doorX, const int32_t& doorY) const;
 };
 
 /**
@@ -160,4 +379,25 @@ public:
      * @return Returns true if the operation was successful. Returns false otherwise
      */
     bool LoadFromFile(const std::string& levelFilePath);
+
+    /**
+     * @brief Loads the level data from the specified stream, in the same format as level files
+     * @param[in] stream Stream containing the level data
+     * @return Returns true if the operation was successful. Returns false otherwise
+     */
+    bool LoadFromStream(std::istream& stream);
+
+    /**
+     * @brief Saves the level data to the specified file, in a format LoadFromFile() reads back
+     * @param[in] levelFilePath Path to the file to write
+     * @return Returns true if the operation was successful. Returns false otherwise
+     */
+    bool SaveToFile(const std::string& levelFilePath) const;
+
+    /**
+     * @brief Saves the level data to the specified stream, in the same format as level files
+     * @param[in] stream Stream to write the level data to
+     * @return Returns true if the operation was successful. Returns false otherwise
+     */
+    bool SaveToStream(std::ostream& stream) const;
 };
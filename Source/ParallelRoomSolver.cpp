@@ -0,0 +1,279 @@
+#include "ParallelRoomSolver.hpp"
+
+#include <thread>
+
+#define DEFAULT_NODE_BUDGET_PER_TASK 20000
+
+/**
+ * @brief Constructor. Uses as many worker threads as the hardware supports.
+ */
+ParallelRoomSolver::ParallelRoomSolver()
+    : m_numThreads(1)
+    , m_nodeBudgetPerTask(DEFAULT_NODE_BUDGET_PER_TASK)
+    , m_maxNodes(0)
+    , m_workerQueues()
+    , m_workerSolvers()
+    , m_numPendingTasks(0)
+    , m_isCancelled(false)
+    , m_numNodesExpanded(0)
+    , m_numTasksStolen(0)
+    , m_hasHitNodeLimit(false)
+    , m_solutionMutex()
+    , m_isSolved(false)
+    , m_solution()
+{
+    SetNumThreads(0);
+}
+
+/**
+ * @brief Destructor
+ */
+ParallelRoomSolver::~ParallelRoomSolver()
+{
+}
+
+/**
+ * @brief Sets the number of worker threads
+ * @param[in] numThreads Number of worker threads. 0 to use as many as the hardware supports
+ */
+void ParallelRoomSolver::SetNumThreads(const int32_t& numThreads)
+{
+    m_numThreads = numThreads;
+    if (m_numThreads <= 0)
+    {
+        m_numThreads = static_cast<int32_t>(std::thread::hardware_concurrency());
+    }
+    if (m_numThreads <= 0)
+    {
+        m_numThreads = 1;
+    }
+}
+
+/**
+ * @brief Gets the number of worker threads
+ * @return Number of worker threads
+ */
+int32_t ParallelRoomSolver::GetNumThreads() const
+{
+    return m_numThreads;
+}
+
+/**
+ * @brief Sets the number of search nodes a worker expands in a subtree before splitting it
+ * @param[in] nodeBudgetPerTask Number of search nodes
+ */
+void ParallelRoomSolver::SetNodeBudgetPerTask(const uint64_t& nodeBudgetPerTask)
+{
+    m_nodeBudgetPerTask = (nodeBudgetPerTask > 0) ? nodeBudgetPerTask : 1;
+}
+
+/**
+ * @brief Sets the maximum number of search nodes to expand across all workers before giving up
+ * @param[in] maxNodes Maximum number of search nodes. 0 means no limit
+ */
+void ParallelRoomSolver::SetMaxNodes(const uint64_t& maxNodes)
+{
+    m_maxNodes = maxNodes;
+}
+
+/**
+ * @brief Searches for a sequence of moves that solves the specified room
+ * @param[in] roomData Room data
+ * @param[out] moves Sequence of moves that solves the room
+ * @return Returns true if a solution was found. Returns false otherwise
+ */
+bool ParallelRoomSolver::Solve(const RoomData& roomData, std::vector<Direction>& moves)
+{
+    moves.clear();
+    m_numNodesExpanded = 0;
+    m_numTasksStolen = 0;
+    m_hasHitNodeLimit = false;
+    m_isCancelled = false;
+    m_isSolved = false;
+    m_solution.clear();
+
+    m_workerQueues.clear();
+    for (int32_t i = 0; i < m_numThreads; ++i)
+    {
+        m_workerQueues.push_back(std::make_unique<WorkerQueue>());
+    }
+
+    while (static_cast<int32_t>(m_workerSolvers.size()) < m_numThreads)
+    {
+        m_workerSolvers.push_back(std::make_unique<RoomSolver>());
+        m_workerSolvers.back()->SetCancellationFlag(&m_isCancelled);
+        m_workerSolvers.back()->SetKeepingTranspositionTable(true);
+    }
+    for (int32_t i = 0; i < m_numThreads; ++i)
+    {
+        // Dead ends are only known for the room they were found in
+        m_workerSolvers[i]->ClearTranspositionTable();
+        m_workerSolvers[i]->SetMaxNodes(m_nodeBudgetPerTask);
+    }
+
+    // The whole search tree is the first subtree
+    m_numPendingTasks = 1;
+    m_workerQueues[0]->tasks.emplace_back();
+
+    std::vector<std::thread> threads;
+    for (int32_t i = 1; i < m_numThreads; ++i)
+    {
+        threads.emplace_back(&ParallelRoomSolver::RunWorker, this, std::cref(roomData), i);
+    }
+    RunWorker(roomData, 0);
+    for (std::thread &thread : threads)
+    {
+        thread.join();
+    }
+
+    m_workerQueues.clear();
+
+    if (m_isSolved)
+    {
+        moves = m_solution;
+        return true;
+    }
+
+    return false;
+}
+
+/**
+ * @brief Gets the number of search nodes expanded by all workers in the last call to Solve()
+ * @return Number of search nodes expanded
+ */
+uint64_t ParallelRoomSolver::GetNumNodesExpanded() const
+{
+    return m_numNodesExpanded;
+}
+
+/**
+ * @brief Gets the number of subtrees taken from the queue of another worker in the last call to Solve()
+ * @return Number of stolen subtrees
+ */
+uint64_t ParallelRoomSolver::GetNumTasksStolen() const
+{
+    return m_numTasksStolen;
+}
+
+/**
+ * @brief Queries whether the last call to Solve() gave up due to the node limit
+ * @return Returns true if the search gave up before exhausting all possibilities
+ */
+bool ParallelRoomSolver::HasHitNodeLimit() const
+{
+    return m_hasHitNodeLimit;
+}
+
+/**
+ * @brief Runs a worker until the search is finished or cancelled
+ * @param[in] roomData Room data
+ * @param[in] workerIndex Index of the worker
+ */
+void ParallelRoomSolver::RunWorker(const RoomData& roomData, const int32_t& workerIndex)
+{
+    RoomSolver &solver = *m_workerSolvers[workerIndex];
+    std::vector<Direction> task;
+    std::vector<Direction> moves;
+    std::vector<std::vector<Direction>> unsearchedSubtrees;
+    while (!m_isCancelled.load(std::memory_order_relaxed))
+    {
+        if (!TakeTask(workerIndex, task))
+        {
+            if (m_numPendingTasks.load() == 0)
+            {
+                break;
+            }
+
+            std::this_thread::yield();
+            continue;
+        }
+
+        bool isSolved = solver.Solve(roomData, task, moves, unsearchedSubtrees);
+        uint64_t numNodesExpanded = solver.GetNumNodesExpanded();
+        if (!isSolved && !unsearchedSubtrees.empty() && !m_isCancelled.load(std::memory_order_relaxed))
+        {
+            // The subtree is too large for one task. Queue the parts left unsearched so
+            // that idle workers can help, without searching the finished parts again.
+            WorkerQueue &queue = *m_workerQueues[workerIndex];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            m_numPendingTasks += static_cast<int32_t>(unsearchedSubtrees.size());
+
+            // Pushed in reverse, so that the deepest subtree is taken next by this
+            // worker, and the shallowest (largest) ones are stolen first
+            for (auto it = unsearchedSubtrees.rbegin(); it != unsearchedSubtrees.rend(); ++it)
+            {
+                queue.tasks.push_back(std::move(*it));
+            }
+        }
+
+        if (isSolved)
+        {
+            PublishSolution(moves);
+        }
+
+        uint64_t totalNodesExpanded = (m_numNodesExpanded += numNodesExpanded);
+        if ((m_maxNodes != 0) && (totalNodesExpanded > m_maxNodes))
+        {
+            std::lock_guard<std::mutex> lock(m_solutionMutex);
+            if (!m_isSolved)
+            {
+                m_hasHitNodeLimit = true;
+                m_isCancelled = true;
+            }
+        }
+
+        --m_numPendingTasks;
+    }
+}
+
+/**
+ * @brief Takes a subtree from the back of the worker's own queue, or steals one
+ * from the front of another worker's queue
+ * @param[in] workerIndex Index of the worker
+ * @param[out] task Moves leading to the root of the subtree
+ * @return Returns true if a subtree was taken. Returns false if all queues are empty
+ */
+bool ParallelRoomSolver::TakeTask(const int32_t& workerIndex, std::vector<Direction>& task)
+{
+    {
+        WorkerQueue &ownQueue = *m_workerQueues[workerIndex];
+        std::lock_guard<std::mutex> lock(ownQueue.mutex);
+        if (!ownQueue.tasks.empty())
+        {
+            task = std::move(ownQueue.tasks.back());
+            ownQueue.tasks.pop_back();
+            return true;
+        }
+    }
+
+    for (int32_t i = 1; i < m_numThreads; ++i)
+    {
+        WorkerQueue &victimQueue = *m_workerQueues[(workerIndex + i) % m_numThreads];
+        std::lock_guard<std::mutex> lock(victimQueue.mutex);
+        if (!victimQueue.tasks.empty())
+        {
+            task = std::move(victimQueue.tasks.front());
+            victimQueue.tasks.pop_front();
+            ++m_numTasksStolen;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief Records a solution and stops all workers. Only the first solution is kept.
+ * @param[in] moves Sequence of moves that solves the room
+ */
+void ParallelRoomSolver::PublishSolution(const std::vector<Direction>& moves)
+{
+    std::lock_guard<std::mutex> lock(m_solutionMutex);
+    if (!m_isSolved)
+    {
+        m_isSolved = true;
+        m_solution = moves;
+    }
+
+    m_isCancelled = true;
+}
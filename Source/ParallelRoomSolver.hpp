@@ -0,0 +1,199 @@
+#pragma once
+
+#include "Direction.hpp"
+#include "LevelData.hpp"
+#include "RoomSolver.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/**
+ * Multi-threaded variant of RoomSolver. The search tree is split into subtrees,
+ * each identified by the moves leading to its root, which are scheduled over
+ * a pool of worker threads with work stealing.
+ *
+ * A worker searches its subtree with a RoomSolver under a node budget. If the
+ * budget runs out, the parts of the subtree the worker has not searched yet (the
+ * node it stopped at, and the successors not tried yet along its search path)
+ * are pushed to the worker's own queue, where idle workers can steal them.
+ * Workers take their own work from the back of their queue (depth first) and
+ * steal from the front of other queues (the largest subtrees). All workers stop
+ * as soon as one of them finds a solution.
+ *
+ * Each worker keeps its RoomSolver between tasks and between calls to Solve(),
+ * so the transposition table is only allocated once, and the dead ends a worker
+ * finds in one task are still known in its later tasks of the same room.
+ */
+class ParallelRoomSolver
+{
+private:
+    /**
+     * Queue of subtrees waiting to be searched by a worker
+     */
+    struct WorkerQueue
+    {
+        /**
+         * Mutex guarding the queue
+         */
+        std::mutex mutex;
+
+        /**
+         * Moves leading to the root of each subtree
+         */
+        std::deque<std::vector<Direction>> tasks;
+    };
+
+private:
+    /**
+     * Number of worker threads
+     */
+    int32_t m_numThreads;
+
+    /**
+     * Number of search nodes a worker expands in a subtree before splitting it
+     */
+    uint64_t m_nodeBudgetPerTask;
+
+    /**
+     * Maximum number of search nodes to expand across all workers before giving up. 0 means no limit
+     */
+    uint64_t m_maxNodes;
+
+    /**
+     * Queue of each worker
+     */
+    std::vector<std::unique_ptr<WorkerQueue>> m_workerQueues;
+
+    /**
+     * Solver of each worker, kept between calls to Solve()
+     */
+    std::vector<std::unique_ptr<RoomSolver>> m_workerSolvers;
+
+    /**
+     * Number of subtrees that are queued or being searched
+     */
+    std::atomic<int32_t> m_numPendingTasks;
+
+    /**
+     * Flag that stops all workers once set
+     */
+    std::atomic<bool> m_isCancelled;
+
+    /**
+     * Number of search nodes expanded by all workers in the last call to Solve()
+     */
+    std::atomic<uint64_t> m_numNodesExpanded;
+
+    /**
+     * Number of subtrees taken from the queue of another worker in the last call to Solve()
+     */
+    std::atomic<uint64_t> m_numTasksStolen;
+
+    /**
+     * Flag indicating whether the last search gave up due to the node limit
+     */
+    std::atomic<bool> m_hasHitNodeLimit;
+
+    /**
+     * Mutex guarding the solution
+     */
+    std::mutex m_solutionMutex;
+
+    /**
+     * Flag indicating whether a solution was found
+     */
+    bool m_isSolved;
+
+    /**
+     * First solution found by any worker
+     */
+    std::vector<Direction> m_solution;
+
+public:
+    /**
+     * @brief Constructor. Uses as many worker threads as the hardware supports.
+     */
+    ParallelRoomSolver();
+
+    /**
+     * @brief Destructor
+     */
+    ~ParallelRoomSolver();
+
+    /**
+     * @brief Sets the number of worker threads
+     * @param[in] numThreads Number of worker threads. 0 to use as many as the hardware supports
+     */
+    void SetNumThreads(const int32_t& numThreads);
+
+    /**
+     * @brief Gets the number of worker threads
+     * @return Number of worker threads
+     */
+    int32_t GetNumThreads() const;
+
+    /**
+     * @brief Sets the number of search nodes a worker expands in a subtree before splitting it
+     * @param[in] nodeBudgetPerTask Number of search nodes
+     */
+    void SetNodeBudgetPerTask(const uint64_t& nodeBudgetPerTask);
+
+    /**
+     * @brief Sets the maximum number of search nodes to expand across all workers before giving up
+     * @param[in] maxNodes Maximum number of search nodes. 0 means no limit
+     */
+    void SetMaxNodes(const uint64_t& maxNodes);
+
+    /**
+     * @brief Searches for a sequence of moves that solves the specified room
+     * @param[in] roomData Room data
+     * @param[out] moves Sequence of moves that solves the room
+     * @return Returns true if a solution was found. Returns false otherwise
+     */
+    bool Solve(const RoomData& roomData, std::vector<Direction>& moves);
+
+    /**
+     * @brief Gets the number of search nodes expanded by all workers in the last call to Solve()
+     * @return Number of search nodes expanded
+     */
+    uint64_t GetNumNodesExpanded() const;
+
+    /**
+     * @brief Gets the number of subtrees taken from the queue of another worker in the last call to Solve()
+     * @return Number of stolen subtrees
+     */
+    uint64_t GetNumTasksStolen() const;
+
+    /**
+     * @brief Queries whether the last call to Solve() gave up due to the node limit
+     * @return Returns true if the search gave up before exhausting all possibilities
+     */
+    bool HasHitNodeLimit() const;
+
+private:
+    /**
+     * @brief Runs a worker until the search is finished or cancelled
+     * @param[in] roomData Room data
+     * @param[in] workerIndex Index of the worker
+     */
+    void RunWorker(const RoomData& roomData, const int32_t& workerIndex);
+
+    /**
+     * @brief Takes a subtree from the back of the worker's own queue, or steals one
+     * from the front of another worker's queue
+     * @param[in] workerIndex Index of the worker
+     * @param[out] task Moves leading to the root of the subtree
+     * @return Returns true if a subtree was taken. Returns false if all queues are empty
+     */
+    bool TakeTask(const int32_t& workerIndex, std::vector<Direction>& task);
+
+    /**
+     * @brief Records a solution and stops all workers. Only the first solution is kept.
+     * @param[in] moves Sequence of moves that solves the room
+     */
+    void PublishSolution(const std::vector<Direction>& moves);
+};
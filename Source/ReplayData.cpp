@@ -0,0 +1,115 @@
+#include "ReplayData.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#define REPLAY_MAGIC "HERP"
+#define REPLAY_MAGIC_SIZE 4
+#define REPLAY_HEADER_SIZE 12
+
+/**
+ * @brief Loads the next replay from the specified stream. The moves vector is
+ * reused, so loading many replays into the same replay data does not allocate
+ * @param[in] stream Stream containing the replays
+ * @return Returns true if the operation was successful. Returns false otherwise,
+ * including when the stream has no more replays
+ */
+bool ReplayData::LoadFromStream(std::istream& stream)
+{
+    std::array<uint8_t, REPLAY_HEADER_SIZE> header;
+    if (!stream.read(reinterpret_cast<char*>(header.data()), header.size()))
+    {
+        return false;
+    }
+    if (std::memcmp(header.data(), REPLAY_MAGIC, REPLAY_MAGIC_SIZE) != 0)
+    {
+        std::cerr << "Replay does not start with " << REPLAY_MAGIC << "!" << std::endl;
+        return false;
+    }
+
+    levelId = header[4] | (header[5] << 8);
+    roomIndex = header[6] | (header[7] << 8);
+    uint32_t numMoves = header[8] | (header[9] << 8) | (header[10] << 16) | (static_cast<uint32_t>(header[11]) << 24);
+    if (numMoves > MAX_MOVES)
+    {
+        std::cerr << "Replay has " << numMoves << " moves, but at most " << MAX_MOVES << " are allowed!" << std::endl;
+        return false;
+    }
+
+    moves.resize(numMoves);
+    std::array<uint8_t, 4096> buffer;
+    uint32_t moveIndex = 0;
+    while (moveIndex < numMoves)
+    {
+        uint32_t numBytes = std::min<uint32_t>(buffer.size(), (numMoves - moveIndex + 3) / 4);
+        if (!stream.read(reinterpret_cast<char*>(buffer.data()), numBytes))
+        {
+            std::cerr << "Replay ends after " << moveIndex << " of its " << numMoves << " moves!" << std::endl;
+            return false;
+        }
+
+        for (uint32_t i = 0; (i < numBytes * 4) && (moveIndex < numMoves); ++i, ++moveIndex)
+        {
+            moves[moveIndex] = static_cast<Direction>((buffer[i / 4] >> ((i % 4) * 2)) & 0x03);
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Appends the replay to the specified file, creating it if needed
+ * @param[in] replayFilePath Path to the replay file
+ * @return Returns true if the operation was successful. Returns false otherwise
+ */
+bool ReplayData::AppendToFile(const std::string& replayFilePath) const
+{
+    std::ofstream file(replayFilePath, std::ios::binary | std::ios::app);
+    if (file.fail() || !SaveToStream(file))
+    {
+        return false;
+    }
+
+    // Closing flushes the buffered writes, which can still fail
+    file.close();
+    return !file.fail();
+}
+
+/**
+ * @brief Saves the replay to the specified stream
+ * @param[in] stream Stream to write the replay to
+ * @return Returns true if the operation was successful. Returns false otherwise
+ */
+bool ReplayData::SaveToStream(std::ostream& stream) const
+{
+    if ((levelId < 0) || (levelId > 0xFFFF) || (roomIndex < 0) || (roomIndex > 0xFFFF) || (moves.size() > MAX_MOVES))
+    {
+        std::cerr << "Replay does not fit in the replay format!" << std::endl;
+        return false;
+    }
+
+    uint32_t numMoves = static_cast<uint32_t>(moves.size());
+    std::array<uint8_t, REPLAY_HEADER_SIZE> header;
+    std::memcpy(header.data(), REPLAY_MAGIC, REPLAY_MAGIC_SIZE);
+    header[4] = levelId & 0xFF;
+    header[5] = (levelId >> 8) & 0xFF;
+    header[6] = roomIndex & 0xFF;
+    header[7] = (roomIndex >> 8) & 0xFF;
+    header[8] = numMoves & 0xFF;
+    header[9] = (numMoves >> 8) & 0xFF;
+    header[10] = (numMoves >> 16) & 0xFF;
+    header[11] = (numMoves >> 24) & 0xFF;
+    stream.write(reinterpret_cast<const char*>(header.data()), header.size());
+
+    std::vector<uint8_t> packedMoves((numMoves + 3) / 4, 0);
+    for (uint32_t i = 0; i < numMoves; ++i)
+    {
+        packedMoves[i / 4] |= static_cast<uint8_t>(moves[i]) << ((i % 4) * 2);
+    }
+    stream.write(reinterpret_cast<const char*>(packedMoves.data()), packedMoves.size());
+
+    return !stream.fail();
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "Direction.hpp"
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * Struct containing the moves a player made to complete a room.
+ *
+ * Replays are stored in a compact binary format, so that many of them can be
+ * appended to one file and read back one at a time. Each replay is:
+ * - the 4 bytes "HERP"
+ * - the level ID, as a 16-bit little-endian integer
+ * - the room index, as a 16-bit little-endian integer
+ * - the number of moves, as a 32-bit little-endian integer
+ * - the moves, 2 bits each (the value of the Direction enum), packed four to a
+ *   byte starting from the lowest bits, with the last byte padded with zeros
+ */
+struct ReplayData
+{
+    /**
+     * Maximum number of moves in a replay, to reject corrupted replays before
+     * allocating memory for their moves
+     */
+    static constexpr uint32_t MAX_MOVES = 1 << 24;
+
+    /**
+     * ID of the level, the same as the number in its level file name (level<ID>.dat)
+     */
+    int32_t levelId;
+
+    /**
+     * Index of the room in the level, starting from 0
+     */
+    int32_t roomIndex;
+
+    /**
+     * Moves made in the room, in order
+     */
+    std::vector<Direction> moves;
+
+    /**
+     * @brief Loads the next replay from the specified stream. The moves vector is
+     * reused, so loading many replays into the same replay data does not allocate
+     * @param[in] stream Stream containing the replays
+     * @return Returns true if the operation was successful. Returns false otherwise,
+     * including when the stream has no more replays
+     */
+    bool LoadFromStream(std::istream& stream);
+
+    /**
+     * @brief Appends the replay to the specified file, creating it if needed
+     * @param[in] replayFilePath Path to the replay file
+     * @return Returns true if the operation was successful. Returns false otherwise
+     */
+    bool AppendToFile(const std::string& replayFilePath) const;
+
+    /**
+     * @brief Saves the replay to the specified stream
+     * @param[in] stream Stream to write the replay to
+     * @return Returns true if the operation was successful. Returns false otherwise
+     */
+    bool SaveToStream(std::ostream& stream) const;
+};
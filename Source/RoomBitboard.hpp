@@ -0,0 +1,794 @@
+#pragma once
+
+#include "Bitboard.hpp"
+#include "Direction.hpp"
+#include "LevelData.hpp"
+#include "ZobristKeys.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+/**
+ * Record of the cells changed by a single move on a room bitboard, used to undo the move
+ */
+struct RoomMoveRecord
+{
+    /**
+     * Index of the cell that became visited. -1 if no cell became visited
+     */
+    int32_t visitedCellIndex;
+
+    /**
+     * Index of the cell unlocked by a pressed switch. -1 if no switch got pressed
+     */
+    int32_t unlockedCellIndex;
+
+    /**
+     * Flag indicating whether the unlocked cell was already unlocked before the move
+     */
+    bool wasCellUnlocked;
+
+    /**
+     * Flag indicating whether the goal was unlocked before the move
+     */
+    bool wasGoalUnlocked;
+
+    /**
+     * Flag indicating whether the move entered the unlocked goal
+     */
+    bool hasReachedGoal;
+};
+
+/**
+ * @brief Gets the Zobrist keys of the room state features changed by a move, so
+ * that XOR-ing them into a state hash applies the move, and XOR-ing them again
+ * undoes it. The goal is left out, since it is only ever locked with every floor
+ * visited before the first move of the room
+ * @param[in] record Record of the changes made by the move
+ * @return XOR of the keys
+ */
+inline uint64_t GetMoveHashKey(const RoomMoveRecord& record)
+{
+    uint64_t key = 0;
+    if (record.visitedCellIndex != -1)
+    {
+        key ^= ZobristKeys::GetVisitedKey(record.visitedCellIndex);
+    }
+    if ((record.unlockedCellIndex != -1) && !record.wasCellUnlocked)
+    {
+        key ^= ZobristKeys::GetUnlockedKey(record.unlockedCellIndex);
+    }
+
+    return key;
+}
+
+/**
+ * Bitboard representation of a room and its current state, with one bit per cell
+ * in each mask. Moves follow the same rules as the game scene.
+ */
+template <size_t NumWords>
+class RoomBitboard
+{
+public:
+    /**
+     * Bitboard type used for the masks
+     */
+    using Mask = Bitboard<NumWords>;
+
+    /**
+     * Maximum number of cells a room can have to fit in the bitboard
+     */
+    static constexpr int32_t MAX_CELLS = Mask::NUM_BITS;
+
+    /**
+     * Maximum number of switch/door pairs, one for each letter
+     */
+    static constexpr int32_t MAX_SWITCHES = RoomData::MAX_SWITCHES;
+
+private:
+    /**
+     * Link between a switch cell and the cell it unlocks
+     */
+    struct SwitchLink
+    {
+        /**
+         * Cell index of the switch
+         */
+        int32_t switchIndex;
+
+        /**
+         * Cell index of the door unlocked by the switch
+         */
+        int32_t doorIndex;
+    };
+
+private:
+    /**
+     * Room width
+     */
+    int32_t m_width;
+
+    /**
+     * Room height
+     */
+    int32_t m_height;
+
+    /**
+     * Cell index of the player's starting position
+     */
+    int32_t m_startIndex;
+
+    /**
+     * Cell index of the goal. -1 if the room has no goal
+     */
+    int32_t m_goalIndex;
+
+    /**
+     * Mask of all the cells inside the room
+     */
+    Mask m_roomMask;
+
+    /**
+     * Masks of the cells that have a neighbor in each direction, indexed by direction
+     */
+    std::array<Mask, 4> m_hasNeighborMasks;
+
+    /**
+     * Mask of the floor cells
+     */
+    Mask m_floorMask;
+
+    /**
+     * Mask of the wall cells
+     */
+    Mask m_wallMask;
+
+    /**
+     * Mask of the ice cells
+     */
+    Mask m_iceMask;
+
+    /**
+     * Mask of the switch cells
+     */
+    Mask m_switchMask;
+
+    /**
+     * Mask of the door cells
+     */
+    Mask m_doorMask;
+
+    /**
+     * Links between switches and the doors they unlock
+     */
+    std::array<SwitchLink, MAX_SWITCHES> m_switchLinks;
+
+    /**
+     * Number of valid entries in m_switchLinks
+     */
+    int32_t m_numSwitchLinks;
+
+    /**
+     * Mask of the visited cells
+     */
+    Mask m_visitedMask;
+
+    /**
+     * Mask of the cells unlocked by pressed switches
+     */
+    Mask m_unlockedMask;
+
+    /**
+     * Flag indicating whether the goal is unlocked
+     */
+    bool m_isGoalUnlocked;
+
+public:
+    /**
+     * @brief Constructor
+     */
+    RoomBitboard()
+        : m_width(0)
+        , m_height(0)
+        , m_startIndex(0)
+        , m_goalIndex(-1)
+        , m_roomMask()
+        , m_hasNeighborMasks()
+        , m_floorMask()
+        , m_wallMask()
+        , m_iceMask()
+        , m_switchMask()
+        , m_doorMask()
+        , m_switchLinks()
+        , m_numSwitchLinks(0)
+        , m_visitedMask()
+        , m_unlockedMask()
+        , m_isGoalUnlocked(false)
+    {
+    }
+
+    /**
+     * @brief Queries whether a room of the specified size fits in this bitboard
+     * @param[in] width Room width
+     * @param[in] height Room height
+     * @return Returns true if the room fits. Returns false otherwise
+     */
+    static constexpr bool CanFit(const int32_t& width, const int32_t& height)
+    {
+        return (width > 0) && (height > 0) && (width * height <= MAX_CELLS);
+    }
+
+    /**
+     * @brief Builds the bitboard from the specified room data, and resets the room state
+     * @param[in] roomData Room data
+     * @return Returns true if the operation was successful. Returns false if the room
+     * does not fit in the bitboard or if the player's starting position is invalid
+     */
+    bool Build(const RoomData& roomData)
+    {
+        m_width = roomData.cells.GetWidth();
+        m_height = roomData.cells.GetHeight();
+        if (!CanFit(m_width, m_height)
+            || !roomData.cells.IsValidLocation(roomData.playerStartX, roomData.playerStartY))
+        {
+            return false;
+        }
+
+        m_startIndex = roomData.playerStartY * m_width + roomData.playerStartX;
+        m_goalIndex = -1;
+        if (roomData.cells.IsValidLocation(roomData.goalX, roomData.goalY))
+        {
+            m_goalIndex = roomData.goalY * m_width + roomData.goalX;
+        }
+
+        m_roomMask.Clear();
+        m_floorMask.Clear();
+        m_wallMask.Clear();
+        m_iceMask.Clear();
+        m_switchMask.Clear();
+        m_doorMask.Clear();
+        for (Mask &mask : m_hasNeighborMasks)
+        {
+            mask.Clear();
+        }
+
+        for (int32_t y = 0; y < m_height; ++y)
+        {
+            for (int32_t x = 0; x < m_width; ++x)
+            {
+                int32_t cellIndex = y * m_width + x;
+                m_roomMask.Set(cellIndex);
+
+                if (y > 0)
+                {
+                    m_hasNeighborMasks[static_cast<size_t>(Direction::Up)].Set(cellIndex);
+                }
+                if (y < m_height - 1)
+                {
+                    m_hasNeighborMasks[static_cast<size_t>(Direction::Down)].Set(cellIndex);
+                }
+                if (x > 0)
+                {
+                    m_hasNeighborMasks[static_cast<size_t>(Direction::Left)].Set(cellIndex);
+                }
+                if (x < m_width - 1)
+                {
+                    m_hasNeighborMasks[static_cast<size_t>(Direction::Right)].Set(cellIndex);
+                }
+
+                switch (roomData.cells.Get(x, y)->GetType())
+                {
+                    case CellData::Type::Floor:
+                        m_floorMask.Set(cellIndex);
+                        break;
+                    case CellData::Type::Wall:
+                        m_wallMask.Set(cellIndex);
+                        break;
+                    case CellData::Type::Ice:
+                        m_iceMask.Set(cellIndex);
+                        break;
+                    case CellData::Type::Switch:
+                        m_switchMask.Set(cellIndex);
+                        break;
+                    case CellData::Type::Door:
+                        m_doorMask.Set(cellIndex);
+                        break;
+                    default:
+                        break;
+                }
+            }
+        }
+
+        m_numSwitchLinks = 0;
+        for (const SwitchDoorMapping &mapping : roomData.switchDoorMappings)
+        {
+            if ((mapping.switchId == -1)
+                || !roomData.cells.IsValidLocation(mapping.switchX, mapping.switchY)
+                || !roomData.cells.IsValidLocation(mapping.doorX, mapping.doorY))
+            {
+                continue;
+            }
+
+            m_switchLinks[m_numSwitchLinks].switchIndex = mapping.switchY * m_width + mapping.switchX;
+            m_switchLinks[m_numSwitchLinks].doorIndex = mapping.doorY * m_width + mapping.doorX;
+            ++m_numSwitchLinks;
+        }
+
+        Reset();
+
+        return true;
+    }
+
+    /**
+     * @brief Resets the room state, the same way the game scene resets a room
+     */
+    void Reset()
+    {
+        m_visitedMask.Clear();
+        m_unlockedMask.Clear();
+        m_isGoalUnlocked = false;
+        if (m_floorMask.Test(m_startIndex))
+        {
+            m_visitedMask.Set(m_startIndex);
+        }
+    }
+
+    /**
+     * @brief Sets the room state directly, e.g. to expand a search state that was
+     * stored in a more compact form
+     * @param[in] visitedMask Mask of the visited cells
+     * @param[in] unlockedMask Mask of the cells unlocked by pressed switches
+     * @param[in] isGoalUnlocked Flag indicating whether the goal is unlocked
+     */
+    void SetState(const Mask& visitedMask, const Mask& unlockedMask, const bool& isGoalUnlocked)
+    {
+        m_visitedMask = visitedMask;
+        m_unlockedMask = unlockedMask;
+        m_isGoalUnlocked = isGoalUnlocked;
+    }
+
+    /**
+     * @brief Gets the room width
+     * @return Room width
+     */
+    int32_t GetWidth() const
+    {
+        return m_width;
+    }
+
+    /**
+     * @brief Gets the room height
+     * @return Room height
+     */
+    int32_t GetHeight() const
+    {
+        return m_height;
+    }
+
+    /**
+     * @brief Gets the number of cells in the room
+     * @return Number of cells
+     */
+    int32_t GetNumCells() const
+    {
+        return m_width * m_height;
+    }
+
+    /**
+     * @brief Gets the cell index of the player's starting position
+     * @return Cell index of the player's starting position
+     */
+    int32_t GetStartIndex() const
+    {
+        return m_startIndex;
+    }
+
+    /**
+     * @brief Gets the cell index of the goal
+     * @return Cell index of the goal. Returns -1 if the room has no goal
+     */
+    int32_t GetGoalIndex() const
+    {
+        return m_goalIndex;
+    }
+
+    /**
+     * @brief Gets the mask of all the cells inside the room
+     * @return Room mask
+     */
+    const Mask& GetRoomMask() const
+    {
+        return m_roomMask;
+    }
+
+    /**
+     * @brief Gets the mask of the floor cells
+     * @return Floor mask
+     */
+    const Mask& GetFloorMask() const
+    {
+        return m_floorMask;
+    }
+
+    /**
+     * @brief Gets the mask of the wall cells
+     * @return Wall mask
+     */
+    const Mask& GetWallMask() const
+    {
+        return m_wallMask;
+    }
+
+    /**
+     * @brief Gets the mask of the ice cells
+     * @return Ice mask
+     */
+    const Mask& GetIceMask() const
+    {
+        return m_iceMask;
+    }
+
+    /**
+     * @brief Gets the mask of the switch cells
+     * @return Switch mask
+     */
+    const Mask& GetSwitchMask() const
+    {
+        return m_switchMask;
+    }
+
+    /**
+     * @brief Gets the mask of the door cells
+     * @return Door mask
+     */
+    const Mask& GetDoorMask() const
+    {
+        return m_doorMask;
+    }
+
+    /**
+     * @brief Gets the mask of the visited cells
+     * @return Visited mask
+     */
+    const Mask& GetVisitedMask() const
+    {
+        return m_visitedMask;
+    }
+
+    /**
+     * @brief Gets the mask of the cells unlocked by pressed switches
+     * @return Unlocked mask
+     */
+    const Mask& GetUnlockedMask() const
+    {
+        return m_unlockedMask;
+    }
+
+    /**
+     * @brief Gets the mask of the doors that are still locked
+     * @return Locked door mask
+     */
+    Mask GetLockedDoorMask() const
+    {
+        return m_doorMask & ~m_unlockedMask;
+    }
+
+    /**
+     * @brief Gets the mask of the doors linked to any of the specified switches
+     * @param[in] switchMask Mask of switch cells
+     * @return Mask of the doors the switches unlock
+     */
+    Mask GetLinkedDoorMask(const Mask& switchMask) const
+    {
+        Mask doorMask;
+        for (int32_t i = 0; i < m_numSwitchLinks; ++i)
+        {
+            if (switchMask.Test(m_switchLinks[i].switchIndex))
+            {
+                doorMask.Set(m_switchLinks[i].doorIndex);
+            }
+        }
+
+        return doorMask;
+    }
+
+    /**
+     * @brief Gets the mask of the cells the player can currently step on
+     * @return Traversible mask
+     */
+    Mask GetTraversibleMask() const
+    {
+        return m_roomMask & ~(m_wallMask | m_visitedMask | GetLockedDoorMask());
+    }
+
+    /**
+     * @brief Queries whether the goal is unlocked or not
+     * @return Returns true if the goal is unlocked
+     */
+    bool IsGoalUnlocked() const
+    {
+        return m_isGoalUnlocked;
+    }
+
+    /**
+     * @brief Checks whether every floor cell has been visited
+     * @return Returns true if the room is complete
+     */
+    bool IsComplete() const
+    {
+        return (m_floorMask & m_visitedMask) == m_floorMask;
+    }
+
+    /**
+     * @brief Counts the number of floor cells that have not been visited yet
+     * @return Number of unvisited floor cells
+     */
+    int32_t CountUnvisitedFloors() const
+    {
+        return (m_floorMask & ~m_visitedMask).Count();
+    }
+
+    /**
+     * @brief Queries whether the specified cell can be stepped on by the player or not
+     * @param[in] cellIndex Cell index
+     * @return Returns true if the cell is traversible. Returns false otherwise
+     */
+    bool IsTraversible(const int32_t& cellIndex) const
+    {
+        if (m_wallMask.Test(cellIndex) || m_visitedMask.Test(cellIndex))
+        {
+            return false;
+        }
+
+        return !m_doorMask.Test(cellIndex) || m_unlockedMask.Test(cellIndex);
+    }
+
+    /**
+     * @brief Counts the number of non-ice cells that can be stepped on from the specified cell
+     * @param[in] cellIndex Cell index
+     * @return Number of possible steps. Ice cells are not counted since they can be
+     * crossed any number of times.
+     */
+    int32_t CountOnwardSteps(const int32_t& cellIndex) const
+    {
+        int32_t numSteps = 0;
+        for (Direction direction : ALL_DIRECTIONS)
+        {
+            if (HasNeighbor(cellIndex, direction))
+            {
+                int32_t neighborIndex = GetNeighborIndex(cellIndex, direction);
+                if (IsTraversible(neighborIndex) && !m_iceMask.Test(neighborIndex))
+                {
+                    ++numSteps;
+                }
+            }
+        }
+
+        return numSteps;
+    }
+
+    /**
+     * @brief Computes the Zobrist hash of the visited cells and unlocked doors from
+     * scratch. GetMoveHashKey() keeps it up to date as moves are made and undone
+     * @return State hash
+     */
+    uint64_t ComputeStateHash() const
+    {
+        uint64_t hash = 0;
+        for (int32_t i = 0; i < GetNumCells(); ++i)
+        {
+            if (m_visitedMask.Test(i))
+            {
+                hash ^= ZobristKeys::GetVisitedKey(i);
+            }
+            if (m_unlockedMask.Test(i))
+            {
+                hash ^= ZobristKeys::GetUnlockedKey(i);
+            }
+        }
+
+        return hash;
+    }
+
+    /**
+     * @brief Queries whether the specified cell has a neighbor in the specified direction
+     * @param[in] cellIndex Cell index
+     * @param[in] direction Direction
+     * @return Returns true if the neighbor is inside the room
+     */
+    bool HasNeighbor(const int32_t& cellIndex, const Direction& direction) const
+    {
+        return m_hasNeighborMasks[static_cast<size_t>(direction)].Test(cellIndex);
+    }
+
+    /**
+     * @brief Gets the cell index of the neighbor in the specified direction
+     * @param[in] cellIndex Cell index
+     * @param[in] direction Direction
+     * @return Cell index of the neighbor. Only valid if HasNeighbor() returns true
+     */
+    int32_t GetNeighborIndex(const int32_t& cellIndex, const Direction& direction) const
+    {
+        return cellIndex + GetDirectionY(direction) * m_width + GetDirectionX(direction);
+    }
+
+    /**
+     * @brief Moves every cell in the mask by one step in the specified direction,
+     * dropping the cells that would leave the room
+     * @param[in] mask Mask of cells
+     * @param[in] direction Direction
+     * @return Mask of the neighbors in the specified direction
+     */
+    Mask Shift(const Mask& mask, const Direction& direction) const
+    {
+        Mask movableMask = mask & m_hasNeighborMasks[static_cast<size_t>(direction)];
+        switch (direction)
+        {
+            case Direction::Up:
+                return movableMask >> m_width;
+            case Direction::Down:
+                return movableMask << m_width;
+            case Direction::Left:
+                return movableMask >> 1;
+            case Direction::Right:
+            default:
+                return movableMask << 1;
+        }
+    }
+
+    /**
+     * @brief Gets the mask of all the cells adjacent to any cell in the mask
+     * @param[in] mask Mask of cells
+     * @return Mask of the neighbors in all four directions
+     */
+    Mask GetNeighborMask(const Mask& mask) const
+    {
+        return Shift(mask, Direction::Up)
+            | Shift(mask, Direction::Down)
+            | Shift(mask, Direction::Left)
+            | Shift(mask, Direction::Right);
+    }
+
+    /**
+     * @brief Makes a move in the specified direction, including the whole slide
+     * if the move enters an ice cell
+     * @param[in,out] cellIndex Cell index of the player's position
+     * @param[in] direction Direction of the move
+     * @param[out] record Record of the changes made, used to undo the move
+     * @return Returns true if the player moved. Returns false otherwise
+     */
+    bool ApplyMove(int32_t& cellIndex, const Direction& direction, RoomMoveRecord& record)
+    {
+        record.visitedCellIndex = -1;
+        record.unlockedCellIndex = -1;
+        record.wasCellUnlocked = false;
+        record.wasGoalUnlocked = m_isGoalUnlocked;
+        record.hasReachedGoal = false;
+
+        bool hasMoved = false;
+        // Keep moving while sliding on ice, mirroring the slide table RoomSimulator uses
+        while (HasNeighbor(cellIndex, direction)
+            && IsTraversible(GetNeighborIndex(cellIndex, direction)))
+        {
+            cellIndex = GetNeighborIndex(cellIndex, direction);
+            hasMoved = true;
+
+            if (m_iceMask.Test(cellIndex))
+            {
+                // The goal unlocks after every step, so a room already complete
+                // unlocks it before the slide can end on it
+                if (IsComplete())
+                {
+                    m_isGoalUnlocked = true;
+                }
+                continue;
+            }
+
+            m_visitedMask.Set(cellIndex);
+            record.visitedCellIndex = cellIndex;
+
+            if (m_switchMask.Test(cellIndex))
+            {
+                PressSwitch(cellIndex, record);
+            }
+            else if (cellIndex == m_goalIndex)
+            {
+                record.hasReachedGoal = m_isGoalUnlocked;
+            }
+
+            break;
+        }
+
+        if (hasMoved && IsComplete())
+        {
+            m_isGoalUnlocked = true;
+        }
+
+        return hasMoved;
+    }
+
+    /**
+     * @brief Checks whether a move changed the room state, rather than only the
+     * player's position. A move that stops on ice only changes the room state when
+     * it unlocks the goal, which happens on the first move of an already complete room
+     * @param[in] record Record of the changes made by the move, not undone yet
+     * @return Returns true if the move visited a cell or unlocked the goal
+     */
+    bool HasChangedRoomState(const RoomMoveRecord& record) const
+    {
+        return (record.visitedCellIndex != -1) || (m_isGoalUnlocked != record.wasGoalUnlocked);
+    }
+
+    /**
+     * @brief Reverts the changes made by a move
+     * @param[in] record Record of the changes made by the move
+     */
+    void UndoMove(const RoomMoveRecord& record)
+    {
+        if ((record.unlockedCellIndex != -1) && !record.wasCellUnlocked)
+        {
+            m_unlockedMask.Reset(record.unlockedCellIndex);
+        }
+        if (record.visitedCellIndex != -1)
+        {
+            m_visitedMask.Reset(record.visitedCellIndex);
+        }
+        m_isGoalUnlocked = record.wasGoalUnlocked;
+    }
+
+private:
+    /**
+     * @brief Unlocks the door linked to the specified switch
+     * @param[in] switchIndex Cell index of the switch
+     * @param[out] record Record of the changes made
+     */
+    void PressSwitch(const int32_t& switchIndex, RoomMoveRecord& record)
+    {
+        for (int32_t i = 0; i < m_numSwitchLinks; ++i)
+        {
+            if (m_switchLinks[i].switchIndex == switchIndex)
+            {
+                int32_t doorIndex = m_switchLinks[i].doorIndex;
+                record.unlockedCellIndex = doorIndex;
+                record.wasCellUnlocked = m_unlockedMask.Test(doorIndex);
+                m_unlockedMask.Set(doorIndex);
+                return;
+            }
+        }
+    }
+};
+
+/**
+ * @brief Calls the specified function with the smallest number of bitboard words
+ * that can hold a room of the specified size
+ * @param[in] width Room width
+ * @param[in] height Room height
+ * @param[in] func Function template taking the number of words as a std::integral_constant
+ * @return Result of the function. Returns a value-initialized result (false or 0)
+ * if the room is too large for any bitboard
+ */
+template <typename Func>
+auto DispatchToBitboard(const int32_t& width, const int32_t& height, Func&& func)
+{
+    using Result = decltype(func(std::integral_constant<size_t, 1>()));
+    if (RoomBitboard<1>::CanFit(width, height))
+    {
+        return func(std::integral_constant<size_t, 1>());
+    }
+    if (RoomBitboard<2>::CanFit(width, height))
+    {
+        return func(std::integral_constant<size_t, 2>());
+    }
+    if (RoomBitboard<4>::CanFit(width, height))
+    {
+        return func(std::integral_constant<size_t, 4>());
+    }
+    if (RoomBitboard<16>::CanFit(width, height))
+    {
+        return func(std::integral_constant<size_t, 16>());
+    }
+
+    return Result();
+}
@@ -0,0 +1,354 @@
+#include "RoomGenerator.hpp"
+
+#include "RoomSimulator.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+/**
+ * @brief Constructor
+ */
+RoomGenerator::RoomGenerator()
+    : m_random()
+    , m_cells()
+    , m_path()
+    , m_pathPositions()
+    , m_solutionCells()
+{
+}
+
+/**
+ * @brief Destructor
+ */
+RoomGenerator::~RoomGenerator()
+{
+}
+
+/**
+ * @brief Seeds the random number generator
+ * @param[in] seed Random seed
+ */
+void RoomGenerator::SetSeed(const uint64_t& seed)
+{
+    m_random.seed(seed);
+}
+
+/**
+ * @brief Generates a room
+ * @param[in] settings Generator settings
+ * @param[out] roomData Generated room, reset and analyzed as if loaded from a level file
+ * @param[out] solution Sequence of moves that solves the room
+ * @return Returns true if the operation was successful. Returns false if the
+ * settings leave no room for a path
+ */
+bool RoomGenerator::Generate(const RoomGeneratorSettings& settings, RoomData& roomData, std::vector<Direction>& solution)
+{
+    int32_t innerWidth = settings.width - 2;
+    int32_t innerHeight = settings.height - 2;
+    int32_t numInnerCells = innerWidth * innerHeight;
+    if ((innerWidth < 1) || (innerHeight < 1) || (numInnerCells < 3))
+    {
+        return false;
+    }
+
+    GrowPath(innerWidth, innerHeight);
+
+    // The solution needs at least one floor between the start and the goal
+    int32_t pathLength = static_cast<int32_t>(std::lround(settings.pathCoverage * numInnerCells));
+    pathLength = std::clamp(pathLength, 3, numInnerCells);
+    int32_t pathOffset = GetRandomInt(0, numInnerCells - pathLength);
+    bool isReversed = (GetRandomInt(0, 1) == 1);
+
+    CellData wallCell;
+    wallCell.SetType(CellData::Type::Wall);
+    m_cells.Resize(settings.width, settings.height);
+    m_cells.ForEach([&wallCell](const int32_t&, const int32_t&, CellData& cellData)
+    {
+        cellData = wallCell;
+    });
+
+    m_solutionCells.clear();
+    for (int32_t i = 0; i < pathLength; ++i)
+    {
+        int32_t innerIndex = m_path[pathOffset + (isReversed ? (pathLength - 1 - i) : i)];
+        int32_t x = innerIndex % innerWidth + 1;
+        int32_t y = innerIndex / innerWidth + 1;
+        m_solutionCells.push_back({ x, y });
+        m_cells.Get(x, y)->SetType(CellData::Type::Floor);
+    }
+    m_cells.Get(m_solutionCells.back().first, m_solutionCells.back().second)->SetType(CellData::Type::Goal);
+
+    std::vector<std::pair<size_t, size_t>> switchDoorPairs;
+    AddIce(settings.iceProbability);
+    AddDistractorIce(settings.distractorIceProbability);
+    AddSwitchDoorPairs(settings.numSwitchDoorPairs, switchDoorPairs);
+
+    // Fill in the room data the same way the level loader does
+    wallCell.SetType(CellData::Type::Wall);
+    roomData.cells.Resize(settings.width, settings.height, wallCell);
+    m_cells.ForEach([&roomData](const int32_t& x, const int32_t& y, const CellData& cellData)
+    {
+        roomData.cells.Set(x, y, cellData);
+    });
+
+    roomData.switchIndices.Resize(settings.width, settings.height);
+    roomData.switchIndices.ForEach([](const int32_t&, const int32_t&, int8_t& switchIndex)
+    {
+        switchIndex = -1;
+    });
+    for (SwitchDoorMapping &mapping : roomData.switchDoorMappings)
+    {
+        mapping = { -1, -1, -1, -1, -1 };
+    }
+    for (size_t i = 0; i < switchDoorPairs.size(); ++i)
+    {
+        const std::pair<int32_t, int32_t> &switchCell = m_solutionCells[switchDoorPairs[i].first];
+        const std::pair<int32_t, int32_t> &doorCell = m_solutionCells[switchDoorPairs[i].second];
+        int32_t switchId = 'a' + static_cast<int32_t>(i);
+        roomData.switchDoorMappings[i] = { switchId, switchCell.first, switchCell.second, doorCell.first, doorCell.second };
+        roomData.switchIndices.Set(switchCell.first, switchCell.second, static_cast<int8_t>(i));
+        roomData.switchIndices.Set(doorCell.first, doorCell.second, static_cast<int8_t>(i));
+    }
+
+    roomData.playerStartX = m_solutionCells.front().first;
+    roomData.playerStartY = m_solutionCells.front().second;
+    roomData.goalX = m_solutionCells.back().first;
+    roomData.goalY = m_solutionCells.back().second;
+    roomData.ResetCells();
+    roomData.Analyze();
+
+    // A move onto ice slides over the rest of the stretch, so only the moves made
+    // from cells other than ice are part of the solution
+    solution.clear();
+    for (size_t i = 0; i + 1 < m_solutionCells.size(); ++i)
+    {
+        if (m_cells.Get(m_solutionCells[i].first, m_solutionCells[i].second)->GetType() == CellData::Type::Ice)
+        {
+            continue;
+        }
+
+        int32_t moveX = m_solutionCells[i + 1].first - m_solutionCells[i].first;
+        int32_t moveY = m_solutionCells[i + 1].second - m_solutionCells[i].second;
+        for (Direction direction : ALL_DIRECTIONS)
+        {
+            if ((GetDirectionX(direction) == moveX) && (GetDirectionY(direction) == moveY))
+            {
+                solution.push_back(direction);
+            }
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Checks that a sequence of moves solves a room, by replaying it on the
+ * room simulator the game scene moves the player with
+ * @param[in,out] roomData Room data. Its cells are reset afterwards
+ * @param[in] solution Sequence of moves
+ * @return Returns true if every move is possible and the last one enters the unlocked goal
+ */
+bool RoomGenerator::Verify(RoomData& roomData, const std::vector<Direction>& solution)
+{
+    RoomSimulator simulator;
+    simulator.Reset(&roomData);
+    bool isSolved = false;
+    for (size_t i = 0; i < solution.size(); ++i)
+    {
+        if (!simulator.ApplyMove(solution[i]))
+        {
+            break;
+        }
+        if (simulator.HasReachedGoal())
+        {
+            isSolved = (i + 1 == solution.size());
+            break;
+        }
+    }
+    roomData.ResetCells();
+
+    return isSolved;
+}
+
+/**
+ * @brief Grows a path visiting every cell of the inner area
+ * @param[in] innerWidth Width of the inner area
+ * @param[in] innerHeight Height of the inner area
+ */
+void RoomGenerator::GrowPath(const int32_t& innerWidth, const int32_t& innerHeight)
+{
+    // Start from a path snaking back and forth along the rows
+    int32_t numCells = innerWidth * innerHeight;
+    m_path.resize(numCells);
+    m_pathPositions.resize(numCells);
+    for (int32_t y = 0; y < innerHeight; ++y)
+    {
+        for (int32_t x = 0; x < innerWidth; ++x)
+        {
+            int32_t position = y * innerWidth + (((y % 2) == 0) ? x : (innerWidth - 1 - x));
+            m_path[position] = y * innerWidth + x;
+            m_pathPositions[y * innerWidth + x] = position;
+        }
+    }
+
+    // Backbite moves: link an end of the path to one of its grid neighbors, and
+    // break the path right before (or after) that neighbor so it stays a path
+    int32_t numMoves = 10 * numCells;
+    for (int32_t i = 0; i < numMoves; ++i)
+    {
+        bool isFrontEnd = (GetRandomInt(0, 1) == 0);
+        int32_t endCell = isFrontEnd ? m_path.front() : m_path.back();
+        Direction direction = ALL_DIRECTIONS[GetRandomInt(0, 3)];
+        int32_t neighborX = endCell % innerWidth + GetDirectionX(direction);
+        int32_t neighborY = endCell / innerWidth + GetDirectionY(direction);
+        if ((neighborX < 0) || (neighborX >= innerWidth) || (neighborY < 0) || (neighborY >= innerHeight))
+        {
+            continue;
+        }
+
+        int32_t neighborPosition = m_pathPositions[neighborY * innerWidth + neighborX];
+        int32_t firstPosition = isFrontEnd ? 0 : (neighborPosition + 1);
+        int32_t lastPosition = isFrontEnd ? (neighborPosition - 1) : (numCells - 1);
+        if (firstPosition >= lastPosition)
+        {
+            continue;
+        }
+
+        std::reverse(m_path.begin() + firstPosition, m_path.begin() + lastPosition + 1);
+        for (int32_t position = firstPosition; position <= lastPosition; ++position)
+        {
+            m_pathPositions[m_path[position]] = position;
+        }
+    }
+}
+
+/**
+ * @brief Turns random parts of the straight stretches of the solution path into ice
+ * @param[in] probability Probability of turning part of each straight stretch into ice
+ */
+void RoomGenerator::AddIce(const double& probability)
+{
+    // A cell in the middle of a straight stretch can become ice: moving onto it
+    // slides on in the same direction until the next floor of the stretch
+    auto isStraight = [this](const size_t& i)
+    {
+        return (m_solutionCells[i].first - m_solutionCells[i - 1].first == m_solutionCells[i + 1].first - m_solutionCells[i].first)
+            && (m_solutionCells[i].second - m_solutionCells[i - 1].second == m_solutionCells[i + 1].second - m_solutionCells[i].second);
+    };
+
+    size_t i = 1;
+    while (i + 1 < m_solutionCells.size())
+    {
+        if (!isStraight(i))
+        {
+            ++i;
+            continue;
+        }
+
+        size_t stretchEnd = i;
+        while ((stretchEnd + 2 < m_solutionCells.size()) && isStraight(stretchEnd + 1))
+        {
+            ++stretchEnd;
+        }
+
+        if (GetRandomReal() < probability)
+        {
+            int32_t first = GetRandomInt(static_cast<int32_t>(i), static_cast<int32_t>(stretchEnd));
+            int32_t last = GetRandomInt(first, static_cast<int32_t>(stretchEnd));
+            for (int32_t j = first; j <= last; ++j)
+            {
+                m_cells.Get(m_solutionCells[j].first, m_solutionCells[j].second)->SetType(CellData::Type::Ice);
+            }
+        }
+        i = stretchEnd + 1;
+    }
+}
+
+/**
+ * @brief Turns random walls next to the solution path into ice
+ * @param[in] probability Probability of turning each wall into ice
+ */
+void RoomGenerator::AddDistractorIce(const double& probability)
+{
+    // Slides on the solution path always end on a floor of the path, so extra ice
+    // off the path never changes where the solution's moves lead
+    for (int32_t y = 1; y < m_cells.GetHeight() - 1; ++y)
+    {
+        for (int32_t x = 1; x < m_cells.GetWidth() - 1; ++x)
+        {
+            if (m_cells.Get(x, y)->GetType() != CellData::Type::Wall)
+            {
+                continue;
+            }
+
+            bool isNextToPath = false;
+            for (Direction direction : ALL_DIRECTIONS)
+            {
+                CellData::Type neighborType = m_cells.Get(x + GetDirectionX(direction), y + GetDirectionY(direction))->GetType();
+                isNextToPath = isNextToPath || ((neighborType != CellData::Type::Wall) && (neighborType != CellData::Type::Ice));
+            }
+            if (isNextToPath && (GetRandomReal() < probability))
+            {
+                m_cells.Get(x, y)->SetType(CellData::Type::Ice);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Places switch and door pairs on the solution path, each switch before its door
+ * @param[in] numPairs Number of pairs to place
+ * @param[out] switchDoorPairs Solution path positions of the switch and door of each pair
+ */
+void RoomGenerator::AddSwitchDoorPairs(const int32_t& numPairs, std::vector<std::pair<size_t, size_t>>& switchDoorPairs)
+{
+    switchDoorPairs.clear();
+
+    // Switches and doors replace floors between the start and the goal
+    std::vector<size_t> candidates;
+    for (size_t i = 1; i + 1 < m_solutionCells.size(); ++i)
+    {
+        if (m_cells.Get(m_solutionCells[i].first, m_solutionCells[i].second)->GetType() == CellData::Type::Floor)
+        {
+            candidates.push_back(i);
+        }
+    }
+
+    size_t numPlacedPairs = std::min({ static_cast<size_t>(std::max(numPairs, 0)), candidates.size() / 2, static_cast<size_t>(RoomData::MAX_SWITCHES) });
+    for (size_t i = 0; i < 2 * numPlacedPairs; ++i)
+    {
+        size_t j = static_cast<size_t>(GetRandomInt(static_cast<int32_t>(i), static_cast<int32_t>(candidates.size()) - 1));
+        std::swap(candidates[i], candidates[j]);
+    }
+
+    for (size_t i = 0; i < numPlacedPairs; ++i)
+    {
+        size_t switchPosition = std::min(candidates[2 * i], candidates[2 * i + 1]);
+        size_t doorPosition = std::max(candidates[2 * i], candidates[2 * i + 1]);
+        m_cells.Get(m_solutionCells[switchPosition].first, m_solutionCells[switchPosition].second)->SetType(CellData::Type::Switch);
+        m_cells.Get(m_solutionCells[doorPosition].first, m_solutionCells[doorPosition].second)->SetType(CellData::Type::Door);
+        switchDoorPairs.push_back({ switchPosition, doorPosition });
+    }
+}
+
+/**
+ * @brief Gets a random integer in the specified range
+ * @param[in] minValue Minimum value
+ * @param[in] maxValue Maximum value, inclusive
+ * @return Random integer
+ */
+int32_t RoomGenerator::GetRandomInt(const int32_t& minValue, const int32_t& maxValue)
+{
+    std::uniform_int_distribution<int32_t> distribution(minValue, maxValue);
+    return distribution(m_random);
+}
+
+/**
+ * @brief Gets a random real number between 0 and 1
+ * @return Random real number
+ */
+double RoomGenerator::GetRandomReal()
+{
+    std::uniform_real_distribution<double> distribution(0.0, 1.0);
+    return distribution(m_random);
+}
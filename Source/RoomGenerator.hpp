@@ -0,0 +1,169 @@
+#pragma once
+
+#include "Direction.hpp"
+#include "Grid.hpp"
+#include "LevelData.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <utility>
+#include <vector>
+
+/**
+ * Settings controlling the size and difficulty of generated rooms
+ */
+struct RoomGeneratorSettings
+{
+    /**
+     * Room width, including the wall border
+     */
+    int32_t width = 10;
+
+    /**
+     * Room height, including the wall border
+     */
+    int32_t height = 10;
+
+    /**
+     * Fraction of the cells inside the wall border that the solution path covers.
+     * The other cells become walls, so a low coverage gives narrow corridors with
+     * few wrong turns, while a high coverage gives open areas.
+     */
+    double pathCoverage = 0.7;
+
+    /**
+     * Probability of turning part of each straight stretch of the path into ice
+     */
+    double iceProbability = 0.0;
+
+    /**
+     * Probability of turning each wall next to the path into ice, which opens up
+     * slides that are not part of the solution
+     */
+    double distractorIceProbability = 0.0;
+
+    /**
+     * Number of switch and door pairs placed along the path
+     */
+    int32_t numSwitchDoorPairs = 0;
+};
+
+/**
+ * Generates solvable rooms by first growing a path that visits every cell inside
+ * the wall border, keeping a random stretch of it as the solution, and then
+ * decorating the room around the solution without breaking it. The rest of the
+ * cells become walls, straight stretches of the path may become ice slides, and
+ * switches are placed on the path before their doors.
+ *
+ * The path is grown with random backbite moves (reversing the part of the path
+ * between an end and one of its grid neighbors), which keeps it visiting every
+ * cell while shuffling its shape.
+ */
+class RoomGenerator
+{
+private:
+    /**
+     * Random number generator
+     */
+    std::mt19937_64 m_random;
+
+    /**
+     * Cells of the room being generated
+     */
+    Grid<CellData> m_cells;
+
+    /**
+     * Cells of the path visiting every cell inside the wall border, as indices into
+     * the inner area
+     */
+    std::vector<int32_t> m_path;
+
+    /**
+     * Position of each cell of the inner area in the path
+     */
+    std::vector<int32_t> m_pathPositions;
+
+    /**
+     * Cells of the solution path, as (x, y) positions in the room
+     */
+    std::vector<std::pair<int32_t, int32_t>> m_solutionCells;
+
+public:
+    /**
+     * @brief Constructor
+     */
+    RoomGenerator();
+
+    /**
+     * @brief Destructor
+     */
+    ~RoomGenerator();
+
+    /**
+     * @brief Seeds the random number generator
+     * @param[in] seed Random seed
+     */
+    void SetSeed(const uint64_t& seed);
+
+    /**
+     * @brief Generates a room
+     * @param[in] settings Generator settings
+     * @param[out] roomData Generated room, reset and analyzed as if loaded from a level file
+     * @param[out] solution Sequence of moves that solves the room
+     * @return Returns true if the operation was successful. Returns false if the
+     * settings leave no room for a path
+     */
+    bool Generate(const RoomGeneratorSettings& settings, RoomData& roomData, std::vector<Direction>& solution);
+
+    /**
+     * @brief Checks that a sequence of moves solves a room, by replaying it on the
+     * room simulator the game scene moves the player with
+     * @param[in,out] roomData Room data. Its cells are reset afterwards
+     * @param[in] solution Sequence of moves
+     * @return Returns true if every move is possible and the last one enters the unlocked goal
+     */
+    static bool Verify(RoomData& roomData, const std::vector<Direction>& solution);
+
+private:
+
+    /**
+     * @brief Grows a path visiting every cell of the inner area
+     * @param[in] innerWidth Width of the inner area
+     * @param[in] innerHeight Height of the inner area
+     */
+    void GrowPath(const int32_t& innerWidth, const int32_t& innerHeight);
+
+    /**
+     * @brief Turns random parts of the straight stretches of the solution path into ice
+     * @param[in] probability Probability of turning part of each straight stretch into ice
+     */
+    void AddIce(const double& probability);
+
+    /**
+     * @brief Turns random walls next to the solution path into ice
+     * @param[in] probability Probability of turning each wall into ice
+     */
+    void AddDistractorIce(const double& probability);
+
+    /**
+     * @brief Places switch and door pairs on the solution path, each switch before its door
+     * @param[in] numPairs Number of pairs to place
+     * @param[out] switchDoorPairs Solution path positions of the switch and door of each pair
+     */
+    void AddSwitchDoorPairs(const int32_t& numPairs, std::vector<std::pair<size_t, size_t>>& switchDoorPairs);
+
+    /**
+     * @brief Gets a random integer in the specified range
+     * @param[in] minValue Minimum value
+     * @param[in] maxValue Maximum value, inclusive
+     * @return Random integer
+     */
+    int32_t GetRandomInt(const int32_t& minValue, const int32_t& maxValue);
+
+    /**
+     * @brief Gets a random real number between 0 and 1
+     * @return Random real number
+     */
+    double GetRandomReal();
+};
@@ -0,0 +1,397 @@
+#include "RoomSimulator.hpp"
+
+#include "Constants.hpp"
+
+#include <algorithm>
+
+#define MAX_STORED_SLIDE_LENGTH 255
+
+/**
+ * @brief Constructor
+ */
+RoomSimulator::RoomSimulator()
+    : m_roomData(nullptr)
+    , m_playerCellIndex(0)
+    , m_hasValidStart(false)
+    , m_hasReachedGoal(false)
+    , m_journal()
+    , m_undoneMoves()
+    , m_slideLengths()
+{
+}
+
+/**
+ * @brief Destructor
+ */
+RoomSimulator::~RoomSimulator()
+{
+}
+
+/**
+ * @brief Starts playing the specified room from its initial state
+ * @param[in] roomData Room to play. Its cells are reset, and it needs to
+ * outlive the simulator or the next call to Reset()
+ */
+void RoomSimulator::Reset(RoomData *roomData)
+{
+    m_roomData = roomData;
+    m_playerCellIndex = 0;
+    m_hasValidStart = false;
+    m_hasReachedGoal = false;
+    m_journal.clear();
+    m_undoneMoves.clear();
+    if (m_roomData == nullptr)
+    {
+        return;
+    }
+
+    m_roomData->ResetCells();
+    BuildSlideLengths();
+
+    // A start outside the room has no cell to move from, so the player stays on
+    // the first border cell and every move is rejected
+    m_hasValidStart = m_roomData->cells.IsValidLocation(m_roomData->playerStartX, m_roomData->playerStartY);
+    if (m_hasValidStart)
+    {
+        m_playerCellIndex = m_roomData->cells.GetIndex(m_roomData->playerStartX, m_roomData->playerStartY);
+    }
+}
+
+/**
+ * @brief Gets where a move in the specified direction from the player's
+ * position would end, without making the move
+ * @param[in] direction Direction of the move
+ * @return Slide data of the move. Blocked if the room's start is outside the room
+ */
+SlideData RoomSimulator::GetSlide(const Direction& direction) const
+{
+    if (!m_hasValidStart)
+    {
+        return { m_playerCellIndex, 0 };
+    }
+
+    int32_t length = m_slideLengths[m_playerCellIndex * 4 + static_cast<uint8_t>(direction)];
+    if (length == MAX_STORED_SLIDE_LENGTH)
+    {
+        return WalkSlide(m_playerCellIndex, direction);
+    }
+
+    // Moves go in a straight line, so the end cell follows from the length
+    return { m_playerCellIndex + length * m_roomData->cells.GetNeighborOffset(direction), length };
+}
+
+/**
+ * @brief Makes a move in the specified direction, including the whole slide
+ * if the move enters ice. The undone moves can no longer be redone afterwards
+ * @param[in] direction Direction of the move
+ * @return Returns true if the player moved. Returns false otherwise, including
+ * when the player has already reached the goal or the room's start is outside the room
+ */
+bool RoomSimulator::ApplyMove(const Direction& direction)
+{
+    if (!MakeMove(direction))
+    {
+        return false;
+    }
+
+    m_undoneMoves.clear();
+    return true;
+}
+
+/**
+ * @brief Reverts the last move made, restoring only the cells it changed
+ * @return Returns true if a move was undone. Returns false if no move has been made
+ */
+bool RoomSimulator::UndoMove()
+{
+    if (m_journal.empty())
+    {
+        return false;
+    }
+
+    const RoomSimulatorRecord &record = m_journal.back();
+    int32_t x = 0;
+    int32_t y = 0;
+    if (record.unlockedCellIndex != -1)
+    {
+        m_roomData->cells.GetLocation(record.unlockedCellIndex, x, y);
+        m_roomData->LockDoor(x, y);
+        UpdateSlideLengths(record.unlockedCellIndex);
+    }
+    if (record.visitedCellIndex != -1)
+    {
+        CellData &cellData = m_roomData->cells.GetAt(record.visitedCellIndex);
+        if (cellData.GetType() == CellData::Type::Switch)
+        {
+            cellData.SetState(Constants::SWITCH_UNPRESSED_STATE);
+        }
+
+        m_roomData->cells.GetLocation(record.visitedCellIndex, x, y);
+        m_roomData->UnvisitCell(x, y);
+        UpdateSlideLengths(record.visitedCellIndex);
+    }
+
+    CellData *goalCell = m_roomData->cells.Get(m_roomData->goalX, m_roomData->goalY);
+    if (goalCell != nullptr)
+    {
+        goalCell->SetState(record.wasGoalUnlocked ? Constants::GOAL_UNLOCKED_STATE : Constants::GOAL_LOCKED_STATE);
+    }
+
+    m_playerCellIndex = record.previousCellIndex;
+    m_hasReachedGoal = false;
+    m_undoneMoves.push_back(record.direction);
+    m_journal.pop_back();
+    return true;
+}
+
+/**
+ * @brief Makes the last undone move again
+ * @return Returns true if a move was redone. Returns false if there is no undone
+ * move, or a new move has been made since
+ */
+bool RoomSimulator::RedoMove()
+{
+    if (m_undoneMoves.empty() || !MakeMove(m_undoneMoves.back()))
+    {
+        return false;
+    }
+
+    m_undoneMoves.pop_back();
+    return true;
+}
+
+/**
+ * @brief Makes a move in the specified direction and records it in the journal,
+ * without touching the undone moves
+ * @param[in] direction Direction of the move
+ * @return Returns true if the player moved. Returns false otherwise
+ */
+bool RoomSimulator::MakeMove(const Direction& direction)
+{
+    if ((m_roomData == nullptr) || !m_hasValidStart || m_hasReachedGoal)
+    {
+        return false;
+    }
+
+    SlideData slide = GetSlide(direction);
+    if (slide.length == 0)
+    {
+        return false;
+    }
+
+    RoomSimulatorRecord record = { direction, m_playerCellIndex, -1, -1, m_roomData->IsGoalUnlocked() };
+    m_playerCellIndex = slide.endCellIndex;
+
+    // The goal unlocks after every step once each floor is visited, so a room
+    // already complete unlocks it on the first step of a slide over ice. The
+    // journal keeps the previous state, so undoing the move locks it again
+    CellData *goalCell = m_roomData->cells.Get(m_roomData->goalX, m_roomData->goalY);
+    if ((goalCell != nullptr) && (slide.length > 1) && m_roomData->IsComplete())
+    {
+        goalCell->SetState(Constants::GOAL_UNLOCKED_STATE);
+    }
+
+    int32_t x = 0;
+    int32_t y = 0;
+    m_roomData->cells.GetLocation(m_playerCellIndex, x, y);
+    CellData &cellData = m_roomData->cells.GetAt(m_playerCellIndex);
+    if (cellData.GetType() != CellData::Type::Ice)
+    {
+        m_roomData->VisitCell(x, y);
+        UpdateSlideLengths(m_playerCellIndex);
+        record.visitedCellIndex = m_playerCellIndex;
+    }
+
+    if (cellData.GetType() == CellData::Type::Switch)
+    {
+        int32_t switchId = m_roomData->GetSwitchIdFromSwitchPosition(x, y);
+        if (switchId != -1)
+        {
+            cellData.SetState(Constants::SWITCH_PRESSED_STATE);
+
+            SwitchDoorMapping *mapping = m_roomData->GetSwitchDoorMapping(switchId);
+            CellData *doorCell = m_roomData->cells.Get(mapping->doorX, mapping->doorY);
+            if ((doorCell != nullptr) && (doorCell->GetState() == Constants::DOOR_LOCKED_STATE))
+            {
+                m_roomData->UnlockDoor(mapping->doorX, mapping->doorY);
+                record.unlockedCellIndex = m_roomData->cells.GetIndex(mapping->doorX, mapping->doorY);
+                UpdateSlideLengths(record.unlockedCellIndex);
+            }
+        }
+    }
+    else if (cellData.GetType() == CellData::Type::Goal)
+    {
+        m_hasReachedGoal = m_roomData->IsGoalUnlocked();
+    }
+
+    if ((goalCell != nullptr) && m_roomData->IsComplete())
+    {
+        goalCell->SetState(Constants::GOAL_UNLOCKED_STATE);
+    }
+
+    m_journal.push_back(record);
+    return true;
+}
+
+/**
+ * @brief Gets the room being played
+ * @return Pointer to the room data. nullptr if Reset() has not been called
+ */
+RoomData* RoomSimulator::GetRoomData() const
+{
+    return m_roomData;
+}
+
+/**
+ * @brief Gets the player's X-position
+ * @return Player's X-position
+ */
+int32_t RoomSimulator::GetPlayerX() const
+{
+    int32_t x = 0;
+    int32_t y = 0;
+    m_roomData->cells.GetLocation(m_playerCellIndex, x, y);
+    return x;
+}
+
+/**
+ * @brief Gets the player's Y-position
+ * @return Player's Y-position
+ */
+int32_t RoomSimulator::GetPlayerY() const
+{
+    int32_t x = 0;
+    int32_t y = 0;
+    m_roomData->cells.GetLocation(m_playerCellIndex, x, y);
+    return y;
+}
+
+/**
+ * @brief Gets the index of the cell the player is on
+ * @return Index in the room's cells grid
+ */
+int32_t RoomSimulator::GetPlayerCellIndex() const
+{
+    return m_playerCellIndex;
+}
+
+/**
+ * @brief Queries whether the player has entered the unlocked goal
+ * @return Returns true if the room is solved
+ */
+bool RoomSimulator::HasReachedGoal() const
+{
+    return m_hasReachedGoal;
+}
+
+/**
+ * @brief Gets the number of moves made since the room was reset, not counting undone moves
+ * @return Number of moves
+ */
+size_t RoomSimulator::GetNumMoves() const
+{
+    return m_journal.size();
+}
+
+/**
+ * @brief Gets the moves made since the room was reset, not counting undone moves
+ * @param[out] moves Moves, in order
+ */
+void RoomSimulator::GetMoves(std::vector<Direction>& moves) const
+{
+    moves.clear();
+    for (const RoomSimulatorRecord &record : m_journal)
+    {
+        moves.push_back(record.direction);
+    }
+}
+
+/**
+ * @brief Gets the number of undone moves that can be redone
+ * @return Number of undone moves
+ */
+size_t RoomSimulator::GetNumUndoneMoves() const
+{
+    return m_undoneMoves.size();
+}
+
+/**
+ * @brief Walks a move in the specified direction from the specified cell, cell by cell
+ * @param[in] cellIndex Index in the room's cells grid of the cell the move is made from
+ * @param[in] direction Direction of the move
+ * @return Slide data of the move
+ */
+SlideData RoomSimulator::WalkSlide(const int32_t& cellIndex, const Direction& direction) const
+{
+    SlideData slide = { cellIndex, 0 };
+
+    // Moves are never made from walls, including the border, so their moves are left blocked
+    if (m_roomData->cells.GetAt(cellIndex).GetType() == CellData::Type::Wall)
+    {
+        return slide;
+    }
+
+    // Ice is never visited and never locked, so only the cell after the
+    // ice can stop the player short of it
+    int32_t offset = m_roomData->cells.GetNeighborOffset(direction);
+    int32_t nextCellIndex = cellIndex + offset;
+    while (m_roomData->IsTraversible(nextCellIndex))
+    {
+        slide.endCellIndex = nextCellIndex;
+        ++slide.length;
+        if (m_roomData->cells.GetAt(nextCellIndex).GetType() != CellData::Type::Ice)
+        {
+            break;
+        }
+        nextCellIndex += offset;
+    }
+
+    return slide;
+}
+
+/**
+ * @brief Computes the slide length of every move from scratch
+ */
+void RoomSimulator::BuildSlideLengths()
+{
+    m_slideLengths.assign(m_roomData->cells.GetBufferSize() * 4, 0);
+    for (int32_t cellIndex = 0; cellIndex < m_roomData->cells.GetBufferSize(); ++cellIndex)
+    {
+        for (Direction direction : ALL_DIRECTIONS)
+        {
+            int32_t length = WalkSlide(cellIndex, direction).length;
+            m_slideLengths[cellIndex * 4 + static_cast<uint8_t>(direction)] = static_cast<uint8_t>(std::min(length, MAX_STORED_SLIDE_LENGTH));
+        }
+    }
+}
+
+/**
+ * @brief Updates the slide lengths of the moves that reach the specified cell,
+ * after the cell has changed whether it can be entered
+ * @param[in] cellIndex Index in the room's cells grid of the cell that changed
+ */
+void RoomSimulator::UpdateSlideLengths(const int32_t& cellIndex)
+{
+    const BorderedGrid<CellData> &cells = m_roomData->cells;
+    bool isTraversible = m_roomData->IsTraversible(cellIndex);
+    for (Direction direction : ALL_DIRECTIONS)
+    {
+        // The moves that reach the cell are made from the ice leading up to it, and
+        // from the cell before that ice. They all end on the cell if it can be
+        // entered, and on the last ice before it otherwise
+        int32_t offset = cells.GetNeighborOffset(direction);
+        int32_t length = isTraversible ? 1 : 0;
+        int32_t previousCellIndex = cellIndex - offset;
+        while (cells.GetAt(previousCellIndex).GetType() != CellData::Type::Wall)
+        {
+            m_slideLengths[previousCellIndex * 4 + static_cast<uint8_t>(direction)] = static_cast<uint8_t>(std::min(length, MAX_STORED_SLIDE_LENGTH));
+            if (cells.GetAt(previousCellIndex).GetType() != CellData::Type::Ice)
+            {
+                break;
+            }
+
+            ++length;
+            previousCellIndex -= offset;
+        }
+    }
+}
@@ -0,0 +1,239 @@
+#pragma once
+
+#include "Direction.hpp"
+#include "LevelData.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Where a move in one direction from one cell ends, including the whole ice slide
+ * that follows if the move enters ice. The cells moved over are the ones on the
+ * straight line between the starting cell and the end cell
+ */
+struct SlideData
+{
+    /**
+     * Index of the cell the move ends on, in the cells grid. Same as the starting
+     * cell if the move is blocked
+     */
+    int32_t endCellIndex;
+
+    /**
+     * Number of cells moved over, including the end cell. 0 if the move is blocked
+     */
+    int32_t length;
+};
+
+/**
+ * Record of the cells changed by a single move of a room simulator, used to undo the move
+ */
+struct RoomSimulatorRecord
+{
+    /**
+     * Direction of the move
+     */
+    Direction direction;
+
+    /**
+     * Index of the cell the player was on before the move
+     */
+    int32_t previousCellIndex;
+
+    /**
+     * Index of the cell that became visited. -1 if no cell became visited
+     */
+    int32_t visitedCellIndex;
+
+    /**
+     * Index of the door unlocked by a pressed switch. -1 if no door got unlocked
+     */
+    int32_t unlockedCellIndex;
+
+    /**
+     * Flag indicating whether the goal was unlocked before the move
+     */
+    bool wasGoalUnlocked;
+};
+
+/**
+ * Plays a room by the same rules as the game scene, without any input, timers or
+ * rendering, so that rooms can be played back and analyzed without a window.
+ *
+ * The simulator works on the cells of a room data it does not own. Each move is
+ * applied in one step, including the whole ice slide and any switch it presses,
+ * and the cells it changed are recorded in a journal so that it can be undone
+ * without touching the rest of the room. Undone moves can be redone until a new
+ * move is made.
+ *
+ * The simulator keeps a table of how many cells a move in each direction from
+ * each cell moves over, so that a move is found with one lookup. Only the moves
+ * that reach a cell that changed need to be updated after each move or undo.
+ */
+class RoomSimulator
+{
+private:
+    /**
+     * Room being played. Not owned by the simulator
+     */
+    RoomData *m_roomData;
+
+    /**
+     * Index of the cell the player is on, in the room's cells grid
+     */
+    int32_t m_playerCellIndex;
+
+    /**
+     * Flag indicating whether the room's start is inside the room. No move can be
+     * made otherwise
+     */
+    bool m_hasValidStart;
+
+    /**
+     * Flag indicating whether the player has entered the unlocked goal
+     */
+    bool m_hasReachedGoal;
+
+    /**
+     * Records of the moves made since the room was reset, in order
+     */
+    std::vector<RoomSimulatorRecord> m_journal;
+
+    /**
+     * Directions of the undone moves, with the most recently undone move last
+     */
+    std::vector<Direction> m_undoneMoves;
+
+    /**
+     * Number of cells a move in each direction from each cell moves over, indexed
+     * by (cell index * 4 + direction). Slides too long to fit are stored as the
+     * largest value, and are walked cell by cell instead
+     */
+    std::vector<uint8_t> m_slideLengths;
+
+public:
+    /**
+     * @brief Constructor
+     */
+    RoomSimulator();
+
+    /**
+     * @brief Destructor
+     */
+    ~RoomSimulator();
+
+    /**
+     * @brief Starts playing the specified room from its initial state
+     * @param[in] roomData Room to play. Its cells are reset, and it needs to
+     * outlive the simulator or the next call to Reset()
+     */
+    void Reset(RoomData *roomData);
+
+    /**
+     * @brief Gets where a move in the specified direction from the player's
+     * position would end, without making the move
+     * @param[in] direction Direction of the move
+     * @return Slide data of the move. Blocked if the room's start is outside the room
+     */
+    SlideData GetSlide(const Direction& direction) const;
+
+    /**
+     * @brief Makes a move in the specified direction, including the whole slide
+     * if the move enters ice. The undone moves can no longer be redone afterwards
+     * @param[in] direction Direction of the move
+     * @return Returns true if the player moved. Returns false otherwise, including
+     * when the player has already reached the goal or the room's start is outside the room
+     */
+    bool ApplyMove(const Direction& direction);
+
+    /**
+     * @brief Reverts the last move made, restoring only the cells it changed
+     * @return Returns true if a move was undone. Returns false if no move has been made
+     */
+    bool UndoMove();
+
+    /**
+     * @brief Makes the last undone move again
+     * @return Returns true if a move was redone. Returns false if there is no undone
+     * move, or a new move has been made since
+     */
+    bool RedoMove();
+
+    /**
+     * @brief Gets the room being played
+     * @return Pointer to the room data. nullptr if Reset() has not been called
+     */
+    RoomData* GetRoomData() const;
+
+    /**
+     * @brief Gets the player's X-position
+     * @return Player's X-position
+     */
+    int32_t GetPlayerX() const;
+
+    /**
+     * @brief Gets the player's Y-position
+     * @return Player's Y-position
+     */
+    int32_t GetPlayerY() const;
+
+    /**
+     * @brief Gets the index of the cell the player is on
+     * @return Index in the room's cells grid
+     */
+    int32_t GetPlayerCellIndex() const;
+
+    /**
+     * @brief Queries whether the player has entered the unlocked goal
+     * @return Returns true if the room is solved
+     */
+    bool HasReachedGoal() const;
+
+    /**
+     * @brief Gets the number of moves made since the room was reset, not counting undone moves
+     * @return Number of moves
+     */
+    size_t GetNumMoves() const;
+
+    /**
+     * @brief Gets the moves made since the room was reset, not counting undone moves
+     * @param[out] moves Moves, in order
+     */
+    void GetMoves(std::vector<Direction>& moves) const;
+
+    /**
+     * @brief Gets the number of undone moves that can be redone
+     * @return Number of undone moves
+     */
+    size_t GetNumUndoneMoves() const;
+
+private:
+    /**
+     * @brief Makes a move in the specified direction and records it in the journal,
+     * without touching the undone moves
+     * @param[in] direction Direction of the move
+     * @return Returns true if the player moved. Returns false otherwise
+     */
+    bool MakeMove(const Direction& direction);
+
+    /**
+     * @brief Walks a move in the specified direction from the specified cell, cell by cell
+     * @param[in] cellIndex Index in the room's cells grid of the cell the move is made from
+     * @param[in] direction Direction of the move
+     * @return Slide data of the move
+     */
+    SlideData WalkSlide(const int32_t& cellIndex, const Direction& direction) const;
+
+    /**
+     * @brief Computes the slide length of every move from scratch
+     */
+    void BuildSlideLengths();
+
+    /**
+     * @brief Updates the slide lengths of the moves that reach the specified cell,
+     * after the cell has changed whether it can be entered
+     * @param[in] cellIndex Index in the room's cells grid of the cell that changed
+     */
+    void UpdateSlideLengths(const int32_t& cellIndex);
+};
@@ -0,0 +1,487 @@
+#include "RoomSolver.hpp"
+
+#include <algorithm>
+#include <type_traits>
+
+/**
+ * @brief Constructor
+ */
+RoomSolver::RoomSolver()
+    : m_moves()
+    , m_closureEntries()
+    , m_successors()
+    , m_cellMarks()
+    , m_currentMark(0)
+    , m_articulationCheck()
+    , m_numNodesExpanded(0)
+    , m_maxNodes(0)
+    , m_hasHitNodeLimit(false)
+    , m_cancellationFlag(nullptr)
+    , m_wasCancelled(false)
+    , m_transpositionTable()
+    , m_isKeepingTranspositionTable(false)
+    , m_unsearchedSubtrees(nullptr)
+    , m_stateHash(0)
+{
+    m_transpositionTable.SetSize(TranspositionTable::DEFAULT_SIZE);
+}
+
+/**
+ * @brief Destructor
+ */
+RoomSolver::~RoomSolver()
+{
+}
+
+/**
+ * @brief Sets the maximum number of search nodes to expand before giving up
+ * @param[in] maxNodes Maximum number of search nodes. 0 means no limit
+ */
+void RoomSolver::SetMaxNodes(const uint64_t& maxNodes)
+{
+    m_maxNodes = maxNodes;
+}
+
+/**
+ * @brief Sets the flag that stops the search once set. The flag can be set from
+ * another thread while the search is running.
+ * @param[in] cancellationFlag Cancellation flag. nullptr to not use one
+ */
+void RoomSolver::SetCancellationFlag(const std::atomic<bool>* cancellationFlag)
+{
+    m_cancellationFlag = cancellationFlag;
+}
+
+/**
+ * @brief Sets the memory budget of the transposition table, which remembers the
+ * room states proven to be dead ends so the search never explores them twice
+ * @param[in] numBytes Memory budget in bytes. 0 to disable the transposition table
+ */
+void RoomSolver::SetTranspositionTableSize(const size_t& numBytes)
+{
+    m_transpositionTable.SetSize(numBytes);
+}
+
+/**
+ * @brief Sets whether Solve() keeps the room states proven to be dead ends by
+ * earlier calls. Dead ends only carry over between searches of the same room, so
+ * the transposition table needs to be cleared before searching another room.
+ * @param[in] isKeepingTranspositionTable Flag indicating whether to keep the dead ends
+ */
+void RoomSolver::SetKeepingTranspositionTable(const bool& isKeepingTranspositionTable)
+{
+    m_isKeepingTranspositionTable = isKeepingTranspositionTable;
+}
+
+/**
+ * @brief Removes all the room states from the transposition table, and resets its statistics
+ */
+void RoomSolver::ClearTranspositionTable()
+{
+    m_transpositionTable.Clear();
+}
+
+/**
+ * @brief Gets the transposition table, including its statistics for the last call to Solve()
+ * @return Transposition table
+ */
+const TranspositionTable& RoomSolver::GetTranspositionTable() const
+{
+    return m_transpositionTable;
+}
+
+/**
+ * @brief Searches for a sequence of moves that solves the specified room
+ * @param[in] roomData Room data
+ * @param[out] moves Sequence of moves that solves the room
+ * @return Returns true if a solution was found. Returns false otherwise
+ */
+bool RoomSolver::Solve(const RoomData& roomData, std::vector<Direction>& moves)
+{
+    return Solve(roomData, std::vector<Direction>(), moves);
+}
+
+/**
+ * @brief Searches for a sequence of moves that solves the specified room, starting
+ * with the specified moves
+ * @param[in] roomData Room data
+ * @param[in] prefix Moves made before the search starts
+ * @param[out] moves Sequence of moves that solves the room, including the prefix
+ * @return Returns true if a solution was found. Returns false otherwise, including
+ * when the prefix contains an invalid move
+ */
+bool RoomSolver::Solve(const RoomData& roomData, const std::vector<Direction>& prefix, std::vector<Direction>& moves)
+{
+    moves.clear();
+    m_numNodesExpanded = 0;
+    m_hasHitNodeLimit = false;
+    m_wasCancelled = false;
+    if (!m_isKeepingTranspositionTable)
+    {
+        m_transpositionTable.Clear();
+    }
+
+    return DispatchToBitboard(roomData.cells.GetWidth(), roomData.cells.GetHeight(), [&](auto numWords)
+    {
+        return SolveWithBitboard<decltype(numWords)::value>(roomData, prefix, moves);
+    });
+}
+
+/**
+ * @brief Searches for a sequence of moves that solves the specified room, starting
+ * with the specified moves. If the node limit is hit, the parts of the search tree
+ * not searched yet are listed, so that they can be searched separately without
+ * repeating the work already done.
+ * @param[in] roomData Room data
+ * @param[in] prefix Moves made before the search starts
+ * @param[out] moves Sequence of moves that solves the room, including the prefix
+ * @param[out] unsearchedSubtrees Moves leading to the root of each subtree left
+ * unsearched: the node the search stopped at, then the successors not tried yet at
+ * each level of the search path, from the deepest level up and each level in the
+ * order the search would try them. Empty if the node limit was not hit
+ * @return Returns true if a solution was found. Returns false otherwise, including
+ * when the prefix contains an invalid move
+ */
+bool RoomSolver::Solve(
+    const RoomData& roomData,
+    const std::vector<Direction>& prefix,
+    std::vector<Direction>& moves,
+    std::vector<std::vector<Direction>>& unsearchedSubtrees)
+{
+    unsearchedSubtrees.clear();
+    m_unsearchedSubtrees = &unsearchedSubtrees;
+    bool isSolved = Solve(roomData, prefix, moves);
+    m_unsearchedSubtrees = nullptr;
+
+    return isSolved;
+}
+
+/**
+ * @brief Gets the number of search nodes expanded by the last call to Solve()
+ * @return Number of search nodes expanded
+ */
+uint64_t RoomSolver::GetNumNodesExpanded() const
+{
+    return m_numNodesExpanded;
+}
+
+/**
+ * @brief Queries whether the last call to Solve() gave up due to the node limit
+ * @return Returns true if the search gave up before exhausting all possibilities
+ */
+bool RoomSolver::HasHitNodeLimit() const
+{
+    return m_hasHitNodeLimit;
+}
+
+/**
+ * @brief Queries whether the last call to Solve() was stopped by the cancellation flag
+ * @return Returns true if the search was cancelled
+ */
+bool RoomSolver::WasCancelled() const
+{
+    return m_wasCancelled;
+}
+
+/**
+ * @brief Prepares the search state for the specified bitboard, and makes the
+ * specified moves on it
+ * @param[in,out] board Room bitboard, freshly built
+ * @param[in] prefix Moves to make
+ * @param[out] cellIndex Cell index of the player's position after the moves
+ * @param[out] hasReachedGoal Flag indicating whether the moves reach the goal
+ * @return Returns true if all the moves are valid. Returns false otherwise
+ */
+template <size_t NumWords>
+bool RoomSolver::PrepareSearch(
+    RoomBitboard<NumWords>& board,
+    const std::vector<Direction>& prefix,
+    int32_t& cellIndex,
+    bool& hasReachedGoal)
+{
+    int32_t numCells = board.GetNumCells();
+    m_cellMarks.assign(numCells, 0);
+    m_currentMark = 0;
+    m_articulationCheck.Resize(numCells);
+    m_moves = prefix;
+    m_closureEntries.clear();
+    m_successors.clear();
+
+    cellIndex = board.GetStartIndex();
+    hasReachedGoal = false;
+    for (Direction direction : prefix)
+    {
+        RoomMoveRecord record;
+        if (hasReachedGoal || !board.ApplyMove(cellIndex, direction, record))
+        {
+            return false;
+        }
+        hasReachedGoal = record.hasReachedGoal;
+    }
+    m_stateHash = board.ComputeStateHash();
+
+    return true;
+}
+
+/**
+ * @brief Searches for a solution using a bitboard with the specified number of words
+ * @param[in] roomData Room data
+ * @param[in] prefix Moves made before the search starts
+ * @param[out] moves Sequence of moves that solves the room, including the prefix
+ * @return Returns true if a solution was found. Returns false otherwise
+ */
+template <size_t NumWords>
+bool RoomSolver::SolveWithBitboard(const RoomData& roomData, const std::vector<Direction>& prefix, std::vector<Direction>& moves)
+{
+    RoomBitboard<NumWords> board;
+    if (!board.Build(roomData))
+    {
+        return false;
+    }
+
+    int32_t cellIndex;
+    bool hasReachedGoal;
+    if (!PrepareSearch(board, prefix, cellIndex, hasReachedGoal))
+    {
+        return false;
+    }
+
+    if (hasReachedGoal || Search(board, cellIndex))
+    {
+        moves = m_moves;
+        return true;
+    }
+
+    return false;
+}
+
+/**
+ * @brief Checks whether all the unvisited floor cells and the goal can still be
+ * visited from the specified cell, assuming all locked doors can be opened
+ * @param[in] board Room bitboard
+ * @param[in] cellIndex Cell index of the player's position
+ * @return Returns true if the remaining cells might still be visited. Returns false
+ * if the current search branch is a dead end
+ */
+template <size_t NumWords>
+bool RoomSolver::CanVisitRemainingCells(const RoomBitboard<NumWords>& board, const int32_t& cellIndex)
+{
+    int32_t goalIndex = board.GetGoalIndex();
+    if ((goalIndex == -1) || board.GetVisitedMask().Test(goalIndex))
+    {
+        return false;
+    }
+
+    // Cells that can still be walked through, locked doors included
+    typename RoomBitboard<NumWords>::Mask openMask =
+        board.GetRoomMask() & ~(board.GetWallMask() | board.GetVisitedMask());
+    // Cells that must still be visited
+    typename RoomBitboard<NumWords>::Mask requiredMask = board.GetFloorMask() & openMask;
+    requiredMask.Set(goalIndex);
+
+    return m_articulationCheck.CanVisitRequiredCells(board, openMask, requiredMask, cellIndex);
+}
+
+/**
+ * @brief Gathers the moves that change the room state from the specified position,
+ * pushing them to the successor stack in the order they should be tried
+ * @param[in,out] board Room bitboard
+ * @param[in] cellIndex Cell index of the player's position
+ * @return Returns true if one of the moves reaches the goal, in which case the moves
+ * leading to the goal are pushed to the current move list. Returns false otherwise
+ */
+template <size_t NumWords>
+bool RoomSolver::GatherSuccessors(RoomBitboard<NumWords>& board, const int32_t& cellIndex)
+{
+    // Gather all positions reachable by only stopping on ice cells, since those
+    // moves do not change the room state. From each of them, gather the moves
+    // that do change the room state.
+    size_t firstEntryIndex = m_closureEntries.size();
+    size_t firstSuccessorIndex = m_successors.size();
+    uint32_t mark = NextMark();
+    m_closureEntries.push_back({ cellIndex, -1, Direction::Up });
+    // A start that is not a floor stays unmarked, since stepping back onto it changes the room state
+    if (board.GetIceMask().Test(cellIndex))
+    {
+        m_cellMarks[cellIndex] = mark;
+    }
+
+    bool isSolved = false;
+    for (size_t i = firstEntryIndex; (i < m_closureEntries.size()) && !isSolved; ++i)
+    {
+        int32_t entryCellIndex = m_closureEntries[i].cellIndex;
+        for (Direction direction : ALL_DIRECTIONS)
+        {
+            int32_t newCellIndex = entryCellIndex;
+            RoomMoveRecord record;
+            if (!board.ApplyMove(newCellIndex, direction, record))
+            {
+                continue;
+            }
+
+            if (record.hasReachedGoal)
+            {
+                PushPathToEntry(static_cast<int32_t>(i));
+                m_moves.push_back(direction);
+                board.UndoMove(record);
+                isSolved = true;
+                break;
+            }
+
+            if (!board.HasChangedRoomState(record))
+            {
+                if (m_cellMarks[newCellIndex] != mark)
+                {
+                    m_cellMarks[newCellIndex] = mark;
+                    m_closureEntries.push_back({ newCellIndex, static_cast<int32_t>(i), direction });
+                }
+            }
+            else if (m_cellMarks[newCellIndex] != mark)
+            {
+                // Different moves landing on the same cell lead to the same room state
+                m_cellMarks[newCellIndex] = mark;
+                m_successors.push_back({ static_cast<int32_t>(i), direction, board.CountOnwardSteps(newCellIndex) });
+            }
+
+            board.UndoMove(record);
+        }
+    }
+
+    if (isSolved)
+    {
+        return true;
+    }
+
+    // Warnsdorff's rule: try the cells with the fewest ways out first
+    std::stable_sort(
+        m_successors.begin() + firstSuccessorIndex,
+        m_successors.end(),
+        [](const Successor& a, const Successor& b)
+        {
+            return a.numOnwardSteps < b.numOnwardSteps;
+        });
+
+    return false;
+}
+
+/**
+ * @brief Recursively searches for a solution from the specified position
+ * @param[in,out] board Room bitboard
+ * @param[in] cellIndex Cell index of the player's position
+ * @return Returns true if a solution was found. Returns false otherwise
+ */
+template <size_t NumWords>
+bool RoomSolver::Search(RoomBitboard<NumWords>& board, const int32_t& cellIndex)
+{
+    ++m_numNodesExpanded;
+    if ((m_maxNodes != 0) && (m_numNodesExpanded > m_maxNodes))
+    {
+        m_hasHitNodeLimit = true;
+        if (m_unsearchedSubtrees != nullptr)
+        {
+            m_unsearchedSubtrees->push_back(m_moves);
+        }
+        return false;
+    }
+    if ((m_cancellationFlag != nullptr) && m_cancellationFlag->load(std::memory_order_relaxed))
+    {
+        m_wasCancelled = true;
+        return false;
+    }
+
+    // Different move orders often lead to the same room state, which only needs to be searched once
+    uint64_t hash = m_stateHash ^ ZobristKeys::GetPositionKey(cellIndex);
+    if (m_transpositionTable.Contains(hash))
+    {
+        return false;
+    }
+
+    if (!CanVisitRemainingCells(board, cellIndex))
+    {
+        return false;
+    }
+
+    uint64_t firstNodeIndex = m_numNodesExpanded;
+
+    size_t firstEntryIndex = m_closureEntries.size();
+    size_t firstSuccessorIndex = m_successors.size();
+    bool isSolved = GatherSuccessors(board, cellIndex);
+    for (size_t i = firstSuccessorIndex; (i < m_successors.size()) && !isSolved && !m_hasHitNodeLimit && !m_wasCancelled; ++i)
+    {
+        Successor successor = m_successors[i];
+        int32_t newCellIndex = m_closureEntries[successor.entryIndex].cellIndex;
+        RoomMoveRecord record;
+        board.ApplyMove(newCellIndex, successor.direction, record);
+        m_stateHash ^= GetMoveHashKey(record);
+
+        int32_t numPushedMoves = PushPathToEntry(successor.entryIndex);
+        m_moves.push_back(successor.direction);
+
+        isSolved = Search(board, newCellIndex);
+        if (!isSolved)
+        {
+            m_moves.resize(m_moves.size() - numPushedMoves - 1);
+        }
+
+        m_stateHash ^= GetMoveHashKey(record);
+        board.UndoMove(record);
+
+        if (m_hasHitNodeLimit && (m_unsearchedSubtrees != nullptr))
+        {
+            // The successors not tried yet are left to be searched separately
+            for (size_t j = i + 1; j < m_successors.size(); ++j)
+            {
+                int32_t numUnsearchedMoves = PushPathToEntry(m_successors[j].entryIndex);
+                m_moves.push_back(m_successors[j].direction);
+                m_unsearchedSubtrees->push_back(m_moves);
+                m_moves.resize(m_moves.size() - numUnsearchedMoves - 1);
+            }
+        }
+    }
+
+    m_closureEntries.resize(firstEntryIndex);
+    m_successors.resize(firstSuccessorIndex);
+
+    // Only a fully searched room state is known to be a dead end
+    if (!isSolved && !m_hasHitNodeLimit && !m_wasCancelled)
+    {
+        m_transpositionTable.Store(hash, m_numNodesExpanded - firstNodeIndex);
+    }
+
+    return isSolved;
+}
+
+/**
+ * @brief Pushes the moves needed to get to the specified closure entry
+ * @param[in] entryIndex Closure entry index
+ * @return Number of moves pushed
+ */
+int32_t RoomSolver::PushPathToEntry(const int32_t& entryIndex)
+{
+    size_t firstMoveIndex = m_moves.size();
+    int32_t currentEntryIndex = entryIndex;
+    while (m_closureEntries[currentEntryIndex].parentEntryIndex != -1)
+    {
+        m_moves.push_back(m_closureEntries[currentEntryIndex].direction);
+        currentEntryIndex = m_closureEntries[currentEntryIndex].parentEntryIndex;
+    }
+    std::reverse(m_moves.begin() + firstMoveIndex, m_moves.end());
+
+    return static_cast<int32_t>(m_moves.size() - firstMoveIndex);
+}
+
+/**
+ * @brief Gets a fresh mark value, effectively unmarking all cells
+ * @return Mark value
+ */
+uint32_t RoomSolver::NextMark()
+{
+    ++m_currentMark;
+    if (m_currentMark == 0)
+    {
+        std::fill(m_cellMarks.begin(), m_cellMarks.end(), 0);
+        m_currentMark = 1;
+    }
+
+    return m_currentMark;
+}
@@ -0,0 +1,328 @@
+#pragma once
+
+#include "ArticulationCheck.hpp"
+#include "Direction.hpp"
+#include "LevelData.hpp"
+#include "RoomBitboard.hpp"
+#include "TranspositionTable.hpp"
+#include "ZobristKeys.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Headless solver that searches for a sequence of moves that visits every
+ * floor cell of a room exactly once before reaching the goal, following the
+ * same movement rules as the game scene (ice sliding, switches and doors).
+ */
+class RoomSolver
+{
+public:
+    /**
+     * Maximum number of cells in a room the solver can handle
+     */
+    static constexpr int32_t MAX_CELLS = RoomBitboard<16>::MAX_CELLS;
+
+    static_assert(MAX_CELLS <= ZobristKeys::MAX_CELLS, "Every cell must have its own Zobrist keys");
+
+private:
+    /**
+     * Entry in the list of positions reachable without changing the room state
+     * (i.e. by only stopping on ice cells)
+     */
+    struct ClosureEntry
+    {
+        /**
+         * Cell index of the position
+         */
+        int32_t cellIndex;
+
+        /**
+         * Index of the entry this entry was reached from. -1 for the first entry
+         */
+        int32_t parentEntryIndex;
+
+        /**
+         * Direction of the move from the parent entry
+         */
+        Direction direction;
+    };
+
+    /**
+     * Move that changes the room state
+     */
+    struct Successor
+    {
+        /**
+         * Index of the closure entry the move is made from
+         */
+        int32_t entryIndex;
+
+        /**
+         * Direction of the move
+         */
+        Direction direction;
+
+        /**
+         * Number of onward steps from the cell the move ends on
+         */
+        int32_t numOnwardSteps;
+    };
+
+private:
+    /**
+     * Moves made so far in the current search branch
+     */
+    std::vector<Direction> m_moves;
+
+    /**
+     * Stack of closure entries for all the nodes in the current search branch
+     */
+    std::vector<ClosureEntry> m_closureEntries;
+
+    /**
+     * Stack of successors for all the nodes in the current search branch
+     */
+    std::vector<Successor> m_successors;
+
+    /**
+     * Per-cell marks used by traversals and closure computation
+     */
+    std::vector<uint32_t> m_cellMarks;
+
+    /**
+     * Current mark value. Cells marked with a different value are unmarked
+     */
+    uint32_t m_currentMark;
+
+    /**
+     * Articulation point check over the unvisited cells
+     */
+    ArticulationCheck m_articulationCheck;
+
+    /**
+     * Number of search nodes expanded by the last call to Solve()
+     */
+    uint64_t m_numNodesExpanded;
+
+    /**
+     * Maximum number of search nodes to expand before giving up. 0 means no limit
+     */
+    uint64_t m_maxNodes;
+
+    /**
+     * Flag indicating whether the last search gave up due to the node limit
+     */
+    bool m_hasHitNodeLimit;
+
+    /**
+     * Flag that stops the search once set, typically by another thread. nullptr if not used
+     */
+    const std::atomic<bool>* m_cancellationFlag;
+
+    /**
+     * Flag indicating whether the last search was stopped by the cancellation flag
+     */
+    bool m_wasCancelled;
+
+    /**
+     * Room states already proven to be dead ends in the current search
+     */
+    TranspositionTable m_transpositionTable;
+
+    /**
+     * Flag indicating whether Solve() keeps the dead ends found by earlier calls
+     */
+    bool m_isKeepingTranspositionTable;
+
+    /**
+     * Where to list the subtrees left unsearched when the node limit is hit. nullptr if not used
+     */
+    std::vector<std::vector<Direction>>* m_unsearchedSubtrees;
+
+    /**
+     * Zobrist hash of the visited cells and unlocked doors in the current search branch
+     */
+    uint64_t m_stateHash;
+
+public:
+    /**
+     * @brief Constructor
+     */
+    RoomSolver();
+
+    /**
+     * @brief Destructor
+     */
+    ~RoomSolver();
+
+    /**
+     * @brief Sets the maximum number of search nodes to expand before giving up
+     * @param[in] maxNodes Maximum number of search nodes. 0 means no limit
+     */
+    void SetMaxNodes(const uint64_t& maxNodes);
+
+    /**
+     * @brief Sets the flag that stops the search once set. The flag can be set from
+     * another thread while the search is running.
+     * @param[in] cancellationFlag Cancellation flag. nullptr to not use one
+     */
+    void SetCancellationFlag(const std::atomic<bool>* cancellationFlag);
+
+    /**
+     * @brief Sets the memory budget of the transposition table, which remembers the
+     * room states proven to be dead ends so the search never explores them twice
+     * @param[in] numBytes Memory budget in bytes. 0 to disable the transposition table
+     */
+    void SetTranspositionTableSize(const size_t& numBytes);
+
+    /**
+     * @brief Sets whether Solve() keeps the room states proven to be dead ends by
+     * earlier calls. Dead ends only carry over between searches of the same room, so
+     * the transposition table needs to be cleared before searching another room.
+     * @param[in] isKeepingTranspositionTable Flag indicating whether to keep the dead ends
+     */
+    void SetKeepingTranspositionTable(const bool& isKeepingTranspositionTable);
+
+    /**
+     * @brief Removes all the room states from the transposition table, and resets its statistics
+     */
+    void ClearTranspositionTable();
+
+    /**
+     * @brief Gets the transposition table, including its statistics for the last call to Solve()
+     * @return Transposition table
+     */
+    const TranspositionTable& GetTranspositionTable() const;
+
+    /**
+     * @brief Searches for a sequence of moves that solves the specified room
+     * @param[in] roomData Room data
+     * @param[out] moves Sequence of moves that solves the room
+     * @return Returns true if a solution was found. Returns false otherwise
+     */
+    bool Solve(const RoomData& roomData, std::vector<Direction>& moves);
+
+    /**
+     * @brief Searches for a sequence of moves that solves the specified room, starting
+     * with the specified moves
+     * @param[in] roomData Room data
+     * @param[in] prefix Moves made before the search starts
+     * @param[out] moves Sequence of moves that solves the room, including the prefix
+     * @return Returns true if a solution was found. Returns false otherwise, including
+     * when the prefix contains an invalid move
+     */
+    bool Solve(const RoomData& roomData, const std::vector<Direction>& prefix, std::vector<Direction>& moves);
+
+    /**
+     * @brief Searches for a sequence of moves that solves the specified room, starting
+     * with the specified moves. If the node limit is hit, the parts of the search tree
+     * not searched yet are listed, so that they can be searched separately without
+     * repeating the work already done.
+     * @param[in] roomData Room data
+     * @param[in] prefix Moves made before the search starts
+     * @param[out] moves Sequence of moves that solves the room, including the prefix
+     * @param[out] unsearchedSubtrees Moves leading to the root of each subtree left
+     * unsearched: the node the search stopped at, then the successors not tried yet at
+     * each level of the search path, from the deepest level up and each level in the
+     * order the search would try them. Empty if the node limit was not hit
+     * @return Returns true if a solution was found. Returns false otherwise, including
+     * when the prefix contains an invalid move
+     */
+    bool Solve(
+        const RoomData& roomData,
+        const std::vector<Direction>& prefix,
+        std::vector<Direction>& moves,
+        std::vector<std::vector<Direction>>& unsearchedSubtrees);
+
+    /**
+     * @brief Gets the number of search nodes expanded by the last call to Solve()
+     * @return Number of search nodes expanded
+     */
+    uint64_t GetNumNodesExpanded() const;
+
+    /**
+     * @brief Queries whether the last call to Solve() gave up due to the node limit
+     * @return Returns true if the search gave up before exhausting all possibilities
+     */
+    bool HasHitNodeLimit() const;
+
+    /**
+     * @brief Queries whether the last call to Solve() was stopped by the cancellation flag
+     * @return Returns true if the search was cancelled
+     */
+    bool WasCancelled() const;
+
+private:
+    /**
+     * @brief Prepares the search state for the specified bitboard, and makes the
+     * specified moves on it
+     * @param[in,out] board Room bitboard, freshly built
+     * @param[in] prefix Moves to make
+     * @param[out] cellIndex Cell index of the player's position after the moves
+     * @param[out] hasReachedGoal Flag indicating whether the moves reach the goal
+     * @return Returns true if all the moves are valid. Returns false otherwise
+     */
+    template <size_t NumWords>
+    bool PrepareSearch(
+        RoomBitboard<NumWords>& board,
+        const std::vector<Direction>& prefix,
+        int32_t& cellIndex,
+        bool& hasReachedGoal);
+
+    /**
+     * @brief Searches for a solution using a bitboard with the specified number of words
+     * @param[in] roomData Room data
+     * @param[in] prefix Moves made before the search starts
+     * @param[out] moves Sequence of moves that solves the room, including the prefix
+     * @return Returns true if a solution was found. Returns false otherwise
+     */
+    template <size_t NumWords>
+    bool SolveWithBitboard(const RoomData& roomData, const std::vector<Direction>& prefix, std::vector<Direction>& moves);
+
+    /**
+     * @brief Checks whether all the unvisited floor cells and the goal can still be
+     * visited from the specified cell, assuming all locked doors can be opened
+     * @param[in] board Room bitboard
+     * @param[in] cellIndex Cell index of the player's position
+     * @return Returns true if the remaining cells might still be visited. Returns false
+     * if the current search branch is a dead end
+     */
+    template <size_t NumWords>
+    bool CanVisitRemainingCells(const RoomBitboard<NumWords>& board, const int32_t& cellIndex);
+
+    /**
+     * @brief Gathers the moves that change the room state from the specified position,
+     * pushing them to the successor stack in the order they should be tried
+     * @param[in,out] board Room bitboard
+     * @param[in] cellIndex Cell index of the player's position
+     * @return Returns true if one of the moves reaches the goal, in which case the moves
+     * leading to the goal are pushed to the current move list. Returns false otherwise
+     */
+    template <size_t NumWords>
+    bool GatherSuccessors(RoomBitboard<NumWords>& board, const int32_t& cellIndex);
+
+    /**
+     * @brief Recursively searches for a solution from the specified position
+     * @param[in,out] board Room bitboard
+     * @param[in] cellIndex Cell index of the player's position
+     * @return Returns true if a solution was found. Returns false otherwise
+     */
+    template <size_t NumWords>
+    bool Search(RoomBitboard<NumWords>& board, const int32_t& cellIndex);
+
+    /**
+     * @brief Pushes the moves needed to get to the specified closure entry
+     * @param[in] entryIndex Closure entry index
+     * @return Number of moves pushed
+     */
+    int32_t PushPathToEntry(const int32_t& entryIndex);
+
+    /**
+     * @brief Gets a fresh mark value, effectively unmarking all cells
+     * @return Mark value
+     */
+    uint32_t NextMark();
+};
@@ -0,0 +1,296 @@
+#include "RoomSymmetry.hpp"
+
+#include <array>
+
+#define MIRROR_X_FLAG 1
+#define MIRROR_Y_FLAG 2
+#define SWAP_AXES_FLAG 4
+
+/**
+ * @brief Transforms a room. Bit 0 of the transform index mirrors the room
+ * horizontally, bit 1 mirrors it vertically, and bit 2 swaps the X and Y axes.
+ * Switch letters are kept as they are
+ * @param[in] roomData Room data
+ * @param[in] transformIndex Transform index, from 0 to NUM_TRANSFORMS - 1
+ * @param[out] transformedRoomData Transformed room, reset and analyzed as if loaded from a level file
+ */
+void RoomSymmetry::Transform(const RoomData& roomData, const int32_t& transformIndex, RoomData& transformedRoomData)
+{
+    int32_t roomWidth = roomData.cells.GetWidth();
+    int32_t roomHeight = roomData.cells.GetHeight();
+    bool isSwappingAxes = ((transformIndex & SWAP_AXES_FLAG) != 0);
+    int32_t transformedWidth = isSwappingAxes ? roomHeight : roomWidth;
+    int32_t transformedHeight = isSwappingAxes ? roomWidth : roomHeight;
+
+    CellData borderCell;
+    borderCell.SetType(CellData::Type::Wall);
+    transformedRoomData.cells.Resize(transformedWidth, transformedHeight, borderCell);
+    transformedRoomData.switchIndices.Resize(transformedWidth, transformedHeight);
+    for (int32_t y = 0; y < transformedHeight; ++y)
+    {
+        for (int32_t x = 0; x < transformedWidth; ++x)
+        {
+            int32_t sourceX = 0;
+            int32_t sourceY = 0;
+            GetSourcePosition(roomData, transformIndex, x, y, sourceX, sourceY);
+
+            CellData cellData;
+            cellData.SetType(roomData.cells.Get(sourceX, sourceY)->GetType());
+            transformedRoomData.cells.Set(x, y, cellData);
+            transformedRoomData.switchIndices.Set(x, y, *roomData.switchIndices.Get(sourceX, sourceY));
+        }
+    }
+
+    // Positions of -1 mark missing switches and doors, and stay as they are
+    auto transformPosition = [&roomData, &transformIndex](int32_t& x, int32_t& y)
+    {
+        if ((x >= 0) && (x < roomData.cells.GetWidth()) && (y >= 0) && (y < roomData.cells.GetHeight()))
+        {
+            int32_t sourceX = x;
+            int32_t sourceY = y;
+            GetTransformedPosition(roomData, transformIndex, sourceX, sourceY, x, y);
+        }
+    };
+
+    transformedRoomData.switchDoorMappings = roomData.switchDoorMappings;
+    for (SwitchDoorMapping &mapping : transformedRoomData.switchDoorMappings)
+    {
+        transformPosition(mapping.switchX, mapping.switchY);
+        transformPosition(mapping.doorX, mapping.doorY);
+    }
+
+    transformedRoomData.playerStartX = roomData.playerStartX;
+    transformedRoomData.playerStartY = roomData.playerStartY;
+    transformPosition(transformedRoomData.playerStartX, transformedRoomData.playerStartY);
+    transformedRoomData.goalX = roomData.goalX;
+    transformedRoomData.goalY = roomData.goalY;
+    transformPosition(transformedRoomData.goalX, transformedRoomData.goalY);
+
+    transformedRoomData.ResetCells();
+    transformedRoomData.Analyze();
+}
+
+/**
+ * @brief Gets the transform that turns a room into its canonical form
+ * @param[in] roomData Room data
+ * @return Transform index
+ */
+int32_t RoomSymmetry::GetCanonicalTransform(const RoomData& roomData)
+{
+    std::string bestKey;
+    std::string key;
+    int32_t bestTransformIndex = 0;
+    Encode(roomData, 0, bestKey);
+    for (int32_t transformIndex = 1; transformIndex < NUM_TRANSFORMS; ++transformIndex)
+    {
+        Encode(roomData, transformIndex, key);
+        if (key < bestKey)
+        {
+            bestKey.swap(key);
+            bestTransformIndex = transformIndex;
+        }
+    }
+
+    return bestTransformIndex;
+}
+
+/**
+ * @brief Gets the canonical form of a room, with its switch letters renamed in
+ * the order they first appear
+ * @param[in] roomData Room data
+ * @param[out] canonicalRoomData Canonical room, reset and analyzed as if loaded from a level file
+ */
+void RoomSymmetry::GetCanonicalForm(const RoomData& roomData, RoomData& canonicalRoomData)
+{
+    Transform(roomData, GetCanonicalTransform(roomData), canonicalRoomData);
+
+    std::array<int32_t, RoomData::MAX_SWITCHES> newSwitchIds;
+    newSwitchIds.fill(-1);
+    int32_t numSwitchIds = 0;
+    canonicalRoomData.switchIndices.ForEach([&newSwitchIds, &numSwitchIds](const int32_t&, const int32_t&, int8_t& switchIndex)
+    {
+        if ((switchIndex >= 0) && (switchIndex < RoomData::MAX_SWITCHES))
+        {
+            if (newSwitchIds[switchIndex] == -1)
+            {
+                newSwitchIds[switchIndex] = 'a' + numSwitchIds;
+                ++numSwitchIds;
+            }
+            switchIndex = static_cast<int8_t>(newSwitchIds[switchIndex] - 'a');
+        }
+    });
+
+    std::array<SwitchDoorMapping, RoomData::MAX_SWITCHES> mappings = canonicalRoomData.switchDoorMappings;
+    for (SwitchDoorMapping &mapping : canonicalRoomData.switchDoorMappings)
+    {
+        mapping = { -1, -1, -1, -1, -1 };
+    }
+    for (const SwitchDoorMapping &mapping : mappings)
+    {
+        if ((mapping.switchId >= 'a') && (mapping.switchId < 'a' + RoomData::MAX_SWITCHES) && (newSwitchIds[mapping.switchId - 'a'] != -1))
+        {
+            int32_t switchId = newSwitchIds[mapping.switchId - 'a'];
+            canonicalRoomData.switchDoorMappings[switchId - 'a'] = { switchId, mapping.switchX, mapping.switchY, mapping.doorX, mapping.doorY };
+        }
+    }
+
+    canonicalRoomData.ResetCells();
+    canonicalRoomData.Analyze();
+}
+
+/**
+ * @brief Gets the encoding of the canonical form of a room. Two rooms have the
+ * same key if and only if one is a rotation or reflection of the other, up to
+ * renaming the switch letters
+ * @param[in] roomData Room data
+ * @return Canonical key
+ */
+std::string RoomSymmetry::GetCanonicalKey(const RoomData& roomData)
+{
+    std::string bestKey;
+    std::string key;
+    Encode(roomData, 0, bestKey);
+    for (int32_t transformIndex = 1; transformIndex < NUM_TRANSFORMS; ++transformIndex)
+    {
+        Encode(roomData, transformIndex, key);
+        if (key < bestKey)
+        {
+            bestKey.swap(key);
+        }
+    }
+
+    return bestKey;
+}
+
+/**
+ * @brief Gets a 64-bit hash of the canonical key of a room
+ * @param[in] roomData Room data
+ * @return Canonical hash
+ */
+uint64_t RoomSymmetry::GetCanonicalHash(const RoomData& roomData)
+{
+    return HashKey(GetCanonicalKey(roomData));
+}
+
+/**
+ * @brief Gets a 64-bit hash of a canonical key
+ * @param[in] canonicalKey Canonical key
+ * @return Canonical hash
+ */
+uint64_t RoomSymmetry::HashKey(const std::string& canonicalKey)
+{
+    // FNV-1a, so the hash is the same on every platform and can be stored
+    uint64_t hash = 0xCBF29CE484222325ULL;
+    for (char character : canonicalKey)
+    {
+        hash ^= static_cast<uint8_t>(character);
+        hash *= 0x100000001B3ULL;
+    }
+
+    return hash;
+}
+
+/**
+ * @brief Encodes a transform of a room
+ * @param[in] roomData Room data
+ * @param[in] transformIndex Transform index
+ * @param[out] key Encoding of the transformed room
+ */
+void RoomSymmetry::Encode(const RoomData& roomData, const int32_t& transformIndex, std::string& key)
+{
+    int32_t roomWidth = roomData.cells.GetWidth();
+    int32_t roomHeight = roomData.cells.GetHeight();
+    bool isSwappingAxes = ((transformIndex & SWAP_AXES_FLAG) != 0);
+    int32_t transformedWidth = isSwappingAxes ? roomHeight : roomWidth;
+    int32_t transformedHeight = isSwappingAxes ? roomWidth : roomHeight;
+    int32_t startX = roomData.playerStartX;
+    int32_t startY = roomData.playerStartY;
+    GetTransformedPosition(roomData, transformIndex, roomData.playerStartX, roomData.playerStartY, startX, startY);
+
+    key.clear();
+    key.reserve(8 + transformedWidth * transformedHeight);
+    for (int32_t value : { transformedWidth, transformedHeight, startX, startY })
+    {
+        key.push_back(static_cast<char>((value >> 8) & 0xFF));
+        key.push_back(static_cast<char>(value & 0xFF));
+    }
+
+    // Each cell is its type in the upper bits, and for switches and doors, the
+    // order in which their letter first appeared plus one in the lower 5 bits
+    std::array<int32_t, RoomData::MAX_SWITCHES> labels;
+    labels.fill(0);
+    int32_t numLabels = 0;
+    for (int32_t y = 0; y < transformedHeight; ++y)
+    {
+        for (int32_t x = 0; x < transformedWidth; ++x)
+        {
+            int32_t sourceX = 0;
+            int32_t sourceY = 0;
+            GetSourcePosition(roomData, transformIndex, x, y, sourceX, sourceY);
+
+            CellData::Type cellType = roomData.cells.Get(sourceX, sourceY)->GetType();
+            int32_t label = 0;
+            if ((cellType == CellData::Type::Switch) || (cellType == CellData::Type::Door))
+            {
+                int8_t switchIndex = *roomData.switchIndices.Get(sourceX, sourceY);
+                if ((switchIndex >= 0) && (switchIndex < RoomData::MAX_SWITCHES))
+                {
+                    if (labels[switchIndex] == 0)
+                    {
+                        labels[switchIndex] = ++numLabels;
+                    }
+                    label = labels[switchIndex];
+                }
+            }
+            key.push_back(static_cast<char>((static_cast<int32_t>(cellType) << 5) | label));
+        }
+    }
+}
+
+/**
+ * @brief Gets the position in the original room of a cell of a transformed room
+ * @param[in] roomData Room data
+ * @param[in] transformIndex Transform index
+ * @param[in] x X-position in the transformed room
+ * @param[in] y Y-position in the transformed room
+ * @param[out] sourceX X-position in the original room
+ * @param[out] sourceY Y-position in the original room
+ */
+void RoomSymmetry::GetSourcePosition(
+    const RoomData& roomData,
+    const int32_t& transformIndex,
+    const int32_t& x,
+    const int32_t& y,
+    int32_t& sourceX,
+    int32_t& sourceY)
+{
+    bool isSwappingAxes = ((transformIndex & SWAP_AXES_FLAG) != 0);
+    int32_t mirroredX = isSwappingAxes ? y : x;
+    int32_t mirroredY = isSwappingAxes ? x : y;
+    sourceX = ((transformIndex & MIRROR_X_FLAG) != 0) ? (roomData.cells.GetWidth() - 1 - mirroredX) : mirroredX;
+    sourceY = ((transformIndex & MIRROR_Y_FLAG) != 0) ? (roomData.cells.GetHeight() - 1 - mirroredY) : mirroredY;
+}
+
+/**
+ * @brief Gets the position in a transformed room of a cell of the original room
+ * @param[in] roomData Room data
+ * @param[in] transformIndex Transform index
+ * @param[in] sourceX X-position in the original room
+ * @param[in] sourceY Y-position in the original room
+ * @param[out] x X-position in the transformed room
+ * @param[out] y Y-position in the transformed room
+ */
+void RoomSymmetry::GetTransformedPosition(
+    const RoomData& roomData,
+    const int32_t& transformIndex,
+    const int32_t& sourceX,
+    const int32_t& sourceY,
+    int32_t& x,
+    int32_t& y)
+{
+    int32_t mirroredX = ((transformIndex & MIRROR_X_FLAG) != 0) ? (roomData.cells.GetWidth() - 1 - sourceX) : sourceX;
+    int32_t mirroredY = ((transformIndex & MIRROR_Y_FLAG) != 0) ? (roomData.cells.GetHeight() - 1 - sourceY) : sourceY;
+    bool isSwappingAxes = ((transformIndex & SWAP_AXES_FLAG) != 0);
+    x = isSwappingAxes ? mirroredY : mirroredX;
+    y = isSwappingAxes ? mirroredX : mirroredY;
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include "LevelData.hpp"
+
+#include <cstdint>
+#include <string>
+
+/**
+ * Canonical form of a room under the 8 symmetries of the square (4 rotations, each
+ * optionally mirrored), so that rooms that only differ by a rotation or reflection
+ * can be recognized as the same puzzle.
+ *
+ * Each transform is encoded as a string of its size, the player's starting position
+ * and its cells row by row, with switch letters renamed in the order they first
+ * appear (so a room with its letters swapped encodes the same). The canonical form
+ * is the transform with the smallest encoding. Only the room layout is encoded, not
+ * which cells have been visited.
+ */
+class RoomSymmetry
+{
+public:
+    /**
+     * Number of symmetry transforms of a room
+     */
+    static constexpr int32_t NUM_TRANSFORMS = 8;
+
+    /**
+     * @brief Transforms a room. Bit 0 of the transform index mirrors the room
+     * horizontally, bit 1 mirrors it vertically, and bit 2 swaps the X and Y axes.
+     * Switch letters are kept as they are
+     * @param[in] roomData Room data
+     * @param[in] transformIndex Transform index, from 0 to NUM_TRANSFORMS - 1
+     * @param[out] transformedRoomData Transformed room, reset and analyzed as if loaded from a level file
+     */
+    static void Transform(const RoomData& roomData, const int32_t& transformIndex, RoomData& transformedRoomData);
+
+    /**
+     * @brief Gets the transform that turns a room into its canonical form
+     * @param[in] roomData Room data
+     * @return Transform index
+     */
+    static int32_t GetCanonicalTransform(const RoomData& roomData);
+
+    /**
+     * @brief Gets the canonical form of a room, with its switch letters renamed in
+     * the order they first appear
+     * @param[in] roomData Room data
+     * @param[out] canonicalRoomData Canonical room, reset and analyzed as if loaded from a level file
+     */
+    static void GetCanonicalForm(const RoomData& roomData, RoomData& canonicalRoomData);
+
+    /**
+     * @brief Gets the encoding of the canonical form of a room. Two rooms have the
+     * same key if and only if one is a rotation or reflection of the other, up to
+     * renaming the switch letters
+     * @param[in] roomData Room data
+     * @return Canonical key
+     */
+    static std::string GetCanonicalKey(const RoomData& roomData);
+
+    /**
+     * @brief Gets a 64-bit hash of the canonical key of a room
+     * @param[in] roomData Room data
+     * @return Canonical hash
+     */
+    static uint64_t GetCanonicalHash(const RoomData& roomData);
+
+    /**
+     * @brief Gets a 64-bit hash of a canonical key
+     * @param[in] canonicalKey Canonical key
+     * @return Canonical hash
+     */
+    static uint64_t HashKey(const std::string& canonicalKey);
+
+private:
+    /**
+     * @brief Encodes a transform of a room
+     * @param[in] roomData Room data
+     * @param[in] transformIndex Transform index
+     * @param[out] key Encoding of the transformed room
+     */
+    static void Encode(const RoomData& roomData, const int32_t& transformIndex, std::string& key);
+
+    /**
+     * @brief Gets the position in the original room of a cell of a transformed room
+     * @param[in] roomData Room data
+     * @param[in] transformIndex Transform index
+     * @param[in] x X-position in the transformed room
+     * @param[in] y Y-position in the transformed room
+     * @param[out] sourceX X-position in the original room
+     * @param[out] sourceY Y-position in the original room
+     */
+    static void GetSourcePosition(
+        const RoomData& roomData,
+        const int32_t& transformIndex,
+        const int32_t& x,
+        const int32_t& y,
+        int32_t& sourceX,
+        int32_t& sourceY);
+
+    /**
+     * @brief Gets the position in a transformed room of a cell of the original room
+     * @param[in] roomData Room data
+     * @param[in] transformIndex Transform index
+     * @param[in] sourceX X-position in the original room
+     * @param[in] sourceY Y-position in the original room
+     * @param[out] x X-position in the transformed room
+     * @param[out] y Y-position in the transformed room
+     */
+    static void GetTransformedPosition(
+        const RoomData& roomData,
+        const int32_t& transformIndex,
+        const int32_t& sourceX,
+        const int32_t& sourceY,
+        int32_t& x,
+        int32_t& y);
+};
@@ -0,0 +1,526 @@
+#include "SolutionCounter.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <unordered_map>
+#include <utility>
+
+// Plug values of the frontier sweep. A path fragment with both ends on the frontier
+// has an opening plug on its left end and a closing plug on its right end, like a
+// pair of brackets. A fragment that starts at the player's start or at the goal has
+// a single end plug on the frontier.
+#define NO_PLUG 0
+#define OPENING_PLUG 1
+#define CLOSING_PLUG 2
+#define END_PLUG 3
+
+#define PLUG_BITS 2
+#define PLUG_MASK 3
+
+// Set on frontier states where the path from the start to the goal is complete
+#define COMPLETE_STATE_FLAG (uint64_t(1) << 63)
+
+/**
+ * @brief Constructor
+ */
+SolutionCounter::SolutionCounter()
+    : m_maxSolutions(0)
+    , m_maxNodes(0)
+    , m_numSolutions(0)
+    , m_numNodesExpanded(0)
+    , m_maxNumFrontierStates(0)
+    , m_iceStops()
+    , m_hasUsedFrontier(false)
+    , m_hasHitLimit(false)
+    , m_hasOverflowed(false)
+{
+}
+
+/**
+ * @brief Destructor
+ */
+SolutionCounter::~SolutionCounter()
+{
+}
+
+/**
+ * @brief Sets the maximum number of solutions to enumerate before giving up.
+ * The frontier sweep always counts all solutions.
+ * @param[in] maxSolutions Maximum number of solutions. 0 means no limit
+ */
+void SolutionCounter::SetMaxSolutions(const uint64_t& maxSolutions)
+{
+    m_maxSolutions = maxSolutions;
+}
+
+/**
+ * @brief Sets the maximum number of search nodes the enumeration expands before giving up
+ * @param[in] maxNodes Maximum number of search nodes. 0 means no limit
+ */
+void SolutionCounter::SetMaxNodes(const uint64_t& maxNodes)
+{
+    m_maxNodes = maxNodes;
+}
+
+/**
+ * @brief Counts the move sequences that solve the specified room
+ * @param[in] roomData Room data
+ * @return Number of solutions. If IsExact() returns false, this is only a lower bound
+ */
+uint64_t SolutionCounter::Count(const RoomData& roomData)
+{
+    m_numSolutions = 0;
+    m_numNodesExpanded = 0;
+    m_maxNumFrontierStates = 0;
+    m_hasUsedFrontier = false;
+    m_hasHitLimit = false;
+    m_hasOverflowed = false;
+
+    if (roomData.analysis.IsProvablyUnsolvable())
+    {
+        return 0;
+    }
+
+    if (CanUseFrontier(roomData))
+    {
+        m_hasUsedFrontier = true;
+        return CountWithFrontier(roomData);
+    }
+
+    return DispatchToBitboard(roomData.cells.GetWidth(), roomData.cells.GetHeight(), [&](auto numWords)
+    {
+        return CountWithBitboard<decltype(numWords)::value>(roomData);
+    });
+}
+
+/**
+ * @brief Queries whether the specified room can be counted with the frontier sweep
+ * @param[in] roomData Room data
+ * @return Returns true if every cell is a floor, a wall or the goal, the player
+ * starts on a floor, and the shorter side of the room is at most MAX_FRONTIER_WIDTH cells
+ */
+bool SolutionCounter::CanUseFrontier(const RoomData& roomData)
+{
+    if (std::min(roomData.cells.GetWidth(), roomData.cells.GetHeight()) > MAX_FRONTIER_WIDTH)
+    {
+        return false;
+    }
+
+    const CellData *startCell = roomData.cells.Get(roomData.playerStartX, roomData.playerStartY);
+    if ((startCell == nullptr) || (startCell->GetType() != CellData::Type::Floor))
+    {
+        return false;
+    }
+
+    bool isPlain = true;
+    roomData.cells.ForEach([&](const int32_t& x, const int32_t& y, const CellData& cellData)
+    {
+        bool isGoal = (x == roomData.goalX) && (y == roomData.goalY);
+        CellData::Type type = cellData.GetType();
+        if (isGoal ? (type != CellData::Type::Goal) : ((type != CellData::Type::Floor) && (type != CellData::Type::Wall)))
+        {
+            isPlain = false;
+        }
+    });
+
+    return isPlain;
+}
+
+/**
+ * @brief Queries whether the last call to Count() used the frontier sweep
+ * @return Returns true for the frontier sweep, false for the enumeration
+ */
+bool SolutionCounter::HasUsedFrontier() const
+{
+    return m_hasUsedFrontier;
+}
+
+/**
+ * @brief Queries whether the last count is the exact number of solutions
+ * @return Returns false if the enumeration gave up or the count did not fit in 64 bits
+ */
+bool SolutionCounter::IsExact() const
+{
+    return !m_hasHitLimit && !m_hasOverflowed;
+}
+
+/**
+ * @brief Gets the number of search nodes expanded by the last enumeration
+ * @return Number of search nodes expanded
+ */
+uint64_t SolutionCounter::GetNumNodesExpanded() const
+{
+    return m_numNodesExpanded;
+}
+
+/**
+ * @brief Gets the largest number of frontier states kept by the last frontier sweep
+ * @return Largest number of frontier states
+ */
+size_t SolutionCounter::GetMaxNumFrontierStates() const
+{
+    return m_maxNumFrontierStates;
+}
+
+/**
+ * @brief Counts the Hamiltonian paths from the start to the goal of a plain room
+ * with a frontier sweep
+ * @param[in] roomData Room data
+ * @return Number of solutions, saturated at the largest 64-bit value
+ */
+uint64_t SolutionCounter::CountWithFrontier(const RoomData& roomData)
+{
+    enum class CellKind : uint8_t
+    {
+        Wall,
+        Floor,
+        PathEnd
+    };
+
+    // Sweep along the shorter side, since the number of frontier states grows
+    // exponentially with the sweep width
+    bool isTransposed = (roomData.cells.GetHeight() < roomData.cells.GetWidth());
+    int32_t width = isTransposed ? roomData.cells.GetHeight() : roomData.cells.GetWidth();
+    int32_t height = isTransposed ? roomData.cells.GetWidth() : roomData.cells.GetHeight();
+    std::vector<CellKind> cellKinds(width * height, CellKind::Wall);
+    int32_t numFloors = 0;
+    for (int32_t row = 0; row < height; ++row)
+    {
+        for (int32_t column = 0; column < width; ++column)
+        {
+            int32_t x = isTransposed ? row : column;
+            int32_t y = isTransposed ? column : row;
+            CellKind &cellKind = cellKinds[row * width + column];
+            if (((x == roomData.playerStartX) && (y == roomData.playerStartY))
+                || ((x == roomData.goalX) && (y == roomData.goalY)))
+            {
+                cellKind = CellKind::PathEnd;
+            }
+            else if (roomData.cells.Get(x, y)->GetType() == CellData::Type::Floor)
+            {
+                cellKind = CellKind::Floor;
+                ++numFloors;
+            }
+        }
+    }
+
+    // The goal only unlocks after the first move, so it cannot be the first cell
+    // the player steps on
+    if (numFloors == 0)
+    {
+        return 0;
+    }
+
+    // When sweeping the cell in column c, plug c of a frontier state is the left edge
+    // of that cell. Plug i < c is the bottom edge of the swept cell in column i, and
+    // plug i > c is the bottom edge of the cell in column i - 1 in the row above.
+    std::unordered_map<uint64_t, uint64_t> states;
+    std::unordered_map<uint64_t, uint64_t> nextStates;
+    states[0] = 1;
+    for (int32_t row = 0; row < height; ++row)
+    {
+        for (int32_t column = 0; column < width; ++column)
+        {
+            CellKind cellKind = cellKinds[row * width + column];
+            bool canGoDown = (row < height - 1) && (cellKinds[(row + 1) * width + column] != CellKind::Wall);
+            bool canGoRight = (column < width - 1) && (cellKinds[row * width + column + 1] != CellKind::Wall);
+
+            nextStates.clear();
+            for (const auto &[state, count] : states)
+            {
+                uint32_t leftPlug = GetPlug(state, column);
+                uint32_t upPlug = GetPlug(state, column + 1);
+                uint64_t clearedState = SetPlug(SetPlug(state, column, NO_PLUG), column + 1, NO_PLUG);
+                if (cellKind == CellKind::Wall)
+                {
+                    if ((leftPlug == NO_PLUG) && (upPlug == NO_PLUG))
+                    {
+                        AddCount(nextStates[state], count);
+                    }
+                    continue;
+                }
+
+                // Every cell after the end of the path is left unvisited
+                if ((state & COMPLETE_STATE_FLAG) != 0)
+                {
+                    continue;
+                }
+
+                if ((leftPlug == NO_PLUG) && (upPlug == NO_PLUG))
+                {
+                    // A floor starts a new fragment going both down and right, while
+                    // the start and the goal start a fragment going either way
+                    if ((cellKind == CellKind::Floor) && canGoDown && canGoRight)
+                    {
+                        AddCount(nextStates[SetPlug(SetPlug(clearedState, column, OPENING_PLUG), column + 1, CLOSING_PLUG)], count);
+                    }
+                    if ((cellKind == CellKind::PathEnd) && canGoDown)
+                    {
+                        AddCount(nextStates[SetPlug(clearedState, column, END_PLUG)], count);
+                    }
+                    if ((cellKind == CellKind::PathEnd) && canGoRight)
+                    {
+                        AddCount(nextStates[SetPlug(clearedState, column + 1, END_PLUG)], count);
+                    }
+                }
+                else if ((leftPlug == NO_PLUG) || (upPlug == NO_PLUG))
+                {
+                    uint32_t plug = leftPlug | upPlug;
+                    int32_t plugIndex = (leftPlug != NO_PLUG) ? column : (column + 1);
+                    if (cellKind == CellKind::Floor)
+                    {
+                        // The fragment goes through the floor
+                        if (canGoDown)
+                        {
+                            AddCount(nextStates[SetPlug(clearedState, column, plug)], count);
+                        }
+                        if (canGoRight)
+                        {
+                            AddCount(nextStates[SetPlug(clearedState, column + 1, plug)], count);
+                        }
+                    }
+                    else if (plug == END_PLUG)
+                    {
+                        // The fragment from the other end of the path ends here, which
+                        // completes the path if no other fragments are left
+                        if (clearedState == 0)
+                        {
+                            AddCount(nextStates[COMPLETE_STATE_FLAG], count);
+                        }
+                    }
+                    else
+                    {
+                        AddCount(nextStates[SetPlug(clearedState, FindMatchingPlug(state, plugIndex), END_PLUG)], count);
+                    }
+                }
+                else if (cellKind == CellKind::Floor)
+                {
+                    // The floor joins two fragments
+                    if ((leftPlug == END_PLUG) && (upPlug == END_PLUG))
+                    {
+                        if (clearedState == 0)
+                        {
+                            AddCount(nextStates[COMPLETE_STATE_FLAG], count);
+                        }
+                    }
+                    else if (leftPlug == END_PLUG)
+                    {
+                        AddCount(nextStates[SetPlug(clearedState, FindMatchingPlug(state, column + 1), END_PLUG)], count);
+                    }
+                    else if (upPlug == END_PLUG)
+                    {
+                        AddCount(nextStates[SetPlug(clearedState, FindMatchingPlug(state, column), END_PLUG)], count);
+                    }
+                    else if ((leftPlug == OPENING_PLUG) && (upPlug == OPENING_PLUG))
+                    {
+                        AddCount(nextStates[SetPlug(clearedState, FindMatchingPlug(state, column + 1), OPENING_PLUG)], count);
+                    }
+                    else if ((leftPlug == CLOSING_PLUG) && (upPlug == CLOSING_PLUG))
+                    {
+                        AddCount(nextStates[SetPlug(clearedState, FindMatchingPlug(state, column), CLOSING_PLUG)], count);
+                    }
+                    else if ((leftPlug == CLOSING_PLUG) && (upPlug == OPENING_PLUG))
+                    {
+                        AddCount(nextStates[clearedState], count);
+                    }
+                    // Joining both ends of the same fragment would close a cycle
+                }
+            }
+
+            std::swap(states, nextStates);
+            m_maxNumFrontierStates = std::max(m_maxNumFrontierStates, states.size());
+        }
+
+        // Nothing crosses the right edge, so the plugs shift by one to make room for
+        // the left edge of the next row
+        nextStates.clear();
+        for (const auto &[state, count] : states)
+        {
+            uint64_t shiftedState = ((state & ~COMPLETE_STATE_FLAG) << PLUG_BITS) | (state & COMPLETE_STATE_FLAG);
+            AddCount(nextStates[shiftedState], count);
+        }
+        std::swap(states, nextStates);
+    }
+
+    auto it = states.find(COMPLETE_STATE_FLAG);
+    return (it != states.end()) ? it->second : 0;
+}
+
+/**
+ * @brief Counts the solutions by enumeration using a bitboard with the specified number of words
+ * @param[in] roomData Room data
+ * @return Number of solutions found
+ */
+template <size_t NumWords>
+uint64_t SolutionCounter::CountWithBitboard(const RoomData& roomData)
+{
+    RoomBitboard<NumWords> board;
+    if (!board.Build(roomData) || (board.GetGoalIndex() == -1))
+    {
+        return 0;
+    }
+
+    ConnectivityTracker<NumWords> tracker;
+    tracker.Build(board);
+    if (!tracker.CanReachRequiredCells(board, board.GetStartIndex()))
+    {
+        return 0;
+    }
+
+    m_iceStops.clear();
+    if (board.GetIceMask().Test(board.GetStartIndex()))
+    {
+        m_iceStops.push_back(board.GetStartIndex());
+    }
+    Enumerate(board, tracker, board.GetStartIndex(), 0);
+
+    return m_numSolutions;
+}
+
+/**
+ * @brief Recursively enumerates the solutions from the specified position
+ * @param[in,out] board Room bitboard
+ * @param[in,out] tracker Connectivity tracker, in sync with the bitboard
+ * @param[in] cellIndex Cell index of the player's position
+ * @param[in] firstIceStopIndex Index of the first ice stop made since the room state last changed
+ */
+template <size_t NumWords>
+void SolutionCounter::Enumerate(
+    RoomBitboard<NumWords>& board,
+    ConnectivityTracker<NumWords>& tracker,
+    const int32_t& cellIndex,
+    const size_t& firstIceStopIndex)
+{
+    ++m_numNodesExpanded;
+    if ((m_maxNodes != 0) && (m_numNodesExpanded > m_maxNodes))
+    {
+        m_hasHitLimit = true;
+        return;
+    }
+
+    for (Direction direction : ALL_DIRECTIONS)
+    {
+        int32_t newCellIndex = cellIndex;
+        RoomMoveRecord record;
+        if (!board.ApplyMove(newCellIndex, direction, record))
+        {
+            continue;
+        }
+
+        if (record.hasReachedGoal)
+        {
+            board.UndoMove(record);
+            ++m_numSolutions;
+            if ((m_maxSolutions != 0) && (m_numSolutions >= m_maxSolutions))
+            {
+                m_hasHitLimit = true;
+                return;
+            }
+            continue;
+        }
+
+        // Unlike a solver, the same ice cell has to be searched from again on every
+        // other branch, since each branch leads to different solutions. Stopping on
+        // ice keeps the room state, unless it unlocks the goal, in which case the
+        // ice cell is the first stop made in the new state
+        bool isIceStop = !board.HasChangedRoomState(record);
+        if (isIceStop
+            && (std::find(m_iceStops.begin() + firstIceStopIndex, m_iceStops.end(), newCellIndex) != m_iceStops.end()))
+        {
+            board.UndoMove(record);
+            continue;
+        }
+
+        tracker.ApplyMove(board, record);
+        if (!tracker.IsDeadEnd(board, cellIndex, newCellIndex, record))
+        {
+            size_t numIceStops = m_iceStops.size();
+            if (record.visitedCellIndex == -1)
+            {
+                m_iceStops.push_back(newCellIndex);
+            }
+
+            Enumerate(board, tracker, newCellIndex, isIceStop ? firstIceStopIndex : numIceStops);
+            m_iceStops.resize(numIceStops);
+        }
+        tracker.UndoMove(board, record);
+        board.UndoMove(record);
+
+        if (m_hasHitLimit)
+        {
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Adds a number of ways to a frontier state count, saturating instead of overflowing
+ * @param[in,out] count Count to add to
+ * @param[in] numWays Number of ways to add
+ */
+void SolutionCounter::AddCount(uint64_t& count, const uint64_t& numWays)
+{
+    if (count > std::numeric_limits<uint64_t>::max() - numWays)
+    {
+        count = std::numeric_limits<uint64_t>::max();
+        m_hasOverflowed = true;
+        return;
+    }
+
+    count += numWays;
+}
+
+/**
+ * @brief Gets the plug at the specified position of a frontier state
+ * @param[in] state Frontier state
+ * @param[in] index Plug position
+ * @return Plug value
+ */
+uint32_t SolutionCounter::GetPlug(const uint64_t& state, const int32_t& index)
+{
+    return static_cast<uint32_t>((state >> (index * PLUG_BITS)) & PLUG_MASK);
+}
+
+/**
+ * @brief Sets the plug at the specified position of a frontier state
+ * @param[in] state Frontier state
+ * @param[in] index Plug position
+ * @param[in] plug Plug value
+ * @return Frontier state with the plug set
+ */
+uint64_t SolutionCounter::SetPlug(const uint64_t& state, const int32_t& index, const uint32_t& plug)
+{
+    int32_t shift = index * PLUG_BITS;
+    return (state & ~(uint64_t(PLUG_MASK) << shift)) | (uint64_t(plug) << shift);
+}
+
+/**
+ * @brief Finds the other end of the path fragment whose end is at the specified
+ * position of a frontier state
+ * @param[in] state Frontier state
+ * @param[in] index Plug position of an opening or closing plug
+ * @return Plug position of the matching plug
+ */
+int32_t SolutionCounter::FindMatchingPlug(const uint64_t& state, const int32_t& index)
+{
+    // Fragments cannot cross, so the plugs nest like brackets. End plugs are skipped.
+    int32_t step = (GetPlug(state, index) == OPENING_PLUG) ? 1 : -1;
+    int32_t depth = 0;
+    for (int32_t i = index; ; i += step)
+    {
+        uint32_t plug = GetPlug(state, i);
+        if (plug == OPENING_PLUG)
+        {
+            depth += step;
+        }
+        else if (plug == CLOSING_PLUG)
+        {
+            depth -= step;
+        }
+
+        if (depth == 0)
+        {
+            return i;
+        }
+    }
+}
@@ -0,0 +1,209 @@
+#pragma once
+
+#include "ConnectivityTracker.hpp"
+#include "Direction.hpp"
+#include "LevelData.hpp"
+#include "RoomBitboard.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Counts the distinct move sequences that solve a room.
+ *
+ * In plain rooms, where every cell is a floor, a wall or the goal, each move visits
+ * one cell, so the solutions are exactly the Hamiltonian paths from the start to the
+ * goal through the non-wall cells. These are counted with a frontier sweep (plug
+ * dynamic programming): the grid is swept one cell at a time along its shorter side,
+ * and for each way the path fragments can cross the frontier between swept and
+ * unswept cells, the number of ways to build them is kept. The number of frontier
+ * states only depends on the sweep width, so the time grows linearly with the area
+ * for a fixed width.
+ *
+ * Rooms with ice, switches, doors or empty cells are counted by enumerating the
+ * solutions with a backtracking search instead. A solution never stops on the same
+ * ice cell twice without visiting a cell in between, since that would repeat a room
+ * state.
+ */
+class SolutionCounter
+{
+public:
+    /**
+     * Maximum sweep width of the frontier sweep, i.e. of the shorter side of the room
+     */
+    static constexpr int32_t MAX_FRONTIER_WIDTH = 30;
+
+private:
+    /**
+     * Maximum number of solutions to enumerate before giving up. 0 means no limit
+     */
+    uint64_t m_maxSolutions;
+
+    /**
+     * Maximum number of search nodes to expand before giving up. 0 means no limit
+     */
+    uint64_t m_maxNodes;
+
+    /**
+     * Number of solutions found so far by the enumeration
+     */
+    uint64_t m_numSolutions;
+
+    /**
+     * Number of search nodes expanded by the last call to Count()
+     */
+    uint64_t m_numNodesExpanded;
+
+    /**
+     * Largest number of frontier states at any point of the last frontier sweep
+     */
+    size_t m_maxNumFrontierStates;
+
+    /**
+     * Ice cells stopped on along the current search branch since the room state last changed
+     */
+    std::vector<int32_t> m_iceStops;
+
+    /**
+     * Flag indicating whether the last call to Count() used the frontier sweep
+     */
+    bool m_hasUsedFrontier;
+
+    /**
+     * Flag indicating whether the last enumeration gave up due to the solution or node limit
+     */
+    bool m_hasHitLimit;
+
+    /**
+     * Flag indicating whether the last count did not fit in 64 bits
+     */
+    bool m_hasOverflowed;
+
+public:
+    /**
+     * @brief Constructor
+     */
+    SolutionCounter();
+
+    /**
+     * @brief Destructor
+     */
+    ~SolutionCounter();
+
+    /**
+     * @brief Sets the maximum number of solutions to enumerate before giving up.
+     * The frontier sweep always counts all solutions.
+     * @param[in] maxSolutions Maximum number of solutions. 0 means no limit
+     */
+    void SetMaxSolutions(const uint64_t& maxSolutions);
+
+    /**
+     * @brief Sets the maximum number of search nodes the enumeration expands before giving up
+     * @param[in] maxNodes Maximum number of search nodes. 0 means no limit
+     */
+    void SetMaxNodes(const uint64_t& maxNodes);
+
+    /**
+     * @brief Counts the move sequences that solve the specified room
+     * @param[in] roomData Room data
+     * @return Number of solutions. If IsExact() returns false, this is only a lower bound
+     */
+    uint64_t Count(const RoomData& roomData);
+
+    /**
+     * @brief Queries whether the specified room can be counted with the frontier sweep
+     * @param[in] roomData Room data
+     * @return Returns true if every cell is a floor, a wall or the goal, the player
+     * starts on a floor, and the shorter side of the room is at most MAX_FRONTIER_WIDTH cells
+     */
+    static bool CanUseFrontier(const RoomData& roomData);
+
+    /**
+     * @brief Queries whether the last call to Count() used the frontier sweep
+     * @return Returns true for the frontier sweep, false for the enumeration
+     */
+    bool HasUsedFrontier() const;
+
+    /**
+     * @brief Queries whether the last count is the exact number of solutions
+     * @return Returns false if the enumeration gave up or the count did not fit in 64 bits
+     */
+    bool IsExact() const;
+
+    /**
+     * @brief Gets the number of search nodes expanded by the last enumeration
+     * @return Number of search nodes expanded
+     */
+    uint64_t GetNumNodesExpanded() const;
+
+    /**
+     * @brief Gets the largest number of frontier states kept by the last frontier sweep
+     * @return Largest number of frontier states
+     */
+    size_t GetMaxNumFrontierStates() const;
+
+private:
+    /**
+     * @brief Counts the Hamiltonian paths from the start to the goal of a plain room
+     * with a frontier sweep
+     * @param[in] roomData Room data
+     * @return Number of solutions, saturated at the largest 64-bit value
+     */
+    uint64_t CountWithFrontier(const RoomData& roomData);
+
+    /**
+     * @brief Counts the solutions by enumeration using a bitboard with the specified number of words
+     * @param[in] roomData Room data
+     * @return Number of solutions found
+     */
+    template <size_t NumWords>
+    uint64_t CountWithBitboard(const RoomData& roomData);
+
+    /**
+     * @brief Recursively enumerates the solutions from the specified position
+     * @param[in,out] board Room bitboard
+     * @param[in,out] tracker Connectivity tracker, in sync with the bitboard
+     * @param[in] cellIndex Cell index of the player's position
+     * @param[in] firstIceStopIndex Index of the first ice stop made since the room state last changed
+     */
+    template <size_t NumWords>
+    void Enumerate(
+        RoomBitboard<NumWords>& board,
+        ConnectivityTracker<NumWords>& tracker,
+        const int32_t& cellIndex,
+        const size_t& firstIceStopIndex);
+
+    /**
+     * @brief Adds a number of ways to a frontier state count, saturating instead of overflowing
+     * @param[in,out] count Count to add to
+     * @param[in] numWays Number of ways to add
+     */
+    void AddCount(uint64_t& count, const uint64_t& numWays);
+
+    /**
+     * @brief Gets the plug at the specified position of a frontier state
+     * @param[in] state Frontier state
+     * @param[in] index Plug position
+     * @return Plug value
+     */
+    static uint32_t GetPlug(const uint64_t& state, const int32_t& index);
+
+    /**
+     * @brief Sets the plug at the specified position of a frontier state
+     * @param[in] state Frontier state
+     * @param[in] index Plug position
+     * @param[in] plug Plug value
+     * @return Frontier state with the plug set
+     */
+    static uint64_t SetPlug(const uint64_t& state, const int32_t& index, const uint32_t& plug);
+
+    /**
+     * @brief Finds the other end of the path fragment whose end is at the specified
+     * position of a frontier state
+     * @param[in] state Frontier state
+     * @param[in] index Plug position of an opening or closing plug
+     * @return Plug position of the matching plug
+     */
+    static int32_t FindMatchingPlug(const uint64_t& state, const int32_t& index);
+};
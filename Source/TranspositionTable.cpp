@@ -0,0 +1,235 @@
+#include "TranspositionTable.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <limits>
+
+/**
+ * @brief Constructor. The table is disabled until its size is set.
+ */
+TranspositionTable::TranspositionTable()
+    : m_buckets()
+    , m_generation(1)
+    , m_numProbes(0)
+    , m_numHits(0)
+    , m_numStores(0)
+    , m_numReplacements(0)
+    , m_numUsedEntries(0)
+{
+}
+
+/**
+ * @brief Destructor
+ */
+TranspositionTable::~TranspositionTable()
+{
+}
+
+/**
+ * @brief Sets the memory budget of the table, and clears it. The number of buckets
+ * is rounded down to a power of two so the table never exceeds the budget.
+ * @param[in] numBytes Memory budget in bytes. 0 to disable the table
+ */
+void TranspositionTable::SetSize(const size_t& numBytes)
+{
+    size_t numBuckets = numBytes / sizeof(Bucket);
+    numBuckets = (numBuckets > 0) ? std::bit_floor(numBuckets) : 0;
+
+    // Generation 0 marks an empty entry
+    m_buckets.assign(numBuckets, Bucket {});
+    m_buckets.shrink_to_fit();
+    m_generation = 1;
+    m_numProbes = 0;
+    m_numHits = 0;
+    m_numStores = 0;
+    m_numReplacements = 0;
+    m_numUsedEntries = 0;
+}
+
+/**
+ * @brief Gets the memory used by the table
+ * @return Memory used in bytes
+ */
+size_t TranspositionTable::GetSize() const
+{
+    return m_buckets.size() * sizeof(Bucket);
+}
+
+/**
+ * @brief Queries whether the table has any entries to store room states in
+ * @return Returns true if the table is enabled
+ */
+bool TranspositionTable::IsEnabled() const
+{
+    return !m_buckets.empty();
+}
+
+/**
+ * @brief Removes all the room states from the table, and resets the statistics
+ */
+void TranspositionTable::Clear()
+{
+    // Starting a new generation empties every entry without touching the memory
+    ++m_generation;
+    if (m_generation == 0)
+    {
+        std::fill(m_buckets.begin(), m_buckets.end(), Bucket {});
+        m_generation = 1;
+    }
+
+    m_numProbes = 0;
+    m_numHits = 0;
+    m_numStores = 0;
+    m_numReplacements = 0;
+    m_numUsedEntries = 0;
+}
+
+/**
+ * @brief Looks up the specified room state
+ * @param[in] hash Hash of the room state
+ * @return Returns true if the room state is known to be a dead end. Returns false otherwise
+ */
+bool TranspositionTable::Contains(const uint64_t& hash)
+{
+    if (m_buckets.empty())
+    {
+        return false;
+    }
+
+    ++m_numProbes;
+    const Bucket &bucket = GetBucket(hash);
+    for (const Entry &entry : bucket.entries)
+    {
+        if ((entry.generation == m_generation) && (entry.hash == hash))
+        {
+            ++m_numHits;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief Stores the specified room state as a dead end
+ * @param[in] hash Hash of the room state
+ * @param[in] numSubtreeNodes Number of search nodes it took to prove that the room
+ * state is a dead end, used to decide which entries to keep
+ */
+void TranspositionTable::Store(const uint64_t& hash, const uint64_t& numSubtreeNodes)
+{
+    if (m_buckets.empty())
+    {
+        return;
+    }
+
+    uint32_t clampedNumSubtreeNodes = static_cast<uint32_t>(
+        std::min<uint64_t>(numSubtreeNodes, std::numeric_limits<uint32_t>::max()));
+
+    // Prefer an empty entry. Otherwise, evict the entry that was the cheapest to
+    // prove dead, since it is also the cheapest to search again.
+    Bucket &bucket = GetBucket(hash);
+    Entry *targetEntry = nullptr;
+    for (Entry &entry : bucket.entries)
+    {
+        if (entry.generation != m_generation)
+        {
+            if ((targetEntry == nullptr) || (targetEntry->generation == m_generation))
+            {
+                targetEntry = &entry;
+            }
+            continue;
+        }
+        if (entry.hash == hash)
+        {
+            entry.numSubtreeNodes = std::max(entry.numSubtreeNodes, clampedNumSubtreeNodes);
+            return;
+        }
+        if ((targetEntry == nullptr)
+            || ((targetEntry->generation == m_generation) && (entry.numSubtreeNodes < targetEntry->numSubtreeNodes)))
+        {
+            targetEntry = &entry;
+        }
+    }
+
+    ++m_numStores;
+    if (targetEntry->generation == m_generation)
+    {
+        ++m_numReplacements;
+    }
+    else
+    {
+        ++m_numUsedEntries;
+    }
+
+    targetEntry->hash = hash;
+    targetEntry->numSubtreeNodes = clampedNumSubtreeNodes;
+    targetEntry->generation = m_generation;
+}
+
+/**
+ * @brief Gets the number of lookups since the table was last cleared
+ * @return Number of lookups
+ */
+uint64_t TranspositionTable::GetNumProbes() const
+{
+    return m_numProbes;
+}
+
+/**
+ * @brief Gets the number of lookups that found their room state since the table was last cleared
+ * @return Number of hits
+ */
+uint64_t TranspositionTable::GetNumHits() const
+{
+    return m_numHits;
+}
+
+/**
+ * @brief Gets the ratio of lookups that found their room state since the table was last cleared
+ * @return Hit rate between 0 and 1. Returns 0 if there were no lookups
+ */
+double TranspositionTable::GetHitRate() const
+{
+    return (m_numProbes > 0) ? static_cast<double>(m_numHits) / static_cast<double>(m_numProbes) : 0.0;
+}
+
+/**
+ * @brief Gets the number of room states stored since the table was last cleared
+ * @return Number of stored room states
+ */
+uint64_t TranspositionTable::GetNumStores() const
+{
+    return m_numStores;
+}
+
+/**
+ * @brief Gets the number of stored room states that replaced another one since the
+ * table was last cleared
+ * @return Number of replacements
+ */
+uint64_t TranspositionTable::GetNumReplacements() const
+{
+    return m_numReplacements;
+}
+
+/**
+ * @brief Gets the ratio of entries in use
+ * @return Occupancy between 0 and 1. Returns 0 if the table is disabled
+ */
+double TranspositionTable::GetOccupancy() const
+{
+    size_t numEntries = m_buckets.size() * BUCKET_SIZE;
+    return (numEntries > 0) ? static_cast<double>(m_numUsedEntries) / static_cast<double>(numEntries) : 0.0;
+}
+
+/**
+ * @brief Gets the bucket the specified room state belongs to
+ * @param[in] hash Hash of the room state
+ * @return Bucket
+ */
+TranspositionTable::Bucket& TranspositionTable::GetBucket(const uint64_t& hash)
+{
+    // The low bits pick the bucket, the full hash is compared within the bucket
+    return m_buckets[hash & (m_buckets.size() - 1)];
+}
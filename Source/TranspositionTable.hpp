@@ -0,0 +1,189 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Fixed-size hash table of room states that are known to be dead ends, keyed on
+ * their Zobrist hash. The table never grows beyond its memory budget: each hash
+ * maps to a small bucket of entries, and when the bucket is full the entry that
+ * took the least effort to prove dead is replaced.
+ */
+class TranspositionTable
+{
+public:
+    /**
+     * Memory budget the solvers give the table unless told otherwise, in bytes
+     */
+    static constexpr size_t DEFAULT_SIZE = 16 * 1024 * 1024;
+
+private:
+    /**
+     * Number of entries in each bucket
+     */
+    static constexpr int32_t BUCKET_SIZE = 4;
+
+    /**
+     * Dead-end room state
+     */
+    struct Entry
+    {
+        /**
+         * Full hash of the room state
+         */
+        uint64_t hash;
+
+        /**
+         * Number of search nodes it took to prove that the room state is a dead end
+         */
+        uint32_t numSubtreeNodes;
+
+        /**
+         * Generation the entry was stored in. Entries from older generations are empty
+         */
+        uint32_t generation;
+    };
+
+    /**
+     * Group of entries sharing the same table slot, sized to fit a cache line
+     */
+    struct alignas(64) Bucket
+    {
+        /**
+         * Entries in the bucket
+         */
+        Entry entries[BUCKET_SIZE];
+    };
+
+private:
+    /**
+     * Buckets of the table. The number of buckets is a power of two
+     */
+    std::vector<Bucket> m_buckets;
+
+    /**
+     * Current generation. Clearing the table starts a new generation
+     */
+    uint32_t m_generation;
+
+    /**
+     * Number of lookups since the table was last cleared
+     */
+    uint64_t m_numProbes;
+
+    /**
+     * Number of lookups that found their room state since the table was last cleared
+     */
+    uint64_t m_numHits;
+
+    /**
+     * Number of room states stored since the table was last cleared
+     */
+    uint64_t m_numStores;
+
+    /**
+     * Number of stored room states that replaced another one since the table was last cleared
+     */
+    uint64_t m_numReplacements;
+
+    /**
+     * Number of entries in use
+     */
+    uint64_t m_numUsedEntries;
+
+public:
+    /**
+     * @brief Constructor. The table is disabled until its size is set.
+     */
+    TranspositionTable();
+
+    /**
+     * @brief Destructor
+     */
+    ~TranspositionTable();
+
+    /**
+     * @brief Sets the memory budget of the table, and clears it. The number of buckets
+     * is rounded down to a power of two so the table never exceeds the budget.
+     * @param[in] numBytes Memory budget in bytes. 0 to disable the table
+     */
+    void SetSize(const size_t& numBytes);
+
+    /**
+     * @brief Gets the memory used by the table
+     * @return Memory used in bytes
+     */
+    size_t GetSize() const;
+
+    /**
+     * @brief Queries whether the table has any entries to store room states in
+     * @return Returns true if the table is enabled
+     */
+    bool IsEnabled() const;
+
+    /**
+     * @brief Removes all the room states from the table, and resets the statistics
+     */
+    void Clear();
+
+    /**
+     * @brief Looks up the specified room state
+     * @param[in] hash Hash of the room state
+     * @return Returns true if the room state is known to be a dead end. Returns false otherwise
+     */
+    bool Contains(const uint64_t& hash);
+
+    /**
+     * @brief Stores the specified room state as a dead end
+     * @param[in] hash Hash of the room state
+     * @param[in] numSubtreeNodes Number of search nodes it took to prove that the room
+     * state is a dead end, used to decide which entries to keep
+     */
+    void Store(const uint64_t& hash, const uint64_t& numSubtreeNodes);
+
+    /**
+     * @brief Gets the number of lookups since the table was last cleared
+     * @return Number of lookups
+     */
+    uint64_t GetNumProbes() const;
+
+    /**
+     * @brief Gets the number of lookups that found their room state since the table was last cleared
+     * @return Number of hits
+     */
+    uint64_t GetNumHits() const;
+
+    /**
+     * @brief Gets the ratio of lookups that found their room state since the table was last cleared
+     * @return Hit rate between 0 and 1. Returns 0 if there were no lookups
+     */
+    double GetHitRate() const;
+
+    /**
+     * @brief Gets the number of room states stored since the table was last cleared
+     * @return Number of stored room states
+     */
+    uint64_t GetNumStores() const;
+
+    /**
+     * @brief Gets the number of stored room states that replaced another one since the
+     * table was last cleared
+     * @return Number of replacements
+     */
+    uint64_t GetNumReplacements() const;
+
+    /**
+     * @brief Gets the ratio of entries in use
+     * @return Occupancy between 0 and 1. Returns 0 if the table is disabled
+     */
+    double GetOccupancy() const;
+
+private:
+    /**
+     * @brief Gets the bucket the specified room state belongs to
+     * @param[in] hash Hash of the room state
+     * @return Bucket
+     */
+    Bucket& GetBucket(const uint64_t& hash);
+};
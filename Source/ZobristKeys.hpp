@@ -0,0 +1,88 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Generates a table of pseudo-random keys with the SplitMix64 generator
+ * @param[in] seed Seed of the generator
+ * @return Table of keys
+ */
+template <size_t NumKeys>
+constexpr std::array<uint64_t, NumKeys> GenerateZobristKeys(const uint64_t& seed)
+{
+    std::array<uint64_t, NumKeys> keys {};
+    uint64_t state = seed;
+    for (uint64_t &key : keys)
+    {
+        state += 0x9E3779B97F4A7C15ULL;
+        uint64_t value = state;
+        value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+        key = value ^ (value >> 31);
+    }
+
+    return keys;
+}
+
+/**
+ * Random keys used to hash a room state by XOR-ing together one key for each
+ * feature of the state (Zobrist hashing). Since XOR is its own inverse, the hash
+ * can be updated incrementally as cells are visited and unvisited.
+ */
+class ZobristKeys
+{
+public:
+    /**
+     * Maximum number of cells a room can have to be hashed
+     */
+    static constexpr int32_t MAX_CELLS = 1024;
+
+private:
+    /**
+     * Keys for the player standing on each cell
+     */
+    static constexpr std::array<uint64_t, MAX_CELLS> POSITION_KEYS = GenerateZobristKeys<MAX_CELLS>(1);
+
+    /**
+     * Keys for each cell being visited
+     */
+    static constexpr std::array<uint64_t, MAX_CELLS> VISITED_KEYS = GenerateZobristKeys<MAX_CELLS>(2);
+
+    /**
+     * Keys for each door cell being unlocked
+     */
+    static constexpr std::array<uint64_t, MAX_CELLS> UNLOCKED_KEYS = GenerateZobristKeys<MAX_CELLS>(3);
+
+public:
+    /**
+     * @brief Gets the key for the player standing on the specified cell
+     * @param[in] cellIndex Cell index
+     * @return Key
+     */
+    static constexpr uint64_t GetPositionKey(const int32_t& cellIndex)
+    {
+        return POSITION_KEYS[cellIndex];
+    }
+
+    /**
+     * @brief Gets the key for the specified cell being visited
+     * @param[in] cellIndex Cell index
+     * @return Key
+     */
+    static constexpr uint64_t GetVisitedKey(const int32_t& cellIndex)
+    {
+        return VISITED_KEYS[cellIndex];
+    }
+
+    /**
+     * @brief Gets the key for the specified door cell being unlocked
+     * @param[in] cellIndex Cell index
+     * @return Key
+     */
+    static constexpr uint64_t GetUnlockedKey(const int32_t& cellIndex)
+    {
+        return UNLOCKED_KEYS[cellIndex];
+    }
+};
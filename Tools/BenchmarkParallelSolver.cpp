@@ -0,0 +1,196 @@
+#include "Direction.hpp"
+#include "LevelData.hpp"
+#include "ParallelRoomSolver.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#define NUM_GENERATED_ROOMS 8
+#define GENERATED_ROOM_SIZE 30
+#define GENERATED_PATH_COVERAGE 0.8
+#define MAX_NODES_PER_ROOM 1000000
+
+/**
+ * @brief Generates a room whose floors are a random self-avoiding walk that covers
+ * most of a square, with the player starting at one end and the goal at the other.
+ * The walk itself is a solution, but the floors touch each other in many places,
+ * which gives the solver plenty of wrong turns to explore.
+ * @param[in] seed Random seed
+ * @param[in] size Width and height of the room
+ * @return Room in the level file format, as a level with a single room
+ */
+std::string GenerateRoomText(const uint32_t& seed, const int32_t& size)
+{
+    std::mt19937 random(seed);
+    auto isFree = [size](const std::vector<uint8_t>& isTaken, const int32_t& x, const int32_t& y)
+    {
+        return (0 <= x) && (x < size) && (0 <= y) && (y < size) && (isTaken[y * size + x] == 0);
+    };
+
+    std::vector<std::pair<int32_t, int32_t>> bestPath;
+    int32_t targetLength = static_cast<int32_t>(GENERATED_PATH_COVERAGE * size * size);
+    for (int32_t attempt = 0; (attempt < 1000) && (static_cast<int32_t>(bestPath.size()) < targetLength); ++attempt)
+    {
+        std::vector<uint8_t> isTaken(size * size, 0);
+        int32_t x = static_cast<int32_t>(random() % size);
+        int32_t y = static_cast<int32_t>(random() % size);
+        std::vector<std::pair<int32_t, int32_t>> path = { { x, y } };
+        isTaken[y * size + x] = 1;
+        while (true)
+        {
+            // Prefer the neighbors with the fewest ways out, so the walk stays compact
+            std::vector<std::pair<int32_t, int32_t>> candidates;
+            int32_t fewestWaysOut = 5;
+            for (Direction direction : ALL_DIRECTIONS)
+            {
+                int32_t nextX = x + GetDirectionX(direction);
+                int32_t nextY = y + GetDirectionY(direction);
+                if (!isFree(isTaken, nextX, nextY))
+                {
+                    continue;
+                }
+
+                int32_t numWaysOut = 0;
+                for (Direction nextDirection : ALL_DIRECTIONS)
+                {
+                    numWaysOut += isFree(isTaken, nextX + GetDirectionX(nextDirection), nextY + GetDirectionY(nextDirection)) ? 1 : 0;
+                }
+                if ((numWaysOut < fewestWaysOut) || (random() % 10 < 3))
+                {
+                    fewestWaysOut = std::min(fewestWaysOut, numWaysOut);
+                    candidates.insert(candidates.begin(), { nextX, nextY });
+                }
+                else
+                {
+                    candidates.push_back({ nextX, nextY });
+                }
+            }
+            if (candidates.empty())
+            {
+                break;
+            }
+
+            x = candidates.front().first;
+            y = candidates.front().second;
+            path.push_back({ x, y });
+            isTaken[y * size + x] = 1;
+        }
+
+        if (path.size() > bestPath.size())
+        {
+            bestPath = path;
+        }
+    }
+
+    std::vector<std::string> rows(size, std::string(size, '#'));
+    for (const auto &cell : bestPath)
+    {
+        rows[cell.second][cell.first] = '.';
+    }
+    rows[bestPath.back().second][bestPath.back().first] = '@';
+
+    std::ostringstream text;
+    text << "0\n1\n" << size << " " << size << "\n";
+    for (const std::string &row : rows)
+    {
+        text << row << "\n";
+    }
+    text << bestPath.front().first << " " << bestPath.front().second << "\n";
+
+    return text.str();
+}
+
+/**
+ * Solves a corpus of rooms with the parallel solver using an increasing number of
+ * threads, and reports the speedup over a single thread.
+ *
+ * Usage: BenchmarkParallelSolver [level file...]
+ *
+ * Without any level files, a corpus of GENERATED_ROOM_SIZE x GENERATED_ROOM_SIZE
+ * rooms is generated, the size of room the parallel solver is meant for.
+ */
+int main(int argc, char *argv[])
+{
+    std::vector<RoomData> rooms;
+    if (argc >= 2)
+    {
+        for (int32_t i = 1; i < argc; ++i)
+        {
+            LevelData levelData;
+            if (!levelData.LoadFromFile(argv[i]))
+            {
+                std::cerr << "Failed to load level file " << argv[i] << "!" << std::endl;
+                return 1;
+            }
+            rooms.insert(rooms.end(), levelData.rooms.begin(), levelData.rooms.end());
+        }
+    }
+    else
+    {
+        for (int32_t i = 0; i < NUM_GENERATED_ROOMS; ++i)
+        {
+            std::istringstream text(GenerateRoomText(static_cast<uint32_t>(i + 1), GENERATED_ROOM_SIZE));
+
+            LevelData levelData;
+            levelData.LoadFromStream(text);
+            rooms.insert(rooms.end(), levelData.rooms.begin(), levelData.rooms.end());
+        }
+    }
+
+    int32_t maxThreads = std::max(1, static_cast<int32_t>(std::thread::hardware_concurrency()));
+    std::vector<int32_t> threadCounts;
+    for (int32_t numThreads = 1; numThreads < maxThreads; numThreads *= 2)
+    {
+        threadCounts.push_back(numThreads);
+    }
+    threadCounts.push_back(maxThreads);
+
+    std::cout << rooms.size() << " rooms, " << maxThreads << " hardware threads" << std::endl;
+    std::cout << std::setw(8) << "Threads" << std::setw(12) << "Time (ms)" << std::setw(10) << "Speedup"
+        << std::setw(8) << "Solved" << std::setw(12) << "Nodes" << std::setw(10) << "Steals" << std::endl;
+
+    double singleThreadMs = 0.0;
+    for (int32_t numThreads : threadCounts)
+    {
+        ParallelRoomSolver solver;
+        solver.SetNumThreads(numThreads);
+        solver.SetMaxNodes(MAX_NODES_PER_ROOM);
+
+        int32_t numSolvedRooms = 0;
+        uint64_t numNodesExpanded = 0;
+        uint64_t numTasksStolen = 0;
+        auto startTime = std::chrono::steady_clock::now();
+        for (const RoomData &room : rooms)
+        {
+            std::vector<Direction> moves;
+            numSolvedRooms += solver.Solve(room, moves) ? 1 : 0;
+            numNodesExpanded += solver.GetNumNodesExpanded();
+            numTasksStolen += solver.GetNumTasksStolen();
+        }
+        auto endTime = std::chrono::steady_clock::now();
+
+        double elapsedMs = std::chrono::duration<double, std::milli>(endTime - startTime).count();
+        if (numThreads == 1)
+        {
+            singleThreadMs = elapsedMs;
+        }
+
+        std::cout << std::setw(8) << numThreads
+            << std::setw(12) << std::fixed << std::setprecision(1) << elapsedMs
+            << std::setw(9) << std::setprecision(2) << (singleThreadMs / elapsedMs) << "x"
+            << std::setw(8) << numSolvedRooms
+            << std::setw(12) << numNodesExpanded
+            << std::setw(10) << numTasksStolen << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,164 @@
+#include "CellPlaneGrid.hpp"
+#include "CellScanKernels.hpp"
+#include "LevelData.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#define CELLS_PER_MEASUREMENT 500000000LL
+
+/**
+ * @brief Generates a square room with randomly placed walls, ice, switches and doors,
+ * a single goal near the bottom-right corner, and every floor cell visited except one
+ * near the goal. The scans then have to go through almost the entire room.
+ * @param[in] size Width and height of the room
+ * @param[out] grid Cell grid
+ */
+void GenerateRoom(const int32_t& size, CellPlaneGrid& grid)
+{
+    std::mt19937 random(static_cast<uint32_t>(size));
+    std::uniform_int_distribution<int32_t> distribution(0, 99);
+
+    grid.Resize(size, size);
+    for (int32_t y = 0; y < size; ++y)
+    {
+        for (int32_t x = 0; x < size; ++x)
+        {
+            int32_t roll = distribution(random);
+            CellData cellData;
+            if (roll < 20)
+            {
+                cellData.SetType(CellData::Type::Wall);
+            }
+            else if (roll < 30)
+            {
+                cellData.SetType(CellData::Type::Ice);
+            }
+            else if (roll < 31)
+            {
+                cellData.SetType(CellData::Type::Switch);
+            }
+            else if (roll < 32)
+            {
+                cellData.SetType(CellData::Type::Door);
+            }
+            else
+            {
+                cellData.SetType(CellData::Type::Floor);
+                cellData.SetVisited(true);
+            }
+            grid.Set(x, y, cellData);
+        }
+    }
+
+    CellData goalCell;
+    goalCell.SetType(CellData::Type::Goal);
+    grid.Set(size - 1, size - 1, goalCell);
+
+    CellData unvisitedFloorCell;
+    unvisitedFloorCell.SetType(CellData::Type::Floor);
+    grid.Set(size - 2, size - 1, unvisitedFloorCell);
+}
+
+/**
+ * @brief Runs the specified scan repeatedly and prints its throughput
+ * @param[in] name Name of the scan
+ * @param[in] numCells Number of cells scanned per call
+ * @param[in] scan Scan to run. Returns a value that is accumulated so the calls are not optimized away
+ * @return Accumulated result of all the calls
+ */
+template <typename Func>
+int64_t Measure(const std::string& name, const int32_t& numCells, Func&& scan)
+{
+    int64_t numIterations = CELLS_PER_MEASUREMENT / numCells;
+    int64_t checksum = 0;
+
+    auto startTime = std::chrono::steady_clock::now();
+    for (int64_t i = 0; i < numIterations; ++i)
+    {
+        checksum += scan();
+    }
+    auto endTime = std::chrono::steady_clock::now();
+
+    double elapsedSeconds = std::chrono::duration<double>(endTime - startTime).count();
+    double cellsPerSecond = static_cast<double>(numIterations * numCells) / elapsedSeconds;
+    std::cout << "    " << std::left << std::setw(16) << name << std::right << std::fixed << std::setprecision(1)
+        << std::setw(10) << (cellsPerSecond / 1e9) << " Gcells/s  "
+        << std::setw(10) << (elapsedSeconds * 1e9 / numIterations) << " ns/room" << std::endl;
+
+    return checksum;
+}
+
+/**
+ * Measures the throughput of the room-wide scans on generated 64x64 and 256x256
+ * rooms, using each instruction set supported by the CPU.
+ *
+ * Usage: BenchmarkScans
+ */
+int main()
+{
+    const std::vector<SimdLevel> simdLevels = { SimdLevel::Scalar, SimdLevel::SSE2, SimdLevel::AVX2 };
+    const std::vector<int32_t> roomSizes = { 64, 256 };
+
+    bool isConsistent = true;
+    for (int32_t roomSize : roomSizes)
+    {
+        CellPlaneGrid grid;
+        GenerateRoom(roomSize, grid);
+        CellPlaneGrid scratchGrid = grid;
+        int32_t numCells = roomSize * roomSize;
+
+        std::cout << "Room " << roomSize << "x" << roomSize << std::endl;
+
+        std::vector<int64_t> expectedChecksums;
+        for (SimdLevel simdLevel : simdLevels)
+        {
+            CellScanKernels kernels;
+            if (!kernels.SetSimdLevel(simdLevel))
+            {
+                std::cout << "  " << CellScanKernels::GetSimdLevelName(simdLevel) << ": not supported" << std::endl;
+                continue;
+            }
+
+            std::cout << "  " << CellScanKernels::GetSimdLevelName(simdLevel) << std::endl;
+
+            std::vector<int64_t> checksums;
+            checksums.push_back(Measure("Reset", numCells, [&]()
+            {
+                kernels.ResetVisitedAndStates(scratchGrid);
+                return static_cast<int64_t>(scratchGrid.GetVisitedPlane()[numCells - 1]);
+            }));
+            checksums.push_back(Measure("CountUnvisited", numCells, [&]()
+            {
+                return static_cast<int64_t>(kernels.CountUnvisited(grid, CellData::Type::Floor));
+            }));
+            checksums.push_back(Measure("FindGoal", numCells, [&]()
+            {
+                return static_cast<int64_t>(kernels.FindFirst(grid, CellData::Type::Goal));
+            }));
+            checksums.push_back(Measure("IsComplete", numCells, [&]()
+            {
+                return static_cast<int64_t>(kernels.IsComplete(grid) ? 1 : 0);
+            }));
+
+            if (expectedChecksums.empty())
+            {
+                expectedChecksums = checksums;
+            }
+            else if (checksums != expectedChecksums)
+            {
+                std::cerr << "Results of the " << CellScanKernels::GetSimdLevelName(simdLevel)
+                    << " kernels do not match the scalar kernels!" << std::endl;
+                isConsistent = false;
+            }
+        }
+    }
+
+    return isConsistent ? 0 : 1;
+}
@@ -0,0 +1,97 @@
+#include "LevelData.hpp"
+#include "RoomSolver.hpp"
+#include "SolutionCounter.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#define DEFAULT_MAX_SOLUTIONS_PER_ROOM 1000
+#define DEFAULT_MAX_NODES_PER_ROOM 1000000
+
+/**
+ * Counts the distinct move sequences that solve each room in a level file, to
+ * check that every room has a unique solution.
+ *
+ * Usage: CountSolutions <level file> [max solutions per room] [max nodes per room]
+ *
+ * The limits only apply to rooms that have to be counted by enumeration, i.e.
+ * rooms with ice, switches, doors or empty cells. They default to 1000 solutions
+ * and 1000000 nodes per room, and 0 means no limit. A count that hit a limit is
+ * printed as a lower bound. When it hit a limit before finding any solution, the
+ * room is searched with the solver too, so a solvable room counts at least 1.
+ */
+int main(int argc, char *argv[])
+{
+    if (argc < 2)
+    {
+        std::cerr << "Usage: " << argv[0] << " <level file> [max solutions per room] [max nodes per room]" << std::endl;
+        return 1;
+    }
+
+    LevelData levelData;
+    if (!levelData.LoadFromFile(argv[1]))
+    {
+        std::cerr << "Failed to load level file " << argv[1] << "!" << std::endl;
+        return 1;
+    }
+
+    uint64_t maxNodes = DEFAULT_MAX_NODES_PER_ROOM;
+    if (argc >= 4)
+    {
+        maxNodes = std::strtoull(argv[3], nullptr, 10);
+    }
+
+    SolutionCounter counter;
+    counter.SetMaxSolutions(DEFAULT_MAX_SOLUTIONS_PER_ROOM);
+    counter.SetMaxNodes(maxNodes);
+    if (argc >= 3)
+    {
+        counter.SetMaxSolutions(std::strtoull(argv[2], nullptr, 10));
+    }
+
+    RoomSolver solver;
+    solver.SetMaxNodes(maxNodes);
+    std::vector<Direction> moves;
+    int32_t numNonUniqueRooms = 0;
+    for (size_t i = 0; i < levelData.rooms.size(); ++i)
+    {
+        auto startTime = std::chrono::steady_clock::now();
+        uint64_t numSolutions = counter.Count(levelData.rooms[i]);
+        // The enumeration gives up long before the solver does on rooms with many
+        // dead ends, so an inexact count of 0 does not mean the room is unsolvable
+        bool hasSolverFallback = (numSolutions == 0) && !counter.IsExact();
+        if (hasSolverFallback && solver.Solve(levelData.rooms[i], moves))
+        {
+            numSolutions = 1;
+        }
+        auto endTime = std::chrono::steady_clock::now();
+        double elapsedMs = std::chrono::duration<double, std::milli>(endTime - startTime).count();
+
+        std::cout << "Room " << (i + 1) << ": " << (counter.IsExact() ? "" : "at least ") << numSolutions
+            << ((numSolutions == 1) ? " solution" : " solutions");
+        if (counter.HasUsedFrontier())
+        {
+            std::cout << " (frontier sweep, " << counter.GetMaxNumFrontierStates() << " states, ";
+        }
+        else
+        {
+            std::cout << " (enumeration, " << counter.GetNumNodesExpanded() << " nodes, ";
+        }
+        std::cout << elapsedMs << " ms";
+        if (hasSolverFallback)
+        {
+            std::cout << ", solver " << solver.GetNumNodesExpanded() << " nodes";
+        }
+        std::cout << ")" << std::endl;
+
+        if ((numSolutions != 1) || !counter.IsExact())
+        {
+            ++numNonUniqueRooms;
+        }
+    }
+
+    return (numNonUniqueRooms == 0) ? 0 : 1;
+}
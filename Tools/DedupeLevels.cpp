@@ -0,0 +1,91 @@
+#include "LevelData.hpp"
+#include "RoomSymmetry.hpp"
+
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * Finds rooms in one or more level files that are rotations or reflections of each
+ * other (up to renaming the switch letters), and optionally writes a level file
+ * with only the first room of each symmetry class.
+ *
+ * Usage: DedupeLevels [-o <output level file>] <level file> ...
+ *
+ * The output level file takes its description from the first level file. Returns
+ * 1 if any duplicates were found, so it can be used as a check on level packs.
+ */
+int main(int argc, char *argv[])
+{
+    std::string outputFilePath;
+    std::vector<std::string> filePaths;
+    for (int32_t i = 1; i < argc; ++i)
+    {
+        std::string argument = argv[i];
+        if ((argument == "-o") && (i + 1 < argc))
+        {
+            outputFilePath = argv[++i];
+        }
+        else
+        {
+            filePaths.push_back(argument);
+        }
+    }
+
+    if (filePaths.empty())
+    {
+        std::cerr << "Usage: " << argv[0] << " [-o <output level file>] <level file> ..." << std::endl;
+        return 1;
+    }
+
+    LevelData uniqueLevel;
+    std::unordered_map<std::string, std::pair<size_t, size_t>> roomsByKey;
+    int32_t numRooms = 0;
+    int32_t numDuplicates = 0;
+    for (size_t i = 0; i < filePaths.size(); ++i)
+    {
+        LevelData levelData;
+        if (!levelData.LoadFromFile(filePaths[i]))
+        {
+            std::cerr << "Failed to load level file " << filePaths[i] << "!" << std::endl;
+            return 1;
+        }
+        if (i == 0)
+        {
+            uniqueLevel.descriptionLines = levelData.descriptionLines;
+        }
+
+        for (size_t j = 0; j < levelData.rooms.size(); ++j)
+        {
+            ++numRooms;
+            std::string key = RoomSymmetry::GetCanonicalKey(levelData.rooms[j]);
+            auto [it, isNewClass] = roomsByKey.emplace(key, std::make_pair(i, j));
+            if (isNewClass)
+            {
+                uniqueLevel.rooms.push_back(levelData.rooms[j]);
+                continue;
+            }
+
+            ++numDuplicates;
+            std::cout << filePaths[i] << " room " << (j + 1) << " duplicates "
+                << filePaths[it->second.first] << " room " << (it->second.second + 1)
+                << " (hash " << std::hex << std::setw(16) << std::setfill('0') << RoomSymmetry::HashKey(key)
+                << std::dec << std::setfill(' ') << ")" << std::endl;
+        }
+    }
+
+    std::cout << numRooms << " rooms, " << roomsByKey.size() << " unique up to rotation and reflection, "
+        << numDuplicates << " duplicates" << std::endl;
+
+    if (!outputFilePath.empty() && !uniqueLevel.SaveToFile(outputFilePath))
+    {
+        std::cerr << "Failed to write level file " << outputFilePath << "!" << std::endl;
+        return 1;
+    }
+
+    return (numDuplicates == 0) ? 0 : 1;
+}
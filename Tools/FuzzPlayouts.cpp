@@ -0,0 +1,931 @@
+#include "BacktrackingRoomSolver.hpp"
+#include "BidirectionalRoomSolver.hpp"
+#include "Constants.hpp"
+#include "Direction.hpp"
+#include "HeldKarpRoomSolver.hpp"
+#include "LevelData.hpp"
+#include "ParallelRoomSolver.hpp"
+#include "RoomSimulator.hpp"
+#include "RoomSolver.hpp"
+#include "SolutionCounter.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#define DEFAULT_LEVELS_DIRECTORY "Resources/Levels"
+#define DEFAULT_PLAYOUTS_PER_ROOM 500
+#define MAX_STEPS_PER_PLAYOUT 200
+#define BENCHMARK_MOVES_PER_ROOM 2000000
+#define MAX_REPORTED_FAILURES 10
+#define MAX_REFERENCE_SOLUTIONS 1000
+#define REGRESSION_LEVEL_NAME "regression level"
+
+// Rooms that once broke the simulator and the solvers, in the level file format.
+// In each of them the last floor is visited before the first move, which unlocks
+// the goal on its first step over ice. In the last two, the ice cell that move
+// stops on cannot be stopped on again until another cell is visited
+#define REGRESSION_LEVEL \
+    "1\n" \
+    "The first step of a slide unlocks the goal\n" \
+    "6\n" \
+    "4 2\n" \
+    ".*@A\n" \
+    "#*a*\n" \
+    "0 0\n" \
+    "3 2\n" \
+    "**@\n" \
+    "Bb*\n" \
+    "0 0\n" \
+    "3 2\n" \
+    "@*.\n" \
+    "A*a\n" \
+    "2 0\n" \
+    "2 2\n" \
+    "#@\n" \
+    "**\n" \
+    "1 1\n" \
+    "2 4\n" \
+    "@*\n" \
+    "B*\n" \
+    "b.\n" \
+    "aA\n" \
+    "1 2\n" \
+    "2 3\n" \
+    "*a\n" \
+    "*@\n" \
+    "#A\n" \
+    "0 1\n"
+
+// Rooms RoomSolver finds easy, which the bidirectional solver once took hundreds
+// of thousands of nodes or more on: room 3 of level 4, and room 1 of level 1 as
+// generated with -w 16 -h 12 -d hard -s 3. They are too large for the reference
+// model to count their solutions, so the bidirectional solver is only checked to
+// solve them within as many nodes as RoomSolver
+#define BIDIRECTIONAL_REGRESSION_LEVEL_NAME "bidirectional regression level"
+#define BIDIRECTIONAL_REGRESSION_LEVEL \
+    "1\n" \
+    "The halves only meet near the end\n" \
+    "2\n" \
+    "20 10\n" \
+    "####################\n" \
+    "#...********....C.b#\n" \
+    "#...********....#..#\n" \
+    "#***...*****....#A##\n" \
+    "#***.c.*****.......#\n" \
+    "#***...**a**.......#\n" \
+    "#***...*****...e#..#\n" \
+    "#**#####........#..#\n" \
+    "#**..d.B........D.E@\n" \
+    "####################\n" \
+    "1 1\n" \
+    "16 12\n" \
+    "################\n" \
+    "#.....**.B..c..#\n" \
+    "#........*..*..#\n" \
+    "#.*.##.a.......#\n" \
+    "#...#.....*....#\n" \
+    "#...#..........#\n" \
+    "#*...b...*.*...#\n" \
+    "#.*.*..........#\n" \
+    "#..*...#*##...*#\n" \
+    "#....**###@....#\n" \
+    "#.*....###C.A..#\n" \
+    "################\n" \
+    "4 6\n"
+
+/**
+ * Reference model of a room being played, kept next to the simulator and updated
+ * by the rules written out one cell at a time instead of by the simulator's code.
+ */
+struct PlayoutModel
+{
+    /**
+     * Cells of the room
+     */
+    BorderedGrid<CellData> cells;
+
+    /**
+     * Player's X-position
+     */
+    int32_t playerX;
+
+    /**
+     * Player's Y-position
+     */
+    int32_t playerY;
+
+    /**
+     * Flag indicating whether the player has entered the unlocked goal
+     */
+    bool hasReachedGoal;
+};
+
+/**
+ * @brief Queries whether the player can enter the cell at the specified position
+ * of a reference model
+ * @param[in] cells Cells of the reference model
+ * @param[in] x X-coordinate
+ * @param[in] y Y-coordinate
+ * @return Returns true if the cell is in the grid, not a wall, not visited, and not a locked door
+ */
+bool IsReferenceTraversible(const BorderedGrid<CellData>& cells, const int32_t& x, const int32_t& y)
+{
+    const CellData *cellData = cells.Get(x, y);
+    return (cellData != nullptr)
+        && (cellData->GetType() != CellData::Type::Wall)
+        && !cellData->IsVisited()
+        && ((cellData->GetType() != CellData::Type::Door) || (cellData->GetState() == Constants::DOOR_UNLOCKED_STATE));
+}
+
+/**
+ * @brief Moves the player of a reference model by a single cell, the way the game
+ * scene used to move the player one step at a time, checking whether the goal gets
+ * unlocked after every step
+ * @param[in,out] model Reference model
+ * @param[in] roomData Room the model was copied from, for its switch-door mappings and goal
+ * @param[in] direction Direction of the step
+ * @return Returns true if the player moved. Returns false otherwise
+ */
+bool MakeReferenceStep(PlayoutModel& model, const RoomData& roomData, const Direction& direction)
+{
+    int32_t x = model.playerX + GetDirectionX(direction);
+    int32_t y = model.playerY + GetDirectionY(direction);
+    if (!IsReferenceTraversible(model.cells, x, y))
+    {
+        return false;
+    }
+
+    model.playerX = x;
+    model.playerY = y;
+    CellData &cellData = *model.cells.Get(x, y);
+    if (cellData.GetType() != CellData::Type::Ice)
+    {
+        cellData.SetVisited(true);
+    }
+
+    CellData *goalCell = model.cells.Get(roomData.goalX, roomData.goalY);
+    if (cellData.GetType() == CellData::Type::Switch)
+    {
+        int32_t switchId = roomData.GetSwitchIdFromSwitchPosition(x, y);
+        if (switchId != -1)
+        {
+            cellData.SetState(Constants::SWITCH_PRESSED_STATE);
+
+            const SwitchDoorMapping &mapping = roomData.switchDoorMappings[switchId - 'a'];
+            CellData *doorCell = model.cells.Get(mapping.doorX, mapping.doorY);
+            if (doorCell != nullptr)
+            {
+                doorCell->SetState(Constants::DOOR_UNLOCKED_STATE);
+            }
+        }
+    }
+    else if (cellData.GetType() == CellData::Type::Goal)
+    {
+        model.hasReachedGoal = (cellData.GetState() == Constants::GOAL_UNLOCKED_STATE);
+    }
+
+    bool hasUnvisitedFloors = false;
+    model.cells.ForEach([&hasUnvisitedFloors](const int32_t&, const int32_t&, const CellData& cell)
+    {
+        hasUnvisitedFloors = hasUnvisitedFloors || ((cell.GetType() == CellData::Type::Floor) && !cell.IsVisited());
+    });
+    if ((goalCell != nullptr) && !hasUnvisitedFloors)
+    {
+        goalCell->SetState(Constants::GOAL_UNLOCKED_STATE);
+    }
+
+    return true;
+}
+
+/**
+ * @brief Makes a move on a reference model, stepping one cell at a time and going
+ * on stepping while the player stands on ice
+ * @param[in,out] model Reference model
+ * @param[in] roomData Room the model was copied from, for its switch-door mappings and goal
+ * @param[in] direction Direction of the move
+ * @return Returns true if the player moved. Returns false otherwise
+ */
+bool MakeReferenceMove(PlayoutModel& model, const RoomData& roomData, const Direction& direction)
+{
+    if (model.hasReachedGoal || !MakeReferenceStep(model, roomData, direction))
+    {
+        return false;
+    }
+
+    while ((model.cells.Get(model.playerX, model.playerY)->GetType() == CellData::Type::Ice)
+        && MakeReferenceStep(model, roomData, direction))
+    {
+    }
+
+    return true;
+}
+
+/**
+ * @brief Compares the room being played with a reference model
+ * @param[in] simulator Room simulator
+ * @param[in] model Reference model
+ * @param[out] error Description of the first difference
+ * @return Returns true if every cell, the player's position and whether the goal
+ * is reached all match. Returns false otherwise
+ */
+bool CompareWithModel(const RoomSimulator& simulator, const PlayoutModel& model, std::string& error)
+{
+    if ((simulator.GetPlayerX() != model.playerX) || (simulator.GetPlayerY() != model.playerY))
+    {
+        error = "the player is at (" + std::to_string(simulator.GetPlayerX()) + ", " + std::to_string(simulator.GetPlayerY())
+            + ") instead of (" + std::to_string(model.playerX) + ", " + std::to_string(model.playerY) + ")";
+        return false;
+    }
+    if (simulator.HasReachedGoal() != model.hasReachedGoal)
+    {
+        error = model.hasReachedGoal ? "entering the unlocked goal did not complete the room" : "the goal is reached too early";
+        return false;
+    }
+
+    RoomData &roomData = *simulator.GetRoomData();
+    int32_t mismatchX = -1;
+    int32_t mismatchY = -1;
+    model.cells.ForEach([&roomData, &mismatchX, &mismatchY](const int32_t& x, const int32_t& y, const CellData& modelCell)
+    {
+        const CellData *cellData = roomData.cells.Get(x, y);
+        if ((mismatchX == -1) && (cellData != nullptr)
+            && ((cellData->GetType() != modelCell.GetType()) || (cellData->IsVisited() != modelCell.IsVisited())
+                || (cellData->GetState() != modelCell.GetState())))
+        {
+            mismatchX = x;
+            mismatchY = y;
+        }
+    });
+    if (mismatchX != -1)
+    {
+        error = "cell (" + std::to_string(mismatchX) + ", " + std::to_string(mismatchY) + ") differs from the reference";
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Checks the rules that must hold after every move
+ * @param[in] simulator Room simulator
+ * @param[in] numEntries Number of moves of the playout that ended on each cell
+ * @param[out] error Description of the first broken rule
+ * @return Returns true if every rule holds. Returns false otherwise
+ */
+bool CheckInvariants(const RoomSimulator& simulator, const std::vector<int32_t>& numEntries, std::string& error)
+{
+    RoomData &roomData = *simulator.GetRoomData();
+    int32_t startIndex = roomData.cells.GetIndex(roomData.playerStartX, roomData.playerStartY);
+    int32_t numUnvisitedFloors = 0;
+    for (int32_t y = 0; y < roomData.cells.GetHeight(); ++y)
+    {
+        for (int32_t x = 0; x < roomData.cells.GetWidth(); ++x)
+        {
+            int32_t cellIndex = roomData.cells.GetIndex(x, y);
+            const CellData &cellData = roomData.cells.GetAt(cellIndex);
+            if (cellData.GetType() == CellData::Type::Floor)
+            {
+                // The start floor is visited on reset, so entering it at all is a second visit
+                int32_t numVisits = numEntries[cellIndex] + ((cellIndex == startIndex) ? 1 : 0);
+                if (numVisits > 1)
+                {
+                    error = "floor (" + std::to_string(x) + ", " + std::to_string(y) + ") was visited twice";
+                    return false;
+                }
+                if (cellData.IsVisited() != (numVisits == 1))
+                {
+                    error = "floor (" + std::to_string(x) + ", " + std::to_string(y) + ") has the wrong visited flag";
+                    return false;
+                }
+                numUnvisitedFloors += cellData.IsVisited() ? 0 : 1;
+            }
+            else if ((cellData.GetType() == CellData::Type::Door) && (cellData.GetState() == Constants::DOOR_UNLOCKED_STATE))
+            {
+                SwitchDoorMapping *mapping = roomData.GetSwitchDoorMapping(roomData.GetSwitchIdFromDoorPosition(x, y));
+                const CellData *switchCell = (mapping != nullptr) ? roomData.cells.Get(mapping->switchX, mapping->switchY) : nullptr;
+                if ((switchCell == nullptr) || !switchCell->IsVisited() || (switchCell->GetState() != Constants::SWITCH_PRESSED_STATE))
+                {
+                    error = "door (" + std::to_string(x) + ", " + std::to_string(y) + ") is open before its switch is pressed";
+                    return false;
+                }
+            }
+        }
+    }
+
+    if (numUnvisitedFloors != roomData.numUnvisitedFloors)
+    {
+        error = "the room counts " + std::to_string(roomData.numUnvisitedFloors) + " unvisited floors instead of "
+            + std::to_string(numUnvisitedFloors);
+        return false;
+    }
+    if (roomData.IsGoalUnlocked() && (numUnvisitedFloors > 0))
+    {
+        error = "the goal is unlocked with " + std::to_string(numUnvisitedFloors) + " floors unvisited";
+        return false;
+    }
+
+    // The goal only unlocks on a move, so a room whose floors are all visited
+    // right after a reset still has it locked until the first move
+    if ((simulator.GetNumMoves() > 0) && roomData.IsComplete() && !roomData.IsGoalUnlocked())
+    {
+        error = "the goal is still locked with every floor visited";
+        return false;
+    }
+    if (simulator.HasReachedGoal() && (simulator.GetPlayerCellIndex() != roomData.cells.GetIndex(roomData.goalX, roomData.goalY)))
+    {
+        error = "the goal is reached with the player elsewhere";
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Picks a move for an adversarial playout: a move that ends on the goal,
+ * a switch, a door or ice if there is one, and otherwise a blocked move, to poke
+ * at the cases the rules have to get right
+ * @param[in] simulator Room simulator
+ * @param[in] random Random number generator
+ * @return Direction of the move
+ */
+Direction PickAdversarialMove(const RoomSimulator& simulator, std::mt19937_64& random)
+{
+    RoomData &roomData = *simulator.GetRoomData();
+    std::vector<Direction> specialMoves;
+    std::vector<Direction> blockedMoves;
+    for (Direction direction : ALL_DIRECTIONS)
+    {
+        SlideData slide = simulator.GetSlide(direction);
+        CellData::Type endType = roomData.cells.GetAt(slide.endCellIndex).GetType();
+        if (slide.length == 0)
+        {
+            blockedMoves.push_back(direction);
+        }
+        else if ((endType != CellData::Type::Floor) || (slide.length > 1))
+        {
+            specialMoves.push_back(direction);
+        }
+    }
+
+    if (!specialMoves.empty() && (random() % 4 != 0))
+    {
+        return specialMoves[random() % specialMoves.size()];
+    }
+    if (!blockedMoves.empty() && (random() % 2 == 0))
+    {
+        return blockedMoves[random() % blockedMoves.size()];
+    }
+
+    return ALL_DIRECTIONS[random() % ALL_DIRECTIONS.size()];
+}
+
+/**
+ * @brief Plays random playouts of a room, checking every move, undo and redo
+ * against a reference model of the room, and the rules after each of them
+ * @param[in] roomData Room data
+ * @param[in] initialCells Cells of the room as loaded
+ * @param[in] numPlayouts Number of playouts. Every other playout is adversarial
+ * @param[in] random Random number generator
+ * @param[out] numMovesChecked Number of moves, undos and redos checked
+ * @param[out] error Description of the first failure, with the steps that led to it
+ * @return Returns true if every check passed. Returns false otherwise
+ */
+bool FuzzRoom(
+    RoomData& roomData,
+    const BorderedGrid<CellData>& initialCells,
+    const int32_t& numPlayouts,
+    std::mt19937_64& random,
+    uint64_t& numMovesChecked,
+    std::string& error)
+{
+    RoomSimulator simulator;
+    PlayoutModel model;
+    std::vector<PlayoutModel> previousModels;
+    std::vector<Direction> directions;
+    std::vector<Direction> undoneDirections;
+    std::vector<int32_t> entries;
+    std::vector<int32_t> numEntries;
+    std::string steps;
+    for (int32_t playout = 0; playout < numPlayouts; ++playout)
+    {
+        bool isAdversarial = (playout % 2 == 1);
+        simulator.Reset(&roomData);
+        model.cells = initialCells;
+        model.playerX = roomData.playerStartX;
+        model.playerY = roomData.playerStartY;
+        model.hasReachedGoal = false;
+        previousModels.clear();
+        directions.clear();
+        undoneDirections.clear();
+        entries.clear();
+        numEntries.assign(roomData.cells.GetBufferSize(), 0);
+        steps.clear();
+
+        for (int32_t step = 0; step < MAX_STEPS_PER_PLAYOUT; ++step)
+        {
+            ++numMovesChecked;
+            uint64_t roll = random() % 100;
+            Direction direction = Direction::Up;
+            bool isMoveMade = false;
+            bool hasMoved = false;
+            if (roll < (isAdversarial ? 15u : 8u))
+            {
+                // Undo, which has to restore the room exactly as it was before the move
+                steps.push_back('z');
+                bool hasUndone = simulator.UndoMove();
+                if (hasUndone != !previousModels.empty())
+                {
+                    error = "undo did not match the number of moves made";
+                    break;
+                }
+                if (hasUndone)
+                {
+                    model = previousModels.back();
+                    previousModels.pop_back();
+                    undoneDirections.push_back(directions.back());
+                    directions.pop_back();
+                    if (entries.back() != -1)
+                    {
+                        --numEntries[entries.back()];
+                    }
+                    entries.pop_back();
+                }
+            }
+            else if (roll < (isAdversarial ? 25u : 12u))
+            {
+                // Redo, which makes the undone move again
+                steps.push_back('y');
+                hasMoved = simulator.RedoMove();
+                if (hasMoved != !undoneDirections.empty())
+                {
+                    error = "redo did not match the number of undone moves";
+                    break;
+                }
+                if (hasMoved)
+                {
+                    isMoveMade = true;
+                    direction = undoneDirections.back();
+                    undoneDirections.pop_back();
+                }
+            }
+            else
+            {
+                // A blocked move, or any move after reaching the goal, has to leave the room as it is
+                isMoveMade = true;
+                direction = isAdversarial
+                    ? PickAdversarialMove(simulator, random)
+                    : ALL_DIRECTIONS[random() % ALL_DIRECTIONS.size()];
+                steps.push_back(GetDirectionChar(direction));
+                hasMoved = simulator.ApplyMove(direction);
+                if (hasMoved)
+                {
+                    undoneDirections.clear();
+                }
+            }
+
+            if (isMoveMade)
+            {
+                PlayoutModel previousModel = model;
+                if (hasMoved != MakeReferenceMove(model, roomData, direction))
+                {
+                    error = hasMoved ? "a blocked move moved the player" : "a move that should have moved the player was blocked";
+                    break;
+                }
+                if (hasMoved)
+                {
+                    previousModels.push_back(previousModel);
+                    directions.push_back(direction);
+                    int32_t cellIndex = roomData.cells.GetIndex(model.playerX, model.playerY);
+                    bool isOnIce = (roomData.cells.GetAt(cellIndex).GetType() == CellData::Type::Ice);
+                    entries.push_back(isOnIce ? -1 : cellIndex);
+                    if (!isOnIce)
+                    {
+                        ++numEntries[cellIndex];
+                    }
+                }
+            }
+
+            if (!CompareWithModel(simulator, model, error) || !CheckInvariants(simulator, numEntries, error))
+            {
+                break;
+            }
+        }
+
+        if (!error.empty())
+        {
+            error += " after " + steps + " (z is an undo, y is a redo)";
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Measures how fast the simulator plays random moves, undoing every move
+ * back to the start whenever the player gets stuck or reaches the goal
+ * @param[in] roomData Room data
+ * @param[in] numMoves Number of moves to make
+ * @param[in] random Random number generator
+ * @return Elapsed time, in seconds
+ */
+double BenchmarkRoom(RoomData& roomData, const uint64_t& numMoves, std::mt19937_64& random)
+{
+    RoomSimulator simulator;
+    simulator.Reset(&roomData);
+    int32_t numBlockedMoves = 0;
+    auto startTime = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < numMoves; ++i)
+    {
+        if (simulator.ApplyMove(ALL_DIRECTIONS[random() & 0x03]))
+        {
+            numBlockedMoves = 0;
+            if (!simulator.HasReachedGoal())
+            {
+                continue;
+            }
+        }
+        else if (++numBlockedMoves < 8)
+        {
+            continue;
+        }
+
+        while (simulator.UndoMove())
+        {
+        }
+        numBlockedMoves = 0;
+    }
+    auto endTime = std::chrono::steady_clock::now();
+
+    return std::chrono::duration<double>(endTime - startTime).count();
+}
+
+/**
+ * @brief Gets a key of the reference model's room state and player position, for
+ * telling whether a solution repeats a state
+ * @param[in] model Reference model
+ * @return State key
+ */
+std::string GetReferenceStateKey(const PlayoutModel& model)
+{
+    std::string key = std::to_string(model.playerX) + "," + std::to_string(model.playerY) + ":";
+    model.cells.ForEach([&key](const int32_t&, const int32_t&, const CellData& cellData)
+    {
+        key.push_back(cellData.IsVisited() ? 'v' : '-');
+        key.push_back(static_cast<char>('0' + cellData.GetState()));
+    });
+
+    return key;
+}
+
+/**
+ * @brief Counts the move sequences that solve a room on the reference model, by
+ * trying every move from every state. A solution never repeats a state, the same
+ * rule the solution counter follows
+ * @param[in] model Reference model in the state to count from
+ * @param[in] roomData Room data
+ * @param[in,out] pathStateKeys Keys of the states along the current sequence
+ * @param[in,out] numSolutions Number of solutions found, up to MAX_REFERENCE_SOLUTIONS
+ */
+void CountReferenceSolutions(
+    const PlayoutModel& model,
+    const RoomData& roomData,
+    std::vector<std::string>& pathStateKeys,
+    uint64_t& numSolutions)
+{
+    for (Direction direction : ALL_DIRECTIONS)
+    {
+        PlayoutModel nextModel = model;
+        if ((numSolutions >= MAX_REFERENCE_SOLUTIONS) || !MakeReferenceMove(nextModel, roomData, direction))
+        {
+            continue;
+        }
+        if (nextModel.hasReachedGoal)
+        {
+            ++numSolutions;
+            continue;
+        }
+
+        std::string key = GetReferenceStateKey(nextModel);
+        if (std::find(pathStateKeys.begin(), pathStateKeys.end(), key) == pathStateKeys.end())
+        {
+            pathStateKeys.push_back(key);
+            CountReferenceSolutions(nextModel, roomData, pathStateKeys, numSolutions);
+            pathStateKeys.pop_back();
+        }
+    }
+}
+
+/**
+ * @brief Checks a solver's answer against whether the reference model can solve
+ * the room, replaying the solution found on the simulator
+ * @param[in] roomData Room data
+ * @param[in] solverName Name of the solver in the error
+ * @param[in] isSolved Whether the solver found a solution
+ * @param[in] moves Solution found
+ * @param[in] isSolvable Whether the reference model can solve the room
+ * @param[out] error Description of the failure
+ * @return Returns true if the answer is right. Returns false otherwise
+ */
+bool CheckSolverAnswer(
+    RoomData& roomData,
+    const std::string& solverName,
+    const bool& isSolved,
+    const std::vector<Direction>& moves,
+    const bool& isSolvable,
+    std::string& error)
+{
+    if (isSolved != isSolvable)
+    {
+        error = solverName + (isSolvable ? " missed the solution" : " solved an unsolvable room");
+        return false;
+    }
+
+    RoomSimulator simulator;
+    simulator.Reset(&roomData);
+    for (Direction direction : moves)
+    {
+        if (!simulator.ApplyMove(direction))
+        {
+            error = solverName + " found a solution that makes a blocked move";
+            return false;
+        }
+    }
+    if (isSolved && !simulator.HasReachedGoal())
+    {
+        error = solverName + " found a solution that does not reach the goal";
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Checks that the solvers agree with the reference model on whether a room
+ * can be solved, and that their solutions reach the goal
+ * @param[in] roomData Room data
+ * @param[in] initialCells Cells of the room as loaded
+ * @param[out] error Description of the first failure
+ * @return Returns true if every check passed. Returns false otherwise
+ */
+bool CheckSolvers(RoomData& roomData, const BorderedGrid<CellData>& initialCells, std::string& error)
+{
+    roomData.ResetCells();
+    PlayoutModel model = { initialCells, roomData.playerStartX, roomData.playerStartY, false };
+    std::vector<std::string> pathStateKeys = { GetReferenceStateKey(model) };
+    uint64_t numSolutions = 0;
+    CountReferenceSolutions(model, roomData, pathStateKeys, numSolutions);
+    bool isSolvable = (numSolutions > 0);
+
+    SolutionCounter counter;
+    counter.SetMaxSolutions(MAX_REFERENCE_SOLUTIONS);
+    counter.SetMaxNodes(0);
+    uint64_t numCountedSolutions = counter.Count(roomData);
+    if (numCountedSolutions != numSolutions)
+    {
+        error = "the solution counter found " + std::to_string(numCountedSolutions) + " solutions instead of "
+            + std::to_string(numSolutions);
+        return false;
+    }
+
+    std::vector<Direction> moves;
+    RoomSolver solver;
+    bool isSolved = solver.Solve(roomData, moves);
+    if (!CheckSolverAnswer(roomData, "the solver", isSolved, moves, isSolvable, error))
+    {
+        return false;
+    }
+
+    ParallelRoomSolver parallelSolver;
+    isSolved = parallelSolver.Solve(roomData, moves);
+    if (!CheckSolverAnswer(roomData, "the parallel solver", isSolved, moves, isSolvable, error))
+    {
+        return false;
+    }
+
+    BacktrackingRoomSolver backtrackingSolver;
+    isSolved = backtrackingSolver.Solve(roomData, moves);
+    if (!CheckSolverAnswer(roomData, "the backtracking solver", isSolved, moves, isSolvable, error))
+    {
+        return false;
+    }
+
+    BidirectionalRoomSolver bidirectionalSolver;
+    isSolved = bidirectionalSolver.Solve(roomData, moves);
+    if (!CheckSolverAnswer(roomData, "the bidirectional solver", isSolved, moves, isSolvable, error))
+    {
+        return false;
+    }
+
+    HeldKarpRoomSolver exactSolver;
+    isSolved = exactSolver.Solve(roomData, moves);
+    if (!exactSolver.HasExceededCellLimit()
+        && !CheckSolverAnswer(roomData, "the exact solver", isSolved, moves, isSolvable, error))
+    {
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Checks that the bidirectional solver solves every room of a level within
+ * the number of nodes RoomSolver needs to solve it
+ * @param[in] levelData Level data
+ * @param[in] numFailures Number of rooms that failed a check, incremented
+ */
+void CheckBidirectionalRegression(LevelData& levelData, int32_t& numFailures)
+{
+    for (size_t i = 0; i < levelData.rooms.size(); ++i)
+    {
+        RoomData &roomData = levelData.rooms[i];
+        roomData.ResetCells();
+
+        std::vector<Direction> moves;
+        RoomSolver referenceSolver;
+        referenceSolver.Solve(roomData, moves);
+        uint64_t maxNodes = referenceSolver.GetNumNodesExpanded();
+
+        BidirectionalRoomSolver solver;
+        solver.SetMaxNodes(maxNodes);
+        bool isSolved = solver.Solve(roomData, moves);
+
+        std::string error;
+        if (!CheckSolverAnswer(roomData, "the bidirectional solver", isSolved, moves, true, error))
+        {
+            if (solver.HasHitNodeLimit())
+            {
+                error += " within the " + std::to_string(maxNodes) + " nodes RoomSolver needs";
+            }
+            if (++numFailures <= MAX_REPORTED_FAILURES)
+            {
+                std::cout << BIDIRECTIONAL_REGRESSION_LEVEL_NAME << " room " << (i + 1) << ": " << error << std::endl;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Fuzzes every room of a level, then measures how fast the simulator plays it
+ * @param[in] levelData Level data
+ * @param[in] levelName Name of the level in the reports, usually its file path
+ * @param[in] numPlayoutsPerRoom Number of playouts per room
+ * @param[in] isRegression Whether the level holds rooms that once broke the simulator
+ * or the solvers, which are checked with the solvers too instead of being measured
+ * @param[in] random Random number generator
+ * @param[in] numMovesChecked Number of moves, undos and redos checked, incremented
+ * @param[in] numBenchmarkMoves Number of moves measured, incremented
+ * @param[in] benchmarkSeconds Time spent on measured moves, in seconds, incremented
+ * @param[in] numFailures Number of rooms that failed a check, incremented
+ */
+void FuzzLevel(
+    LevelData& levelData,
+    const std::string& levelName,
+    const int32_t& numPlayoutsPerRoom,
+    const bool& isRegression,
+    std::mt19937_64& random,
+    uint64_t& numMovesChecked,
+    uint64_t& numBenchmarkMoves,
+    double& benchmarkSeconds,
+    int32_t& numFailures)
+{
+    for (size_t i = 0; i < levelData.rooms.size(); ++i)
+    {
+        RoomData &roomData = levelData.rooms[i];
+        if (roomData.analysis.hasInvalidStartOrGoal)
+        {
+            std::cout << levelName << " room " << (i + 1) << ": skipped, invalid start or goal" << std::endl;
+            continue;
+        }
+
+        std::string error;
+        BorderedGrid<CellData> initialCells = roomData.cells;
+        bool isValid = FuzzRoom(roomData, initialCells, numPlayoutsPerRoom, random, numMovesChecked, error)
+            && (!isRegression || CheckSolvers(roomData, initialCells, error));
+        if (!isValid)
+        {
+            if (++numFailures <= MAX_REPORTED_FAILURES)
+            {
+                std::cout << levelName << " room " << (i + 1) << ": " << error << std::endl;
+            }
+        }
+
+        if (!isRegression)
+        {
+            benchmarkSeconds += BenchmarkRoom(roomData, BENCHMARK_MOVES_PER_ROOM, random);
+            numBenchmarkMoves += BENCHMARK_MOVES_PER_ROOM;
+        }
+    }
+}
+
+/**
+ * Plays random and adversarial playouts of every room, checking each move, undo
+ * and redo against a reference model of the room that slides one cell at a time,
+ * and the rules after each of them (no floor visited twice, doors only open after
+ * their switch is pressed, the goal unlocked exactly when every floor is visited).
+ * Then measures how many moves per second the room simulator makes. Rooms that
+ * once broke the simulator or the solvers are always fuzzed too, and instead of
+ * being measured, the solvers are checked against the solutions of the reference
+ * model. A room the bidirectional solver once gave up on is checked to be solved
+ * within a node limit.
+ *
+ * Usage: FuzzPlayouts [-n <playouts per room>] [-s <seed>] [level file ...]
+ *
+ * Without any level files, every level file in Resources/Levels is used. Returns 1
+ * if any check failed.
+ */
+int main(int argc, char *argv[])
+{
+    int32_t numPlayoutsPerRoom = DEFAULT_PLAYOUTS_PER_ROOM;
+    uint64_t seed = 0;
+    std::vector<std::string> filePaths;
+    for (int32_t i = 1; i < argc; ++i)
+    {
+        std::string argument = argv[i];
+        if (((argument == "-n") || (argument == "-s")) && (i + 1 < argc))
+        {
+            uint64_t value = std::strtoull(argv[++i], nullptr, 10);
+            if (argument == "-n")
+            {
+                numPlayoutsPerRoom = static_cast<int32_t>(value);
+            }
+            else
+            {
+                seed = value;
+            }
+        }
+        else
+        {
+            filePaths.push_back(argument);
+        }
+    }
+
+    if (filePaths.empty())
+    {
+        std::error_code errorCode;
+        for (const auto &entry : std::filesystem::directory_iterator(DEFAULT_LEVELS_DIRECTORY, errorCode))
+        {
+            if (entry.path().extension() == ".dat")
+            {
+                filePaths.push_back(entry.path().string());
+            }
+        }
+        std::sort(filePaths.begin(), filePaths.end());
+    }
+    if (filePaths.empty())
+    {
+        std::cerr << "Usage: " << argv[0] << " [-n <playouts per room>] [-s <seed>] [level file ...]" << std::endl;
+        return 1;
+    }
+
+    std::mt19937_64 random(seed);
+    uint64_t numMovesChecked = 0;
+    uint64_t numBenchmarkMoves = 0;
+    double benchmarkSeconds = 0.0;
+    int32_t numFailures = 0;
+    LevelData regressionLevelData;
+    std::istringstream regressionStream(REGRESSION_LEVEL);
+    if (!regressionLevelData.LoadFromStream(regressionStream))
+    {
+        std::cerr << "Failed to load the " << REGRESSION_LEVEL_NAME << "!" << std::endl;
+        return 1;
+    }
+    FuzzLevel(regressionLevelData, REGRESSION_LEVEL_NAME, numPlayoutsPerRoom, true,
+        random, numMovesChecked, numBenchmarkMoves, benchmarkSeconds, numFailures);
+
+    LevelData bidirectionalRegressionLevelData;
+    std::istringstream bidirectionalRegressionStream(BIDIRECTIONAL_REGRESSION_LEVEL);
+    if (!bidirectionalRegressionLevelData.LoadFromStream(bidirectionalRegressionStream))
+    {
+        std::cerr << "Failed to load the " << BIDIRECTIONAL_REGRESSION_LEVEL_NAME << "!" << std::endl;
+        return 1;
+    }
+    CheckBidirectionalRegression(bidirectionalRegressionLevelData, numFailures);
+
+    for (const std::string &filePath : filePaths)
+    {
+        LevelData levelData;
+        if (!levelData.LoadFromFile(filePath))
+        {
+            std::cerr << "Failed to load level file " << filePath << "!" << std::endl;
+            return 1;
+        }
+
+        FuzzLevel(levelData, filePath, numPlayoutsPerRoom, false,
+            random, numMovesChecked, numBenchmarkMoves, benchmarkSeconds, numFailures);
+    }
+
+    std::cout << numMovesChecked << " moves, undos and redos checked, " << numFailures << " rooms failed" << std::endl;
+    std::cout << numBenchmarkMoves << " random moves in " << benchmarkSeconds << " s: "
+        << ((benchmarkSeconds > 0.0) ? (numBenchmarkMoves / benchmarkSeconds) : 0.0) << " moves/s" << std::endl;
+
+    return (numFailures == 0) ? 0 : 1;
+}
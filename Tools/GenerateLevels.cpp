@@ -0,0 +1,229 @@
+#include "Direction.hpp"
+#include "LevelData.hpp"
+#include "RoomGenerator.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define DEFAULT_NUM_LEVELS 1
+#define DEFAULT_NUM_ROOMS_PER_LEVEL 5
+#define DEFAULT_ROOM_SIZE 10
+#define MAX_ATTEMPTS_PER_ROOM 100
+
+/**
+ * @brief Gets the generator settings for the specified difficulty
+ * @param[in] difficulty Difficulty name: easy, medium or hard
+ * @param[out] settings Generator settings, whose size is left unchanged
+ * @return Returns true if the difficulty name is known. Returns false otherwise
+ */
+bool GetDifficultySettings(const std::string& difficulty, RoomGeneratorSettings& settings)
+{
+    if (difficulty == "easy")
+    {
+        settings.pathCoverage = 0.5;
+        settings.iceProbability = 0.0;
+        settings.distractorIceProbability = 0.0;
+        settings.numSwitchDoorPairs = 0;
+    }
+    else if (difficulty == "medium")
+    {
+        settings.pathCoverage = 0.7;
+        settings.iceProbability = 0.3;
+        settings.distractorIceProbability = 0.05;
+        settings.numSwitchDoorPairs = 1;
+    }
+    else if (difficulty == "hard")
+    {
+        settings.pathCoverage = 0.9;
+        settings.iceProbability = 0.5;
+        settings.distractorIceProbability = 0.15;
+        settings.numSwitchDoorPairs = 3;
+    }
+    else
+    {
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Generates a room and checks that it still solves after a round trip through
+ * the level file format
+ * @param[in] generator Room generator
+ * @param[in] settings Generator settings
+ * @param[out] roomData Generated room, as read back from the level file format
+ * @return Returns true if the operation was successful. Returns false otherwise
+ */
+bool GenerateVerifiedRoom(RoomGenerator& generator, const RoomGeneratorSettings& settings, RoomData& roomData)
+{
+    LevelData generatedLevel;
+    generatedLevel.rooms.resize(1);
+    std::vector<Direction> solution;
+    if (!generator.Generate(settings, generatedLevel.rooms[0], solution))
+    {
+        return false;
+    }
+
+    std::stringstream stream;
+    LevelData loadedLevel;
+    if (!generatedLevel.SaveToStream(stream) || !loadedLevel.LoadFromStream(stream) || (loadedLevel.rooms.size() != 1))
+    {
+        return false;
+    }
+    if (loadedLevel.rooms[0].analysis.IsProvablyUnsolvable() || !RoomGenerator::Verify(loadedLevel.rooms[0], solution))
+    {
+        return false;
+    }
+
+    roomData = loadedLevel.rooms[0];
+    return true;
+}
+
+/**
+ * Generates level files made of solvable rooms.
+ *
+ * Usage: GenerateLevels [-l <levels>] [-r <rooms per level>] [-w <width>] [-h <height>]
+ *     [-d easy|medium|hard] [-s <seed>] [-j <threads>] <output directory>
+ *
+ * Each level is generated from its own seed (the base seed plus the level index),
+ * so the output does not depend on the number of threads. Every room is written
+ * out in the level file format, read back, and only kept if replaying the solution
+ * the generator built it around still reaches the goal.
+ */
+int main(int argc, char *argv[])
+{
+    int32_t numLevels = DEFAULT_NUM_LEVELS;
+    int32_t numRoomsPerLevel = DEFAULT_NUM_ROOMS_PER_LEVEL;
+    int32_t numThreads = std::max(1, static_cast<int32_t>(std::thread::hardware_concurrency()));
+    uint64_t baseSeed = 0;
+    std::string difficulty = "medium";
+    std::string outputDirectory;
+    RoomGeneratorSettings settings;
+    settings.width = DEFAULT_ROOM_SIZE;
+    settings.height = DEFAULT_ROOM_SIZE;
+    for (int32_t i = 1; i < argc; ++i)
+    {
+        std::string argument = argv[i];
+        if ((argument == "-d") && (i + 1 < argc))
+        {
+            difficulty = argv[++i];
+        }
+        else if (((argument == "-l") || (argument == "-r") || (argument == "-w") || (argument == "-h")
+            || (argument == "-s") || (argument == "-j")) && (i + 1 < argc))
+        {
+            uint64_t value = std::strtoull(argv[++i], nullptr, 10);
+            if (argument == "-l")
+            {
+                numLevels = static_cast<int32_t>(value);
+            }
+            else if (argument == "-r")
+            {
+                numRoomsPerLevel = static_cast<int32_t>(value);
+            }
+            else if (argument == "-w")
+            {
+                settings.width = static_cast<int32_t>(value);
+            }
+            else if (argument == "-h")
+            {
+                settings.height = static_cast<int32_t>(value);
+            }
+            else if (argument == "-s")
+            {
+                baseSeed = value;
+            }
+            else
+            {
+                numThreads = std::max(1, static_cast<int32_t>(value));
+            }
+        }
+        else
+        {
+            outputDirectory = argument;
+        }
+    }
+
+    if (outputDirectory.empty() || !GetDifficultySettings(difficulty, settings))
+    {
+        std::cerr << "Usage: " << argv[0] << " [-l <levels>] [-r <rooms per level>] [-w <width>] [-h <height>]"
+            << " [-d easy|medium|hard] [-s <seed>] [-j <threads>] <output directory>" << std::endl;
+        return 1;
+    }
+    if ((settings.width < 3) || (settings.height < 3) || ((settings.width - 2) * (settings.height - 2) < 3))
+    {
+        std::cerr << "Rooms must have at least 3 cells inside the wall border!" << std::endl;
+        return 1;
+    }
+
+    auto startTime = std::chrono::steady_clock::now();
+    std::vector<LevelData> levels(std::max(numLevels, 0));
+    std::atomic<size_t> nextLevelIndex = 0;
+    std::atomic<uint64_t> numRejectedRooms = 0;
+    std::atomic<bool> hasFailed = false;
+    std::vector<std::thread> workers;
+    for (int32_t i = 0; i < numThreads; ++i)
+    {
+        workers.emplace_back([&]()
+        {
+            RoomGenerator generator;
+            for (size_t levelIndex = nextLevelIndex++; levelIndex < levels.size(); levelIndex = nextLevelIndex++)
+            {
+                LevelData &levelData = levels[levelIndex];
+                levelData.descriptionLines = { "Walk through all floors only once before reaching the goal." };
+                levelData.rooms.resize(std::max(numRoomsPerLevel, 0));
+                generator.SetSeed(baseSeed + levelIndex);
+                for (RoomData &roomData : levelData.rooms)
+                {
+                    int32_t numAttempts = 0;
+                    while (!GenerateVerifiedRoom(generator, settings, roomData))
+                    {
+                        ++numRejectedRooms;
+                        if (++numAttempts >= MAX_ATTEMPTS_PER_ROOM)
+                        {
+                            hasFailed = true;
+                            return;
+                        }
+                    }
+                }
+            }
+        });
+    }
+    for (std::thread &worker : workers)
+    {
+        worker.join();
+    }
+    auto endTime = std::chrono::steady_clock::now();
+
+    if (hasFailed)
+    {
+        std::cerr << "Failed to generate a solvable room after " << MAX_ATTEMPTS_PER_ROOM << " attempts!" << std::endl;
+        return 1;
+    }
+
+    for (size_t i = 0; i < levels.size(); ++i)
+    {
+        std::string levelFilePath = outputDirectory + "/level" + std::to_string(i + 1) + ".dat";
+        if (!levels[i].SaveToFile(levelFilePath))
+        {
+            std::cerr << "Failed to write level file " << levelFilePath << "!" << std::endl;
+            return 1;
+        }
+    }
+
+    uint64_t numRooms = static_cast<uint64_t>(levels.size()) * std::max(numRoomsPerLevel, 0);
+    double elapsedSeconds = std::chrono::duration<double>(endTime - startTime).count();
+    std::cout << "Generated " << numRooms << " " << difficulty << " rooms in " << levels.size() << " levels in "
+        << (elapsedSeconds * 1000.0) << " ms (" << (numRooms / std::max(elapsedSeconds, 1e-9)) << " rooms/s, "
+        << numRejectedRooms << " rejected, " << numThreads << " threads)" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,403 @@
+#include "Direction.hpp"
+#include "LevelData.hpp"
+#include "RoomBitboard.hpp"
+#include "RoomSolver.hpp"
+#include "RoomSymmetry.hpp"
+#include "SolutionCounter.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#define DEFAULT_MAX_NODES_PER_ROOM 1000000
+#define DEFAULT_MAX_SOLUTIONS_PER_ROOM 1000
+
+/**
+ * Solvability of a room, as far as the solver could tell
+ */
+enum class Solvability
+{
+    Solvable,
+    Unsolvable,
+    Unknown
+};
+
+/**
+ * Metrics measured on a single room
+ */
+struct RoomMetrics
+{
+    /**
+     * Room width
+     */
+    int32_t width = 0;
+
+    /**
+     * Room height
+     */
+    int32_t height = 0;
+
+    /**
+     * Number of floor cells
+     */
+    int32_t numFloors = 0;
+
+    /**
+     * Solvability of the room
+     */
+    Solvability solvability = Solvability::Unknown;
+
+    /**
+     * Flag indicating whether the checks run at load time prove the room unsolvable
+     */
+    bool isProvablyUnsolvable = false;
+
+    /**
+     * Number of move sequences that solve the room, up to the solution limit
+     */
+    uint64_t numSolutions = 0;
+
+    /**
+     * Flag indicating whether numSolutions is the exact number of solutions
+     */
+    bool isSolutionCountExact = false;
+
+    /**
+     * Number of search nodes the solver expanded
+     */
+    uint64_t numNodesExpanded = 0;
+
+    /**
+     * Number of moves in the solution found by the solver. 0 if none was found
+     */
+    size_t solutionLength = 0;
+
+    /**
+     * Average number of possible moves before each move of the solution
+     */
+    double branchingFactor = 0.0;
+
+    /**
+     * Fraction of the moves of the solution that were the only possible move
+     */
+    double forcedMoveRatio = 0.0;
+
+    /**
+     * Time spent measuring the room, in milliseconds
+     */
+    double elapsedMs = 0.0;
+};
+
+/**
+ * @brief Replays a solution and measures how many moves were possible before each of its moves
+ * @param[in] roomData Room data
+ * @param[in] moves Solution
+ * @param[in,out] metrics Room metrics, whose branching factor and forced move ratio are set
+ */
+template <size_t NumWords>
+void MeasureSolutionWithBitboard(const RoomData& roomData, const std::vector<Direction>& moves, RoomMetrics& metrics)
+{
+    RoomBitboard<NumWords> board;
+    if (!board.Build(roomData) || moves.empty())
+    {
+        return;
+    }
+
+    int32_t cellIndex = board.GetStartIndex();
+    int32_t numPossibleMoves = 0;
+    int32_t numForcedMoves = 0;
+    for (Direction move : moves)
+    {
+        int32_t numChoices = 0;
+        for (Direction direction : ALL_DIRECTIONS)
+        {
+            int32_t newCellIndex = cellIndex;
+            RoomMoveRecord record;
+            if (board.ApplyMove(newCellIndex, direction, record))
+            {
+                ++numChoices;
+                board.UndoMove(record);
+            }
+        }
+        numPossibleMoves += numChoices;
+        numForcedMoves += (numChoices == 1) ? 1 : 0;
+
+        RoomMoveRecord record;
+        board.ApplyMove(cellIndex, move, record);
+    }
+
+    metrics.branchingFactor = static_cast<double>(numPossibleMoves) / moves.size();
+    metrics.forcedMoveRatio = static_cast<double>(numForcedMoves) / moves.size();
+}
+
+/**
+ * @brief Replays a solution and measures how many moves were possible before each of its moves
+ * @param[in] roomData Room data
+ * @param[in] moves Solution
+ * @param[in,out] metrics Room metrics, whose branching factor and forced move ratio are set
+ */
+void MeasureSolution(const RoomData& roomData, const std::vector<Direction>& moves, RoomMetrics& metrics)
+{
+    DispatchToBitboard(roomData.cells.GetWidth(), roomData.cells.GetHeight(), [&](auto numWords)
+    {
+        MeasureSolutionWithBitboard<decltype(numWords)::value>(roomData, moves, metrics);
+    });
+}
+
+/**
+ * @brief Measures the metrics of a room
+ * @param[in] roomData Room data
+ * @param[in,out] solver Solver used to find a solution
+ * @param[in,out] counter Solution counter
+ * @return Room metrics
+ */
+RoomMetrics MeasureRoom(const RoomData& roomData, RoomSolver& solver, SolutionCounter& counter)
+{
+    auto startTime = std::chrono::steady_clock::now();
+
+    RoomMetrics metrics;
+    metrics.width = roomData.cells.GetWidth();
+    metrics.height = roomData.cells.GetHeight();
+    roomData.cells.ForEach([&metrics](const int32_t&, const int32_t&, const CellData& cellData)
+    {
+        metrics.numFloors += (cellData.GetType() == CellData::Type::Floor) ? 1 : 0;
+    });
+
+    metrics.isProvablyUnsolvable = roomData.analysis.IsProvablyUnsolvable();
+    if (metrics.isProvablyUnsolvable)
+    {
+        metrics.solvability = Solvability::Unsolvable;
+        metrics.isSolutionCountExact = true;
+    }
+    else
+    {
+        std::vector<Direction> moves;
+        if (solver.Solve(roomData, moves))
+        {
+            metrics.solvability = Solvability::Solvable;
+            metrics.solutionLength = moves.size();
+            MeasureSolution(roomData, moves, metrics);
+        }
+        else
+        {
+            metrics.solvability = solver.HasHitNodeLimit() ? Solvability::Unknown : Solvability::Unsolvable;
+        }
+        metrics.numNodesExpanded = solver.GetNumNodesExpanded();
+
+        metrics.numSolutions = counter.Count(roomData);
+        metrics.isSolutionCountExact = counter.IsExact();
+
+        // The solver and the counter give up independently, so each one's result
+        // is a lower bound for the other
+        if ((metrics.solvability == Solvability::Solvable) && (metrics.numSolutions == 0))
+        {
+            metrics.numSolutions = 1;
+        }
+        else if ((metrics.solvability == Solvability::Unknown) && (metrics.numSolutions > 0))
+        {
+            metrics.solvability = Solvability::Solvable;
+        }
+    }
+
+    auto endTime = std::chrono::steady_clock::now();
+    metrics.elapsedMs = std::chrono::duration<double, std::milli>(endTime - startTime).count();
+
+    return metrics;
+}
+
+/**
+ * @brief Writes a string as a JSON string literal
+ * @param[in] text String to write
+ */
+void WriteJsonString(const std::string& text)
+{
+    std::cout << '"';
+    for (char c : text)
+    {
+        if ((c == '"') || (c == '\\'))
+        {
+            std::cout << '\\' << c;
+        }
+        else if (static_cast<unsigned char>(c) < 0x20)
+        {
+            std::cout << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int32_t>(c)
+                << std::dec << std::setfill(' ');
+        }
+        else
+        {
+            std::cout << c;
+        }
+    }
+    std::cout << '"';
+}
+
+/**
+ * @brief Writes the metrics of a room as a JSON object
+ * @param[in] roomNumber Room number, starting from 1
+ * @param[in] metrics Room metrics
+ */
+void WriteRoomJson(const size_t& roomNumber, const RoomMetrics& metrics)
+{
+    const char *solvableText = "null";
+    if (metrics.solvability != Solvability::Unknown)
+    {
+        solvableText = (metrics.solvability == Solvability::Solvable) ? "true" : "false";
+    }
+
+    std::cout << "{ \"room\": " << roomNumber
+        << ", \"width\": " << metrics.width
+        << ", \"height\": " << metrics.height
+        << ", \"floors\": " << metrics.numFloors
+        << ", \"solvable\": " << solvableText
+        << ", \"provablyUnsolvable\": " << (metrics.isProvablyUnsolvable ? "true" : "false")
+        << ", \"solutionCount\": " << metrics.numSolutions
+        << ", \"solutionCountExact\": " << (metrics.isSolutionCountExact ? "true" : "false")
+        << ", \"nodesExpanded\": " << metrics.numNodesExpanded
+        << ", \"solutionLength\": " << metrics.solutionLength
+        << std::fixed << std::setprecision(3)
+        << ", \"branchingFactor\": " << metrics.branchingFactor
+        << ", \"forcedMoveRatio\": " << metrics.forcedMoveRatio
+        << ", \"elapsedMs\": " << metrics.elapsedMs
+        << std::defaultfloat << " }";
+}
+
+/**
+ * Measures the difficulty of every room in one or more level files and prints the
+ * results as JSON, for reviewing rooms in bulk without playtesting them.
+ *
+ * Usage: RoomMetrics [-j <threads>] [-n <max nodes per room>] [-s <max solutions per room>] <level file> ...
+ *
+ * For each room, the metrics are: whether it is solvable (null if the solver gave
+ * up), the number of solutions up to the solution limit, the number of nodes the
+ * solver expanded, and, along the solution found by the solver, the average number
+ * of possible moves before each move (branching factor) and the fraction of moves
+ * that were the only possible one (forced move ratio). Rooms are measured in
+ * parallel, one room per thread at a time. Rooms that are rotations or reflections
+ * of an earlier room are not measured again, and repeat its metrics.
+ */
+int main(int argc, char *argv[])
+{
+    int32_t numThreads = std::max(1, static_cast<int32_t>(std::thread::hardware_concurrency()));
+    uint64_t maxNodes = DEFAULT_MAX_NODES_PER_ROOM;
+    uint64_t maxSolutions = DEFAULT_MAX_SOLUTIONS_PER_ROOM;
+    std::vector<std::string> filePaths;
+    for (int32_t i = 1; i < argc; ++i)
+    {
+        std::string argument = argv[i];
+        if (((argument == "-j") || (argument == "-n") || (argument == "-s")) && (i + 1 < argc))
+        {
+            uint64_t value = std::strtoull(argv[++i], nullptr, 10);
+            if (argument == "-j")
+            {
+                numThreads = std::max(1, static_cast<int32_t>(value));
+            }
+            else if (argument == "-n")
+            {
+                maxNodes = value;
+            }
+            else
+            {
+                maxSolutions = value;
+            }
+        }
+        else
+        {
+            filePaths.push_back(argument);
+        }
+    }
+
+    if (filePaths.empty())
+    {
+        std::cerr << "Usage: " << argv[0] << " [-j <threads>] [-n <max nodes per room>] [-s <max solutions per room>] <level file> ..." << std::endl;
+        return 1;
+    }
+
+    std::vector<LevelData> levels(filePaths.size());
+    for (size_t i = 0; i < filePaths.size(); ++i)
+    {
+        if (!levels[i].LoadFromFile(filePaths[i]))
+        {
+            std::cerr << "Failed to load level file " << filePaths[i] << "!" << std::endl;
+            return 1;
+        }
+    }
+
+    // Rooms are handed out one at a time, since their sizes vary a lot
+    std::vector<std::pair<size_t, size_t>> tasks;
+    std::vector<std::vector<RoomMetrics>> results(levels.size());
+    std::vector<std::vector<std::pair<size_t, size_t>>> measuredRooms(levels.size());
+    std::unordered_map<std::string, std::pair<size_t, size_t>> roomsBySymmetryClass;
+    for (size_t i = 0; i < levels.size(); ++i)
+    {
+        results[i].resize(levels[i].rooms.size());
+        for (size_t j = 0; j < levels[i].rooms.size(); ++j)
+        {
+            auto [it, isNewClass] = roomsBySymmetryClass.emplace(RoomSymmetry::GetCanonicalKey(levels[i].rooms[j]), std::make_pair(i, j));
+            measuredRooms[i].push_back(it->second);
+            if (isNewClass)
+            {
+                tasks.push_back({ i, j });
+            }
+        }
+    }
+
+    std::atomic<size_t> nextTaskIndex = 0;
+    std::vector<std::thread> workers;
+    for (int32_t i = 0; i < numThreads; ++i)
+    {
+        workers.emplace_back([&]()
+        {
+            RoomSolver solver;
+            solver.SetMaxNodes(maxNodes);
+            SolutionCounter counter;
+            counter.SetMaxNodes(maxNodes);
+            counter.SetMaxSolutions(maxSolutions);
+            for (size_t taskIndex = nextTaskIndex++; taskIndex < tasks.size(); taskIndex = nextTaskIndex++)
+            {
+                const auto &[levelIndex, roomIndex] = tasks[taskIndex];
+                results[levelIndex][roomIndex] = MeasureRoom(levels[levelIndex].rooms[roomIndex], solver, counter);
+            }
+        });
+    }
+    for (std::thread &worker : workers)
+    {
+        worker.join();
+    }
+    for (size_t i = 0; i < levels.size(); ++i)
+    {
+        for (size_t j = 0; j < levels[i].rooms.size(); ++j)
+        {
+            // A transposed copy keeps its own width and height
+            results[i][j] = results[measuredRooms[i][j].first][measuredRooms[i][j].second];
+            results[i][j].width = levels[i].rooms[j].cells.GetWidth();
+            results[i][j].height = levels[i].rooms[j].cells.GetHeight();
+        }
+    }
+
+    std::cout << "{" << std::endl << "  \"levels\": [" << std::endl;
+    for (size_t i = 0; i < levels.size(); ++i)
+    {
+        std::cout << "    {" << std::endl << "      \"file\": ";
+        WriteJsonString(filePaths[i]);
+        std::cout << "," << std::endl << "      \"rooms\": [" << std::endl;
+        for (size_t j = 0; j < results[i].size(); ++j)
+        {
+            std::cout << "        ";
+            WriteRoomJson(j + 1, results[i][j]);
+            std::cout << ((j + 1 < results[i].size()) ? "," : "") << std::endl;
+        }
+        std::cout << "      ]" << std::endl << "    }" << ((i + 1 < levels.size()) ? "," : "") << std::endl;
+    }
+    std::cout << "  ]" << std::endl << "}" << std::endl;
+
+    return 0;
+}
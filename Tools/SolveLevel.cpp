@@ -0,0 +1,289 @@
+#include "BacktrackingRoomSolver.hpp"
+#include "BidirectionalRoomSolver.hpp"
+#include "Direction.hpp"
+#include "HeldKarpRoomSolver.hpp"
+#include "LevelData.hpp"
+#include "ParallelRoomSolver.hpp"
+#include "RoomSolver.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/**
+ * Room solver picked on the command line
+ */
+enum class SolverType
+{
+    Search,
+    Parallel,
+    Backtracking,
+    Exact,
+    Bidirectional
+};
+
+/**
+ * @brief Prints the reasons why a room is provably unsolvable, separated by commas
+ * @param[in] analysis Results of the unsolvability checks on the room
+ */
+void PrintUnsolvableReasons(const RoomAnalysis& analysis)
+{
+    std::string separator = "";
+    if (analysis.hasInvalidStartOrGoal)
+    {
+        std::cout << separator << "invalid start or goal";
+        separator = ", ";
+    }
+    if (analysis.hasParityMismatch)
+    {
+        std::cout << separator << "checkerboard parity mismatch";
+        separator = ", ";
+    }
+    if (analysis.numDeadEndFloors > 0)
+    {
+        std::cout << separator << analysis.numDeadEndFloors << " dead-end floors";
+        separator = ", ";
+    }
+    if (analysis.numUnreachableFloors > 0)
+    {
+        std::cout << separator << analysis.numUnreachableFloors << " unreachable floors";
+        separator = ", ";
+    }
+    if (analysis.isGoalUnreachable)
+    {
+        std::cout << separator << "unreachable goal";
+        separator = ", ";
+    }
+    if (analysis.numUnopenableDoors > 0)
+    {
+        std::cout << separator << analysis.numUnopenableDoors << " doors that can never be unlocked";
+    }
+}
+
+/**
+ * @brief Prints the statistics of a transposition table for the last solved room
+ * @param[in] transpositionTable Transposition table
+ */
+void PrintTranspositionTableStats(const TranspositionTable& transpositionTable)
+{
+    if (!transpositionTable.IsEnabled())
+    {
+        return;
+    }
+
+    std::streamsize precision = std::cout.precision();
+    std::cout << "    Transposition table: " << transpositionTable.GetNumHits() << "/" << transpositionTable.GetNumProbes()
+        << " hits (" << std::fixed << std::setprecision(1) << (transpositionTable.GetHitRate() * 100.0) << "%), "
+        << transpositionTable.GetNumStores() << " stores, " << transpositionTable.GetNumReplacements() << " replacements, "
+        << (transpositionTable.GetOccupancy() * 100.0) << "% full" << std::defaultfloat << std::setprecision(precision) << std::endl;
+}
+
+/**
+ * @brief Prints the statistics of the solver used for the last solved room
+ * @param[in] solverType Type of the solver that was used
+ * @param[in] solver Search solver
+ * @param[in] parallelSolver Parallel solver
+ * @param[in] backtrackingSolver Backtracking solver
+ * @param[in] exactSolver Exact solver
+ * @param[in] bidirectionalSolver Bidirectional solver
+ */
+void PrintSolverStats(
+    const SolverType& solverType,
+    const RoomSolver& solver,
+    const ParallelRoomSolver& parallelSolver,
+    const BacktrackingRoomSolver& backtrackingSolver,
+    const HeldKarpRoomSolver& exactSolver,
+    const BidirectionalRoomSolver& bidirectionalSolver)
+{
+    if (solverType == SolverType::Parallel)
+    {
+        std::cout << "    Work stealing: " << parallelSolver.GetNumThreads() << " threads, "
+            << parallelSolver.GetNumTasksStolen() << " subtrees stolen" << std::endl;
+        return;
+    }
+    if (solverType == SolverType::Backtracking)
+    {
+        std::cout << "    Pruning: " << backtrackingSolver.GetNumPrunedMoves() << " moves pruned, "
+            << backtrackingSolver.GetNumConnectivityChecks() << " connectivity recomputations" << std::endl;
+        PrintTranspositionTableStats(backtrackingSolver.GetTranspositionTable());
+        return;
+    }
+    if (solverType == SolverType::Exact)
+    {
+        std::cout << "    State cells: " << exactSolver.GetNumStateCells() << " floor, switch, door and empty cells" << std::endl;
+        return;
+    }
+    if (solverType == SolverType::Bidirectional)
+    {
+        if (bidirectionalSolver.GetNumMeetingFloors() == 0)
+        {
+            std::cout << "    Meet in the middle: searched forward to the goal" << std::endl;
+            return;
+        }
+
+        std::cout << "    Meet in the middle: " << bidirectionalSolver.GetNumStoredHalves() << " second halves stored, meeting after "
+            << bidirectionalSolver.GetNumMeetingFloors() << " floors, "
+            << bidirectionalSolver.GetNumJoinsChecked() << " joined solutions replayed" << std::endl;
+        return;
+    }
+
+    PrintTranspositionTableStats(solver.GetTranspositionTable());
+}
+
+/**
+ * Solves every room in a level file and prints the move sequence for each room.
+ *
+ * Usage: SolveLevel <level file> [max nodes per room] [search|parallel|backtracking|exact|bidirectional]
+ *
+ * The optional last argument picks the solver: "search" (default) for RoomSolver,
+ * "parallel" for ParallelRoomSolver on every hardware thread, "backtracking" for
+ * BacktrackingRoomSolver, "exact" for HeldKarpRoomSolver, or
+ * "bidirectional" for BidirectionalRoomSolver.
+ * The exact solver ignores the node limit, and only handles rooms with at most
+ * HeldKarpRoomSolver::MAX_STATE_CELLS floor, switch, door and empty cells.
+ */
+int main(int argc, char *argv[])
+{
+    if (argc < 2)
+    {
+        std::cerr << "Usage: " << argv[0] << " <level file> [max nodes per room] [search|parallel|backtracking|exact|bidirectional]" << std::endl;
+        return 1;
+    }
+
+    LevelData levelData;
+    if (!levelData.LoadFromFile(argv[1]))
+    {
+        std::cerr << "Failed to load level file " << argv[1] << "!" << std::endl;
+        return 1;
+    }
+
+    SolverType solverType = SolverType::Search;
+    if (argc >= 4)
+    {
+        std::string solverName = argv[3];
+        if (solverName == "parallel")
+        {
+            solverType = SolverType::Parallel;
+        }
+        else if (solverName == "backtracking")
+        {
+            solverType = SolverType::Backtracking;
+        }
+        else if (solverName == "exact")
+        {
+            solverType = SolverType::Exact;
+        }
+        else if (solverName == "bidirectional")
+        {
+            solverType = SolverType::Bidirectional;
+        }
+        else if (solverName != "search")
+        {
+            std::cerr << "Unknown solver " << solverName << "!" << std::endl;
+            return 1;
+        }
+    }
+
+    RoomSolver solver;
+    ParallelRoomSolver parallelSolver;
+    BacktrackingRoomSolver backtrackingSolver;
+    HeldKarpRoomSolver exactSolver;
+    BidirectionalRoomSolver bidirectionalSolver;
+    if (argc >= 3)
+    {
+        solver.SetMaxNodes(std::strtoull(argv[2], nullptr, 10));
+        parallelSolver.SetMaxNodes(std::strtoull(argv[2], nullptr, 10));
+        backtrackingSolver.SetMaxNodes(std::strtoull(argv[2], nullptr, 10));
+        bidirectionalSolver.SetMaxNodes(std::strtoull(argv[2], nullptr, 10));
+    }
+
+    int32_t numUnsolvedRooms = 0;
+    for (size_t i = 0; i < levelData.rooms.size(); ++i)
+    {
+        std::vector<Direction> moves;
+
+        const RoomAnalysis &analysis = levelData.rooms[i].analysis;
+        if (analysis.IsProvablyUnsolvable())
+        {
+            std::cout << "Room " << (i + 1) << ": provably unsolvable (";
+            PrintUnsolvableReasons(analysis);
+            std::cout << ")" << std::endl;
+            ++numUnsolvedRooms;
+            continue;
+        }
+
+        if (solverType == SolverType::Exact)
+        {
+            int32_t numStateCells = HeldKarpRoomSolver::CountStateCells(levelData.rooms[i]);
+            if (numStateCells > HeldKarpRoomSolver::MAX_STATE_CELLS)
+            {
+                std::cout << "Room " << (i + 1) << ": too large for the exact solver (" << numStateCells
+                    << " floor, switch, door and empty cells, limit " << HeldKarpRoomSolver::MAX_STATE_CELLS << ")" << std::endl;
+                ++numUnsolvedRooms;
+                continue;
+            }
+        }
+
+        auto startTime = std::chrono::steady_clock::now();
+        bool isSolved = false;
+        uint64_t numNodesExpanded = 0;
+        bool hasHitNodeLimit = false;
+        switch (solverType)
+        {
+            case SolverType::Search:
+                isSolved = solver.Solve(levelData.rooms[i], moves);
+                numNodesExpanded = solver.GetNumNodesExpanded();
+                hasHitNodeLimit = solver.HasHitNodeLimit();
+                break;
+            case SolverType::Parallel:
+                isSolved = parallelSolver.Solve(levelData.rooms[i], moves);
+                numNodesExpanded = parallelSolver.GetNumNodesExpanded();
+                hasHitNodeLimit = parallelSolver.HasHitNodeLimit();
+                break;
+            case SolverType::Backtracking:
+                isSolved = backtrackingSolver.Solve(levelData.rooms[i], moves);
+                numNodesExpanded = backtrackingSolver.GetNumNodesExpanded();
+                hasHitNodeLimit = backtrackingSolver.HasHitNodeLimit();
+                break;
+            case SolverType::Exact:
+                isSolved = exactSolver.Solve(levelData.rooms[i], moves);
+                numNodesExpanded = exactSolver.GetNumStatesExpanded();
+                hasHitNodeLimit = exactSolver.HasExceededCellLimit();
+                break;
+            case SolverType::Bidirectional:
+                isSolved = bidirectionalSolver.Solve(levelData.rooms[i], moves);
+                numNodesExpanded = bidirectionalSolver.GetNumNodesExpanded();
+                hasHitNodeLimit = bidirectionalSolver.HasHitNodeLimit();
+                break;
+        }
+        auto endTime = std::chrono::steady_clock::now();
+        double elapsedMs = std::chrono::duration<double, std::milli>(endTime - startTime).count();
+
+        std::cout << "Room " << (i + 1) << ": ";
+        if (isSolved)
+        {
+            std::string movesText;
+            for (Direction direction : moves)
+            {
+                movesText.push_back(GetDirectionChar(direction));
+            }
+            std::cout << "solved with " << moves.size() << " moves";
+            std::cout << " (" << numNodesExpanded << " nodes, " << elapsedMs << " ms)" << std::endl;
+            std::cout << "    " << movesText << std::endl;
+            PrintSolverStats(solverType, solver, parallelSolver, backtrackingSolver, exactSolver, bidirectionalSolver);
+        }
+        else
+        {
+            std::cout << (hasHitNodeLimit ? "gave up" : "no solution");
+            std::cout << " (" << numNodesExpanded << " nodes, " << elapsedMs << " ms)" << std::endl;
+            PrintSolverStats(solverType, solver, parallelSolver, backtrackingSolver, exactSolver, bidirectionalSolver);
+            ++numUnsolvedRooms;
+        }
+    }
+
+    return (numUnsolvedRooms == 0) ? 0 : 1;
+}
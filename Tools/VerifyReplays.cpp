@@ -0,0 +1,175 @@
+#include "Direction.hpp"
+#include "LevelData.hpp"
+#include "ReplayData.hpp"
+#include "RoomSimulator.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+#define DEFAULT_LEVELS_DIRECTORY "Resources/Levels"
+
+/**
+ * @brief Replays the moves of a replay on the specified room
+ * @param[in] replayData Replay data
+ * @param[in] simulator Room simulator to replay the moves with
+ * @param[in] roomData Room the replay was recorded in
+ * @param[out] reason Why the replay is not a valid completion of the room
+ * @return Returns true if every move moves the player, and the last move enters
+ * the unlocked goal. Returns false otherwise
+ */
+bool VerifyReplay(const ReplayData& replayData, RoomSimulator& simulator, RoomData& roomData, std::string& reason)
+{
+    if (roomData.analysis.hasInvalidStartOrGoal)
+    {
+        reason = "room has an invalid start or goal";
+        return false;
+    }
+
+    simulator.Reset(&roomData);
+    for (size_t i = 0; i < replayData.moves.size(); ++i)
+    {
+        if (simulator.HasReachedGoal())
+        {
+            reason = "move " + std::to_string(i + 1) + " is made after reaching the goal";
+            return false;
+        }
+        if (!simulator.ApplyMove(replayData.moves[i]))
+        {
+            reason = "move " + std::to_string(i + 1) + " (" + GetDirectionChar(replayData.moves[i]) + ") is blocked";
+            return false;
+        }
+    }
+
+    if (!simulator.HasReachedGoal())
+    {
+        reason = "the goal is not reached";
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * Checks replays recorded by the game, and reports which of them are valid
+ * completions of their room.
+ *
+ * Usage: VerifyReplays [-d <levels directory>] [-q] [replay file]
+ *
+ * Replays are read one at a time from the replay file, or from standard input if no
+ * replay file is given or it is "-", so any number of them can be checked without
+ * loading them all into memory. Each level file (level<ID>.dat in the levels
+ * directory, Resources/Levels by default) is loaded the first time a replay refers
+ * to it. With -q, only invalid replays are listed. Returns 1 if any replay is
+ * invalid or the replays could not be read.
+ */
+int main(int argc, char *argv[])
+{
+    std::string levelsDirectory = DEFAULT_LEVELS_DIRECTORY;
+    std::string replayFilePath;
+    bool isQuiet = false;
+    for (int32_t i = 1; i < argc; ++i)
+    {
+        std::string argument = argv[i];
+        if ((argument == "-d") && (i + 1 < argc))
+        {
+            levelsDirectory = argv[++i];
+        }
+        else if (argument == "-q")
+        {
+            isQuiet = true;
+        }
+        else
+        {
+            replayFilePath = argument;
+        }
+    }
+
+    std::ifstream file;
+    if (!replayFilePath.empty() && (replayFilePath != "-"))
+    {
+        file.open(replayFilePath, std::ios::binary);
+        if (file.fail())
+        {
+            std::cerr << "Failed to open replay file " << replayFilePath << "!" << std::endl;
+            std::cerr << "Usage: " << argv[0] << " [-d <levels directory>] [-q] [replay file]" << std::endl;
+            return 1;
+        }
+    }
+    else
+    {
+        std::ios::sync_with_stdio(false);
+    }
+    std::istream &stream = file.is_open() ? static_cast<std::istream&>(file) : std::cin;
+
+    std::unordered_map<int32_t, LevelData> levels;
+    std::unordered_set<int32_t> missingLevelIds;
+    RoomSimulator simulator;
+    ReplayData replayData;
+    std::string reason;
+    uint64_t numReplays = 0;
+    uint64_t numValidReplays = 0;
+    bool hasReadFailed = false;
+    auto startTime = std::chrono::steady_clock::now();
+    while (stream.peek() != std::char_traits<char>::eof())
+    {
+        if (!replayData.LoadFromStream(stream))
+        {
+            std::cerr << "Failed to read replay " << (numReplays + 1) << "!" << std::endl;
+            hasReadFailed = true;
+            break;
+        }
+        ++numReplays;
+
+        int32_t levelId = replayData.levelId;
+        if ((levels.find(levelId) == levels.end()) && (missingLevelIds.find(levelId) == missingLevelIds.end()))
+        {
+            LevelData levelData;
+            if (levelData.LoadFromFile(levelsDirectory + "/level" + std::to_string(levelId) + ".dat"))
+            {
+                levels.emplace(levelId, std::move(levelData));
+            }
+            else
+            {
+                missingLevelIds.insert(levelId);
+            }
+        }
+
+        bool isValid = false;
+        auto it = levels.find(levelId);
+        if (it == levels.end())
+        {
+            reason = "level file not found";
+        }
+        else if ((replayData.roomIndex < 0) || (replayData.roomIndex >= static_cast<int32_t>(it->second.rooms.size())))
+        {
+            reason = "the level has no such room";
+        }
+        else
+        {
+            isValid = VerifyReplay(replayData, simulator, it->second.rooms[replayData.roomIndex], reason);
+        }
+
+        if (isValid)
+        {
+            ++numValidReplays;
+        }
+        if (!isValid || !isQuiet)
+        {
+            std::cout << "Replay " << numReplays << ": level " << levelId << " room " << (replayData.roomIndex + 1)
+                << ", " << replayData.moves.size() << " moves: " << (isValid ? "valid" : ("invalid, " + reason)) << "\n";
+        }
+    }
+
+    double elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    std::cout << numReplays << " replays, " << numValidReplays << " valid completions, "
+        << (numReplays - numValidReplays) << " invalid ("
+        << ((elapsedSeconds > 0.0) ? (numReplays / elapsedSeconds) : 0.0) << " replays/s)" << std::endl;
+
+    return (hasReadFailed || (numValidReplays != numReplays)) ? 1 : 0;
+}